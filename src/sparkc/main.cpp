@@ -0,0 +1,271 @@
+#include "spark/grammar_arena.hpp"
+#include "spark/grammar_definition.hpp"
+#include "spark/detail/grammar_fingerprint.hpp"
+#include "spark/detail/mapped_file.hpp"
+#include "spark/detail/runtime_compiled_grammar.hpp"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+  using namespace warp::spark;
+  using namespace warp::spark::detail;
+
+  /**
+   * \brief Gives the qualified name of a state type
+   *
+   * \param type the state type
+   *
+   * \return the name of the enumerator, usable in the emitted header
+   */
+  std::string name_of( state_types type )
+  {
+    const std::string prefix = "warp::spark::detail::state_types::";
+
+    switch( type )
+    {
+      case state_types::initial : return prefix + "initial";
+      case state_types::final : return prefix + "final";
+      case state_types::intermediate : return prefix + "intermediate";
+      case state_types::initial_and_final :
+        return prefix + "initial_and_final";
+      case state_types::dead : return prefix + "dead";
+      case state_types::always_final : return prefix + "always_final";
+    }
+
+    throw std::logic_error { "Unknown state type" };
+  }
+
+  /**
+   * \brief Gives the qualified name of a group command type
+   *
+   * \param type the group command type
+   *
+   * \return the name of the enumerator, usable in the emitted header
+   */
+  std::string name_of( group_command_types type )
+  {
+    const std::string prefix = "warp::spark::detail::group_command_types::";
+
+    switch( type )
+    {
+      case group_command_types::finishing : return prefix + "finishing";
+      case group_command_types::capturing : return prefix + "capturing";
+      case group_command_types::resetting : return prefix + "resetting";
+    }
+
+    throw std::logic_error { "Unknown group command type" };
+  }
+
+  /**
+   * \brief Emits the initializer of an array, a value per line. Inner braces
+   * initialize the storage of the array, letting values be braced too
+   *
+   * \tparam VALUES a range type
+   * \tparam FORMAT a callable type, turning a value into its spelling
+   *
+   * \param output the emitted header
+   * \param values values of the array
+   * \param format spells a value
+   */
+  template< class VALUES, class FORMAT >
+    void emit_array
+    ( std::ostream &output, const VALUES &values, FORMAT &&format )
+    {
+      output << "      { {";
+
+      auto separator = "\n";
+
+      for( const auto &value : values )
+      {
+        output << separator << "        " << format( value );
+        separator = ",\n";
+      }
+
+      output << "\n      } }";
+    }
+
+  /**
+   * \brief Emits a compact table type and its value, as members of the
+   * emitted structure
+   *
+   * \param output the emitted header
+   * \param name the name of the table member
+   * \param type_name the name of the table type member
+   * \param table the table
+   */
+  void emit_table
+  (
+    std::ostream &output, const std::string &name,
+    const std::string &type_name, const runtime_compact_table &table
+  )
+  {
+    const auto number = []( std::size_t value )
+    { return std::to_string( value ); };
+
+    output << "  using " << type_name << " =\n"
+           << "    warp::spark::detail::compact_automaton_table\n"
+           << "      < " << table.state_count << ", " << table.class_count
+           << ", " << table.action_count << ", " << table.command_count
+           << " >;\n\n"
+           << "  static constexpr " << type_name << ' ' << name << "\n"
+           << "    {\n"
+           << "      " << table.initial_state << ",\n"
+           << "      " << table.group_count << ",\n";
+
+    emit_array( output, table.classes, number );
+    output << ",\n";
+    emit_array
+      ( output, table.final_states,
+        []( bool value ) { return value ? "true" : "false"; } );
+    output << ",\n";
+    emit_array( output, table.final_actions, number );
+    output << ",\n";
+    emit_array
+      ( output, table.types,
+        []( state_types type ) { return name_of( type ); } );
+    output << ",\n";
+    emit_array( output, table.targets, number );
+    output << ",\n";
+    emit_array( output, table.actions, number );
+    output << ",\n";
+    emit_array( output, table.action_offsets, number );
+    output << ",\n";
+    emit_array
+      ( output, table.commands,
+        []( const command_entry &command )
+        {
+          return
+            "{ " + name_of( command.type ) + ", " +
+            std::to_string( command.group ) + " }";
+        } );
+    output << "\n    };\n";
+  }
+
+  /**
+   * \brief Emits the header of a grammar
+   *
+   * \param output the emitted header
+   * \param name the name of the emitted structure
+   * \param definition the definition of the grammar
+   * \param state_budget the maximum number of deterministic states
+   */
+  void emit_header
+  (
+    std::ostream &output, const std::string &name,
+    const grammar_definition &definition, std::size_t state_budget
+  )
+  {
+    // intermediate automata of both tables share an arena
+    grammar_arena arena;
+
+    const auto compiled =
+      compile_runtime_grammar
+        ( runtime_thompson_grammar_from( definition, &arena ),
+          state_budget, &arena );
+    const auto recognition =
+      compile_runtime_grammar
+        ( simplified_runtime_thompson_grammar_from( definition, &arena ),
+          state_budget, &arena );
+
+    std::string guard = "_WARP_SPARKC_";
+
+    for( const auto letter : name )
+      guard += static_cast< char >( std::toupper( letter ) );
+
+    guard += "_HPP_";
+
+    output << "// generated by warp-sparkc, do not edit\n"
+           << "#ifndef " << guard << "\n"
+           << "#define " << guard << "\n\n"
+           << "#include \"spark/detail/compact_automaton_table.hpp\"\n\n"
+           << "#include <cstdint>\n\n"
+           << "struct " << name << "\n"
+           << "{\n"
+           << "  static constexpr std::uint64_t fingerprint = "
+           << group_nodes_fingerprint
+                ( runtime_group_dag_from( definition, &arena ) )
+           << "u;\n\n";
+
+    emit_table( output, "table", "table_type", compiled.table );
+    output << "\n";
+    emit_table
+      ( output, "recognition_table", "recognition_table_type",
+        recognition.table );
+
+    output << "};\n\n"
+           << "#endif // " << guard << "\n";
+  }
+
+  /**
+   * \brief Tells how to use the program
+   *
+   * \return the exit status of a wrong usage
+   */
+  int usage()
+  {
+    std::cerr << "usage : warp-sparkc [--state-budget N] NAME INPUT OUTPUT\n";
+
+    return 2;
+  }
+}
+
+/**
+ * \brief The offline grammar compiler entry point
+ */
+int main( int argc, char *argv[] )
+{
+  std::vector< std::string > arguments { argv + 1, argv + argc };
+  std::size_t state_budget = 128;
+
+  try
+  {
+    if( arguments.size() == 5 && arguments[ 0 ] == "--state-budget" )
+    {
+      state_budget = std::stoul( arguments[ 1 ] );
+      arguments.erase( arguments.begin(), arguments.begin() + 2 );
+    }
+
+    if( arguments.size() != 3 )
+      return usage();
+
+    const mapped_file input { arguments[ 1 ] };
+    const auto definition =
+      parse_grammar_definition
+        ( std::string_view { input.data(), input.size() } );
+
+    // the header is only written once fully emitted
+    std::ostringstream header;
+
+    emit_header( header, arguments[ 0 ], definition, state_budget );
+
+    std::ofstream output { arguments[ 2 ] };
+
+    if( ! ( output << header.str() ) )
+      throw std::runtime_error { "Cannot write " + arguments[ 2 ] };
+  }
+  catch( const std::exception &exception )
+  {
+    std::cerr << "warp-sparkc : " << exception.what() << '\n';
+
+    return 1;
+  }
+}
+
+// doxygen
+/**
+ * \file
+ * \brief The offline grammar compiler. Reads a regular grammar definition and
+ * emits a header holding the compact tables of the grammar, identical to the
+ * tables compiled at compile time from the same grammar.
+ */
@@ -1,8 +1,25 @@
 #include "test.hpp"
 
+// generated by warp-sparkc from minimal_interesting.grammar
+#include "minimal_interesting_tables.hpp"
+
 #include <iostream>
 #include <type_traits>
 #include <iterator>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <forward_list>
+#include <fstream>
+#include <functional>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 // auto_constant_tester
 void test::auto_constant_tester::auto_type_signed_constant()
@@ -640,8 +657,32 @@ void test::spark_tester::test_regular_grammar()
 
   test_regular_grammar_instantiation();
   test_regular_grammar_type_system();
+  test_automaton_minimization();
+  test_automaton_compression();
   test_compile_time_transcription();
   test_run_time_transcription();
+  test_stream_matching();
+  test_capture_spans();
+  test_lazy_matching();
+  test_bit_parallel_matching();
+  test_literal_prefilter();
+  test_union_matching();
+  test_keyword_matching();
+  test_parallel_matching();
+  test_file_matching();
+  test_stride_matching();
+  test_interleaved_matching();
+  test_match_modes();
+  test_tokenizer();
+  test_automaton_validation();
+  test_shared_group_nodes();
+  test_grammar_simplification();
+  test_epsilon_elimination();
+  test_grammar_artifacts();
+  test_grammar_compiler();
+  test_compilation_agreement();
+  test_runtime_grammar();
+  test_grammar_arena();
 }
 
 void test::spark_tester::test_regular_grammar_instantiation()
@@ -819,12 +860,340 @@ void test::spark_tester::test_regular_grammar_type_system()
   static_assert( group_traits::is_group, "Uh oh..." );
 }
 
+void test::spark_tester::test_automaton_minimization()
+{
+  std::cout << "      +--------------------------------------+" << std::endl
+            << "      | spark automaton minimization testing |" << std::endl
+            << "      +--------------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark::detail;
+
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using s_c =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'c' >
+    >;
+
+  // a deterministic automaton for (a|b)c, without any factorization
+  using states =
+    warp::type_sequence
+    <
+      automaton_state
+        < warp::integral_sequence< char, '0' >, state_types::initial >,
+      automaton_state
+        < warp::integral_sequence< char, '1' >, state_types::intermediate >,
+      automaton_state
+        < warp::integral_sequence< char, '2' >, state_types::intermediate >,
+      automaton_state
+        < warp::integral_sequence< char, '3' >, state_types::final >,
+      automaton_state
+        < warp::integral_sequence< char, '4' >, state_types::final >
+    >;
+
+  using t_functions =
+    warp::type_sequence
+    <
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'a' >,
+          warp::integral_sequence< char, '0' >, s_a,
+          warp::integral_sequence< char, '1' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'b' >,
+          warp::integral_sequence< char, '0' >, s_b,
+          warp::integral_sequence< char, '2' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'a', 'c' >,
+          warp::integral_sequence< char, '1' >, s_c,
+          warp::integral_sequence< char, '3' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'b', 'c' >,
+          warp::integral_sequence< char, '2' >, s_c,
+          warp::integral_sequence< char, '4' >
+        >
+    >;
+
+  // same group captured on both 'c' transitions
+  using same_groups =
+    warp::type_sequence
+    <
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', '|', 'b' >,
+          warp::integral_sequence< char, 'a' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', '|', 'b' >,
+          warp::integral_sequence< char, 'b' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'c' >,
+          warp::integral_sequence< char, 'a', 'c' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'c' >,
+          warp::integral_sequence< char, 'b', 'c' >
+        >
+    >;
+
+  // distinct groups captured on 'c' transitions
+  using distinct_groups =
+    warp::type_sequence
+    <
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', '|', 'b' >,
+          warp::integral_sequence< char, 'a' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', '|', 'b' >,
+          warp::integral_sequence< char, 'b' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', 'c' >,
+          warp::integral_sequence< char, 'a', 'c' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'b', 'c' >,
+          warp::integral_sequence< char, 'b', 'c' >
+        >
+    >;
+
+  using merged =
+    automaton_minimization< automaton< states, t_functions, same_groups > >;
+
+  using preserved =
+    automaton_minimization
+      < automaton< states, t_functions, distinct_groups > >;
+
+  static_assert( automaton_traits
+                   < automaton< states, t_functions, same_groups > >::
+                   is_automaton,
+                 "Uh oh..." );
+
+  static_assert( merged::statistics.state_count_before == 5, "Uh oh..." );
+  static_assert( merged::statistics.state_count_after == 3, "Uh oh..." );
+  static_assert( merged::table.initial_state == 0, "Uh oh..." );
+  static_assert( merged::table.final_states[ 2 ], "Uh oh..." );
+  static_assert( merged::table.target( 0, 'a' ) ==
+                   merged::table.target( 0, 'b' ),
+                 "Uh oh..." );
+
+  static_assert( preserved::statistics.state_count_before == 5, "Uh oh..." );
+  static_assert( preserved::statistics.state_count_after == 4, "Uh oh..." );
+  static_assert( preserved::table.group_count == 3, "Uh oh..." );
+
+  std::cout << "      (a|b)c, same groups : "
+            << merged::statistics.state_count_before << " -> "
+            << merged::statistics.state_count_after << " states, "
+            << merged::statistics.transition_count_before << " -> "
+            << merged::statistics.transition_count_after << " transitions"
+            << std::endl
+            << "      (a|b)c, distinct groups : "
+            << preserved::statistics.state_count_before << " -> "
+            << preserved::statistics.state_count_after << " states, "
+            << preserved::statistics.transition_count_before << " -> "
+            << preserved::statistics.transition_count_after << " transitions"
+            << std::endl << std::endl;
+}
+
+void test::spark_tester::test_automaton_compression()
+{
+  std::cout << "      +-------------------------------------+" << std::endl
+            << "      | spark automaton compression testing |" << std::endl
+            << "      +-------------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark::detail;
+
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_not_ab =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'n', 'o', 't', 'a', 'b' >,
+      warp::spark::symbol_types::exclusive,
+      warp::integral_sequence< char, 'a', 'b' >
+    >;
+
+  // a deterministic automaton for a*[^ab]
+  using a_star_not_ab =
+    automaton
+    <
+      warp::type_sequence
+        <
+          automaton_state
+            < warp::integral_sequence< char, '0' >, state_types::initial >,
+          automaton_state
+            < warp::integral_sequence< char, '1' >, state_types::final >
+        >,
+      warp::type_sequence
+        <
+          automaton_t_function
+            <
+              warp::integral_sequence< char, 'a' >,
+              warp::integral_sequence< char, '0' >, s_a,
+              warp::integral_sequence< char, '0' >
+            >,
+          automaton_t_function
+            <
+              warp::integral_sequence< char, 'n' >,
+              warp::integral_sequence< char, '0' >, s_not_ab,
+              warp::integral_sequence< char, '1' >
+            >
+        >,
+      warp::type_sequence
+        <
+          automaton_g_command
+            <
+              group_command_types::capturing,
+              warp::integral_sequence< char, 'a', '*' >,
+              warp::integral_sequence< char, 'a' >
+            >,
+          automaton_g_command
+            <
+              group_command_types::capturing,
+              warp::integral_sequence< char, 'n', 'o', 't', 'a', 'b' >,
+              warp::integral_sequence< char, 'n' >
+            >
+        >
+    >;
+
+  using compact = compact_automaton< a_star_not_ab >;
+  using table_type = typename compact::table_type;
+
+  // 'b' is recognized by none of the symbols but differs from other letters
+  static_assert( compact::classes.class_count == 3, "Uh oh..." );
+  static_assert( compact::table.classes[ 0 ] == 0, "Uh oh..." );
+  static_assert( compact::table.classes[ 'a' ] == 1, "Uh oh..." );
+  static_assert( compact::table.classes[ 'b' ] == 2, "Uh oh..." );
+  static_assert( compact::table.classes[ 'z' ] == 0, "Uh oh..." );
+  static_assert( table_type::state_count == 2, "Uh oh..." );
+  static_assert( std::is_same< typename table_type::state_type,
+                               unsigned char >::value,
+                 "Uh oh..." );
+
+  // the compact table behaves as the original one
+  static_assert( compact::table.target( 0, 'a' ) == 0, "Uh oh..." );
+  static_assert( compact::table.target( 0, 'z' ) == 1, "Uh oh..." );
+  static_assert( compact::table.target( 0, 'b' ) == table_type::no_state,
+                 "Uh oh..." );
+  static_assert( compact::table.target( 1, 'z' ) == table_type::no_state,
+                 "Uh oh..." );
+  static_assert( compact::table.action( 0, 'a' ) !=
+                   compact::table.action( 0, 'z' ),
+                 "Uh oh..." );
+  static_assert( compact::table.final_states[ 1 ], "Uh oh..." );
+
+  std::cout << "      a*[^ab] : " << compact::classes.class_count
+            << " letter classes, table footprint "
+            << sizeof( compact::minimization::table ) << " -> "
+            << sizeof( compact::table ) << " bytes"
+            << std::endl << std::endl;
+}
+
 void test::spark_tester::test_compile_time_transcription()
 {
   std::cout << "      +------------------------------------------+" << std::endl
             << "      | spark compile time transcription testing |" << std::endl
             << "      +------------------------------------------+" << std::endl
             << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+
+  using recognized =
+    warp::spark::compile_time_transcription
+    <
+      grammar,
+      warp::integral_sequence< char, 'x', 'a', 'a', 'c', 'd', 'b' >,
+      counting_transducer
+    >;
+
+  using rejected =
+    warp::spark::compile_time_transcription
+      < grammar, warp::integral_sequence< char, 'b', 'a' > >;
+
+  // the result is a type...
+  static_assert( std::is_same
+                 <
+                   warp::spark::compile_time_transcription_t
+                     < grammar, warp::integral_sequence< char, 'c', 'd' > >,
+                   std::true_type
+                 >::value,
+                 "Uh oh..." );
+  static_assert( std::is_same< typename rejected::type, std::false_type >::
+                   value,
+                 "Uh oh..." );
+  static_assert( ! warp::spark::compile_time_transcription_t
+                   < grammar, warp::integral_sequence< char > >::value,
+                 "Uh oh..." );
+
+  // ...and the transducer received the same commands as at run time
+  static_assert( recognized::is_recognized, "Uh oh..." );
+  static_assert( recognized::transducer.captures[ 0 ] == 6, "Uh oh..." );
+  static_assert( recognized::transducer.finishes[ 0 ] == 1, "Uh oh..." );
+  static_assert( recognized::transducer.resets[ 0 ] == 1, "Uh oh..." );
+  static_assert( recognized::transducer.captures[ 6 ] == 1, "Uh oh..." );
+
+  counting_transducer at_run_time;
+
+  warp::spark::transcribe
+    ( grammar {}, std::string_view { "xaacdb" }, at_run_time );
+
+  for( std::size_t g = 0; g < 10; ++g )
+    if( recognized::transducer.captures[ g ] != at_run_time.captures[ g ] ||
+        recognized::transducer.finishes[ g ] != at_run_time.finishes[ g ] ||
+        recognized::transducer.resets[ g ] != at_run_time.resets[ g ] )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << std::boolalpha
+            << "      .*a*(b|cd?)+ recognizes xaacdb at compile time ? "
+            << recognized::is_recognized << std::endl << std::endl;
 }
 
 void test::spark_tester::test_run_time_transcription()
@@ -833,6 +1202,2769 @@ void test::spark_tester::test_run_time_transcription()
             << "      | spark run time transcription testing |" << std::endl
             << "      +--------------------------------------+" << std::endl
             << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using compiled = warp::spark::detail::compiled_grammar< grammar >;
+
+  // group indexes follow the pre-order of the group tree
+  static_assert( warp::spark::detail::group_index_of
+                   < grammar, warp::integral_sequence< char, '.', '*' > >::
+                   value == 1,
+                 "Uh oh..." );
+  static_assert( warp::spark::detail::group_index_of
+                   < grammar, warp::integral_sequence< char, 'd', '?' > >::
+                   value == 9,
+                 "Uh oh..." );
+  static_assert( compiled::table.group_count == 10, "Uh oh..." );
+  static_assert( compiled::statistics.state_count_after <=
+                   compiled::statistics.state_count_before,
+                 "Uh oh..." );
+
+  const std::string input = "xaacdb";
+  const std::forward_list< char > list( input.begin(), input.end() );
+
+  counting_transducer from_string;
+  counting_transducer from_list;
+  counting_transducer from_view;
+
+  const auto string_result =
+    warp::spark::transcribe
+      ( grammar {}, input.begin(), input.end(), from_string );
+  const auto list_result =
+    warp::spark::transcribe
+      ( grammar {}, list.begin(), list.end(), from_list );
+  const auto view_result =
+    warp::spark::transcribe
+      ( grammar {}, std::string_view { "xaacdb" }, from_view );
+
+  std::cout << std::boolalpha
+            << "      .*a*(b|cd?)+ recognizes xaacdb ? " << string_result
+            << std::endl
+            << "      captures of .*a*(b|cd?)+ : " << from_string.captures[ 0 ]
+            << ", finishes : " << from_string.finishes[ 0 ] << std::endl
+            << "      captures of b : " << from_string.captures[ 6 ]
+            << ", of cd? : " << from_string.captures[ 7 ]
+            << ", of .* : " << from_string.captures[ 1 ] << std::endl;
+
+  if( ! string_result || ! list_result || ! view_result )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t g = 0; g < 10; ++g )
+    if( from_string.captures[ g ] != from_list.captures[ g ] ||
+        from_string.captures[ g ] != from_view.captures[ g ] ||
+        from_string.finishes[ g ] != from_list.finishes[ g ] ||
+        from_string.resets[ g ] != from_view.resets[ g ] )
+      throw std::runtime_error( "Uh oh..." );
+
+  if( from_string.captures[ 0 ] != 6 || from_string.finishes[ 0 ] != 1 ||
+      from_string.resets[ 0 ] != 1 || from_string.captures[ 6 ] != 1 )
+    throw std::runtime_error( "Uh oh..." );
+
+  counting_transducer rejected;
+
+  if( warp::spark::transcribe( grammar {}, std::string_view { "ba" },
+                               rejected ) ||
+      warp::spark::transcribe( grammar {}, std::string_view { "x" },
+                               rejected ) ||
+      ! warp::spark::transcribe( grammar {}, std::string_view { "c" },
+                                 rejected ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      " << compiled::statistics.state_count_before
+            << " -> " << compiled::statistics.state_count_after
+            << " states, table footprint " << sizeof( compiled::table )
+            << " bytes" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_stream_matching()
+{
+  std::cout << "      +-------------------------------+" << std::endl
+            << "      | spark stream matching testing |" << std::endl
+            << "      +-------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+
+  static_assert( std::is_pod< warp::spark::stream_state >::value,
+                 "Uh oh..." );
+
+  // xaacdb, split at arbitrary boundaries
+  warp::spark::stream_matcher< grammar > matcher;
+  counting_transducer chunked;
+
+  matcher.feed( "xa", chunked );
+  matcher.feed( "", chunked );
+  matcher.feed( "ac", chunked );
+
+  // the state is enough to resume the stream elsewhere
+  const warp::spark::stream_state saved = matcher.state();
+  warp::spark::stream_matcher< grammar > resumed { saved };
+
+  const auto fed = resumed.feed( "d", chunked ) && resumed.feed( "b", chunked );
+  const auto finished = resumed.finish( chunked );
+
+  counting_transducer whole;
+
+  warp::spark::transcribe( grammar {}, std::string_view { "xaacdb" }, whole );
+
+  if( ! fed || ! finished || saved.offset != 4 ||
+      resumed.state().offset != 6 )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t g = 0; g < 10; ++g )
+    if( chunked.captures[ g ] != whole.captures[ g ] ||
+        chunked.finishes[ g ] != whole.finishes[ g ] ||
+        chunked.resets[ g ] != whole.resets[ g ] )
+      throw std::runtime_error( "Uh oh..." );
+
+  // .* keeps any prefix alive, only the end of the stream rejects ba
+  matcher.reset();
+
+  if( ! matcher.feed( "b" ) || ! matcher.feed( "a" ) || matcher.finish() ||
+      matcher.state().is_rejected )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      xa|ac|d|b recognized as a stream of "
+            << resumed.state().offset << " letters, state of "
+            << sizeof( warp::spark::stream_state ) << " bytes"
+            << std::endl << std::endl;
+}
+
+void test::spark_tester::test_capture_spans()
+{
+  std::cout << "      +-----------------------------+" << std::endl
+            << "      | spark capture spans testing |" << std::endl
+            << "      +-----------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using spans_type = warp::spark::capture_spans< grammar >;
+
+  // one span per named group
+  static_assert( spans_type::group_count == 10, "Uh oh..." );
+
+  constexpr auto spans = []
+  {
+    spans_type result;
+
+    warp::spark::capture( grammar {}, "xaacdb", result );
+
+    return result;
+  }();
+
+  // .* is greedy, the last letter being the only (b|cd?)+ iteration
+  static_assert( spans[ 0 ].begin == 0 && spans[ 0 ].end == 6, "Uh oh..." );
+  static_assert( spans[ 1 ].begin == 0 && spans[ 1 ].end == 5, "Uh oh..." );
+  static_assert( spans[ 2 ].begin == 5 && spans[ 2 ].end == 6, "Uh oh..." );
+  static_assert( spans[ 4 ].begin == 5 && spans[ 4 ].end == 6, "Uh oh..." );
+  static_assert( spans[ 6 ].begin == 5 && spans[ 6 ].end == 6, "Uh oh..." );
+  static_assert( spans[ 9 ].group == 9, "Uh oh..." );
+
+  // a* matches an empty span
+  static_assert( spans.is_matched( 3 ) && spans[ 3 ].begin == spans[ 3 ].end,
+                 "Uh oh..." );
+
+  // groups of parses abandoned on the way are not matched
+  static_assert( ! spans.is_matched( 7 ) && ! spans.is_matched( 8 ) &&
+                   ! spans.is_matched( 9 ),
+                 "Uh oh..." );
+
+  // no match, no span
+  static_assert( []
+                 {
+                   spans_type result;
+
+                   return ! warp::spark::capture( grammar {}, "xaad", result )
+                     && ! result.is_matched( 0 );
+                 }(),
+                 "Uh oh..." );
+
+  // the stream matcher produces the same spans across chunks
+  warp::spark::stream_matcher< grammar > matcher;
+  spans_type streamed;
+
+  matcher.feed( "xaa", streamed );
+
+  // pending captures travel with the spans, the state holding none
+  warp::spark::stream_matcher< grammar > resumed { matcher.state() };
+  spans_type saved = streamed;
+
+  matcher.feed( "cdb", streamed );
+  resumed.feed( "cdb", saved );
+
+  if( ! matcher.finish( streamed ) || ! resumed.finish( saved ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t g = 0; g < spans_type::group_count; ++g )
+    if( saved[ g ].begin != streamed[ g ].begin ||
+        saved[ g ].end != streamed[ g ].end ||
+        saved.is_matched( g ) != streamed.is_matched( g ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t g = 0; g < spans_type::group_count; ++g )
+    if( streamed[ g ].begin != spans[ g ].begin ||
+        streamed[ g ].end != spans[ g ].end ||
+        streamed.is_matched( g ) != spans.is_matched( g ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  // alternatives competing for the same letters : (a|ab)(c|bcd)d*
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      typename minimal_interesting_group::s_a
+    >;
+
+  using g_d =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'd' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      typename minimal_interesting_group::s_d
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, typename minimal_interesting_group::g_b
+    >;
+
+  using g_a_or_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', '|', 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_a, g_ab
+    >;
+
+  using g_bc =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b', 'c' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      typename minimal_interesting_group::g_b,
+      typename minimal_interesting_group::g_c
+    >;
+
+  using g_bcd =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b', 'c', 'd' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_bc, g_d
+    >;
+
+  using g_c_or_bcd =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', '|', 'b', 'c', 'd' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      typename minimal_interesting_group::g_c, g_bcd
+    >;
+
+  using g_d_star =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'd', '*' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_many,
+      typename minimal_interesting_group::s_d
+    >;
+
+  using g_heads =
+    warp::spark::group
+    <
+      warp::integral_sequence
+        <
+          char,
+          '(', 'a', '|', 'a', 'b', ')', '(', 'c', '|', 'b', 'c', 'd', ')'
+        >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a_or_ab, g_c_or_bcd
+    >;
+
+  using competing =
+    warp::spark::group
+    <
+      warp::integral_sequence
+        <
+          char,
+          '(', 'a', '|', 'a', 'b', ')', '(', 'c', '|', 'b', 'c', 'd', ')',
+          'd', '*'
+        >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_heads, g_d_star
+    >;
+
+  using competing_spans = warp::spark::capture_spans< competing >;
+
+  constexpr auto parsed = []
+  {
+    competing_spans result;
+
+    warp::spark::capture( competing {}, "abcd", result );
+
+    return result;
+  }();
+
+  constexpr auto a_or_ab =
+    warp::spark::detail::group_index_of
+      < competing, warp::integral_sequence< char, 'a', '|', 'a', 'b' > >::
+      value;
+  constexpr auto ab =
+    warp::spark::detail::group_index_of
+      < competing, warp::integral_sequence< char, 'a', 'b' > >::value;
+  constexpr auto c_or_bcd =
+    warp::spark::detail::group_index_of
+      < competing, warp::integral_sequence< char, 'c', '|', 'b', 'c', 'd' > >::
+      value;
+  constexpr auto bcd =
+    warp::spark::detail::group_index_of
+      < competing, warp::integral_sequence< char, 'b', 'c', 'd' > >::value;
+  constexpr auto d_star =
+    warp::spark::detail::group_index_of
+      < competing, warp::integral_sequence< char, 'd', '*' > >::value;
+
+  // the first alternative wins as long as the rest of the input is parsed
+  static_assert( parsed.is_matched( a_or_ab ) &&
+                   parsed[ a_or_ab ].begin == 0 && parsed[ a_or_ab ].end == 1,
+                 "Uh oh..." );
+  static_assert( ! parsed.is_matched( ab ), "Uh oh..." );
+  static_assert( parsed.is_matched( c_or_bcd ) &&
+                   parsed[ c_or_bcd ].begin == 1 &&
+                   parsed[ c_or_bcd ].end == 4,
+                 "Uh oh..." );
+  static_assert( parsed.is_matched( bcd ) &&
+                   parsed[ bcd ].begin == 1 && parsed[ bcd ].end == 4,
+                 "Uh oh..." );
+
+  // the closure is left empty, every d being taken already
+  static_assert( parsed.is_matched( d_star ) &&
+                   parsed[ d_star ].begin == 4 && parsed[ d_star ].end == 4,
+                 "Uh oh..." );
+
+  const std::string_view input = "xaacdb";
+
+  for( const auto &span : spans )
+    if( spans.is_matched( span.group ) )
+      std::cout << "      group " << span.group << " : '"
+                << input.substr( span.begin, span.end - span.begin ) << "'"
+                << std::endl;
+    else
+      std::cout << "      group " << span.group << " : unmatched"
+                << std::endl;
+
+  std::cout << std::endl;
+}
+
+void test::spark_tester::test_lazy_matching()
+{
+  std::cout << "      +-----------------------------+" << std::endl
+            << "      | spark lazy matching testing |" << std::endl
+            << "      +-----------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using stepped = warp::spark::detail::epsilon_free_grammar< grammar >;
+
+  // states are built on demand from an automaton without epsilon edges
+  static_assert( stepped::nfa.state_count <=
+                   warp::spark::detail::thompson_grammar< grammar >::nfa.
+                     state_count,
+                 "Uh oh..." );
+  static_assert( stepped::nfa.recognize( "xaacdb" ) &&
+                   ! stepped::nfa.recognize( "xaad" ),
+                 "Uh oh..." );
+
+  // a roomy cache and a cache flushed at almost each transition
+  warp::spark::lazy_matcher< grammar > matcher;
+  warp::spark::lazy_matcher< grammar, 2 > tiny_matcher;
+
+  const std::string_view inputs[] =
+    { "xaacdb", "ba", "x", "c", "xb", "acd", "bbbb", "cdd", "xaacdb" };
+
+  for( const auto input : inputs )
+  {
+    counting_transducer expected;
+    counting_transducer lazy;
+    counting_transducer tiny;
+
+    const auto result = warp::spark::transcribe( grammar {}, input, expected );
+
+    if( matcher.transcribe( input, lazy ) != result ||
+        tiny_matcher.transcribe( input, tiny ) != result ||
+        matcher.recognize( input ) != result )
+      throw std::runtime_error( "Uh oh..." );
+
+    for( std::size_t g = 0; g < 10; ++g )
+      if( lazy.captures[ g ] != expected.captures[ g ] ||
+          lazy.finishes[ g ] != expected.finishes[ g ] ||
+          lazy.resets[ g ] != expected.resets[ g ] ||
+          tiny.captures[ g ] != expected.captures[ g ] ||
+          tiny.finishes[ g ] != expected.finishes[ g ] ||
+          tiny.resets[ g ] != expected.resets[ g ] )
+        throw std::runtime_error( "Uh oh..." );
+  }
+
+  if( matcher.statistics().flushes != 0 ||
+      tiny_matcher.statistics().flushes == 0 ||
+      tiny_matcher.cached_state_count() > 2 ||
+      matcher.statistics().hit_ratio() <= 0.0 )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      " << matcher.cached_state_count()
+            << " cached states, hit ratio "
+            << matcher.statistics().hit_ratio() << std::endl
+            << "      2 states cache : " << tiny_matcher.statistics().flushes
+            << " flushes, hit ratio "
+            << tiny_matcher.statistics().hit_ratio() << std::endl
+            << std::endl;
+}
+
+void test::spark_tester::test_bit_parallel_matching()
+{
+  std::cout << "      +-------------------------------------+" << std::endl
+            << "      | spark bit parallel matching testing |" << std::endl
+            << "      +-------------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using matcher = warp::spark::bit_parallel_matcher< grammar >;
+
+  // a position per symbol : any, a, b, c and d
+  static_assert( matcher::position_count == 5, "Uh oh..." );
+  static_assert( ! matcher::automaton.nullable, "Uh oh..." );
+
+  // usable at compile time...
+  static_assert( matcher::recognize( "xaacdb" ), "Uh oh..." );
+  static_assert( matcher::recognize( "c" ), "Uh oh..." );
+  static_assert( ! matcher::recognize( "ba" ), "Uh oh..." );
+  static_assert( ! matcher::recognize( "" ), "Uh oh..." );
+
+  // ...and at run time, agreeing with the deterministic engine
+  const std::string_view inputs[] =
+    { "xaacdb", "ba", "x", "c", "xb", "acd", "bbbb", "cdd", "cdcdbcb" };
+
+  counting_transducer ignored;
+
+  for( const auto input : inputs )
+    if( matcher::recognize( input ) !=
+          warp::spark::transcribe( grammar {}, input, ignored ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  const std::string text = "xaacdb";
+  const std::forward_list< char > list( text.begin(), text.end() );
+
+  if( ! matcher::recognize( list.begin(), list.end() ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ : " << matcher::position_count
+            << " positions, tables of " << sizeof( matcher::automaton )
+            << " bytes" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_literal_prefilter()
+{
+  std::cout << "      +---------------------------------+" << std::endl
+            << "      | spark literal prefilter testing |" << std::endl
+            << "      +---------------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a abc+ template expression
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using s_c =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'c' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, g_b
+    >;
+
+  using g_c_plus =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', '+' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_many,
+      s_c
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b', 'c', '+' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_ab, g_c_plus
+    >;
+
+  // literals required by grammars
+  constexpr auto &ab_literals =
+    warp::spark::detail::required_literals_of< g_ab >::value;
+  constexpr auto &literals =
+    warp::spark::detail::required_literals_of< grammar >::value;
+  constexpr auto &interesting_literals =
+    warp::spark::detail::required_literals_of
+      < typename minimal_interesting_group::type >::value;
+
+  static_assert( ab_literals.is_exact && ab_literals.prefix.size == 2,
+                 "Uh oh..." );
+  static_assert( ! literals.is_exact && literals.prefix.size == 3 &&
+                   literals.prefix.letters[ 2 ] == 'c',
+                 "Uh oh..." );
+  static_assert( literals.factor == literals.prefix, "Uh oh..." );
+  static_assert( literals.suffix.size == 1 &&
+                   literals.suffix.letters[ 0 ] == 'c',
+                 "Uh oh..." );
+  static_assert( interesting_literals.prefix.size == 0 &&
+                   interesting_literals.factor.size == 0,
+                 "Uh oh..." );
+
+  // the scanner, with a buffer long enough to use vectors
+  const std::string haystack = std::string( 1000, 'a' ) + "needle" + "aa";
+  const auto found =
+    warp::spark::detail::find_literal
+      ( haystack.data(), haystack.data() + haystack.size(), "needle", 6 );
+
+  if( found - haystack.data() != 1000 ||
+      warp::spark::detail::find_literal
+        ( haystack.data(), haystack.data() + 1005, "needle", 6 ) !=
+        haystack.data() + 1005 )
+    throw std::runtime_error( "Uh oh..." );
+
+  // searching
+  const auto buffer = std::string( 500, 'x' ) + "acabxabccab";
+  const auto match = warp::spark::search( grammar {}, buffer );
+  const auto no_match =
+    warp::spark::search( grammar {}, std::string( 500, 'a' ) );
+  const auto interesting_match =
+    warp::spark::search
+      ( typename minimal_interesting_group::type {}, "__cd" );
+
+  if( ! match.is_found || match.begin != 505 || match.end != 508 ||
+      no_match.is_found ||
+      ! interesting_match.is_found || interesting_match.begin != 0 ||
+      interesting_match.end != 3 )
+    throw std::runtime_error( "Uh oh..." );
+
+  // without any required prefix, each a may begin a match, yet the buffer is
+  // read once forward, then backward from the end of the first match only
+  using unprefixed =
+    typename minimal_interesting_group::g_a_star__b_or_cd_maybe_plus;
+
+  const auto long_buffer = std::string( 100000, 'a' ) + "xaab";
+  const auto long_match = warp::spark::search( unprefixed {}, long_buffer );
+  const auto unprefixed_no_match =
+    warp::spark::search( unprefixed {}, std::string( 100000, 'a' ) );
+
+  if( ! long_match.is_found || long_match.begin != 100001 ||
+      long_match.end != 100004 || unprefixed_no_match.is_found )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      abc+ : required prefix '"
+            << std::string_view
+                 ( literals.prefix.letters.data(), literals.prefix.size )
+            << "', found at " << match.begin << std::endl << std::endl;
+}
+
+void test::spark_tester::test_union_matching()
+{
+  std::cout << "      +------------------------------+" << std::endl
+            << "      | spark union matching testing |" << std::endl
+            << "      +------------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to unite ab, ba, c+ and ca grammars
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using s_c =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'c' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_c =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_c
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, g_b
+    >;
+
+  using g_ba =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b', 'a' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_b, g_a
+    >;
+
+  using g_c_plus =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', '+' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_many,
+      s_c
+    >;
+
+  using g_ca =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', 'a' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_c, g_a
+    >;
+
+  using matcher =
+    warp::spark::union_matcher< g_ab, g_ba, g_c_plus, g_ca >;
+
+  // compile time matching
+  constexpr auto compile_time_match = matcher::match( "xxabac" );
+
+  static_assert( matcher::grammar_count == 4, "Uh oh..." );
+  static_assert( compile_time_match.matched.size() == 3, "Uh oh..." );
+  static_assert( compile_time_match.ends[ 0 ] == 4 &&
+                   compile_time_match.ends[ 1 ] == 5 &&
+                   compile_time_match.ends[ 2 ] == 6,
+                 "Uh oh..." );
+  static_assert( ! compile_time_match.matched.contains( 3 ), "Uh oh..." );
+
+  // run time matching, with the minimal interesting grammar united too
+  using interesting_matcher =
+    warp::spark::union_matcher
+      < g_ca, typename minimal_interesting_group::type, g_ab >;
+
+  const auto input = std::string( 1000, 'x' ) + "cd" + "ca";
+  const auto match = interesting_matcher::match( input );
+  const auto no_match = interesting_matcher::match( "xxxa" );
+
+  if( match.matched.size() != 2 || ! match.matched.contains( 0 ) ||
+      ! match.matched.contains( 1 ) || match.matched.contains( 2 ) ||
+      match.ends[ 1 ] != 1001 || match.ends[ 0 ] != 1004 ||
+      ! no_match.matched.empty() )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      4 grammars united in " << matcher::state_count
+            << " states, " << interesting_matcher::state_count
+            << " states with .*a*(b|cd?)+" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_keyword_matching()
+{
+  std::cout << "      +--------------------------------+" << std::endl
+            << "      | spark keyword matching testing |" << std::endl
+            << "      +--------------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a he|she|his|hers template expression
+  using s_e =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'e' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'e' >
+    >;
+
+  using s_h =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'h' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'h' >
+    >;
+
+  using s_i =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'i' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'i' >
+    >;
+
+  using s_r =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'r' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'r' >
+    >;
+
+  using s_s =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 's' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 's' >
+    >;
+
+  using g_e =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'e' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_e
+    >;
+
+  using g_h =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_h
+    >;
+
+  using g_i =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'i' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_i
+    >;
+
+  using g_r =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'r' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_r
+    >;
+
+  using g_s =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 's' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_s
+    >;
+
+  using g_he =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h', 'e' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_h, g_e
+    >;
+
+  using g_she =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 's', 'h', 'e' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_s, g_he
+    >;
+
+  using g_is =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'i', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_i, g_s
+    >;
+
+  using g_his =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h', 'i', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_h, g_is
+    >;
+
+  using g_rs =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'r', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_r, g_s
+    >;
+
+  using g_hers =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h', 'e', 'r', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_he, g_rs
+    >;
+
+  using g_he_she =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h', 'e', '|', 's', 'h', 'e' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_he, g_she
+    >;
+
+  using g_his_hers =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'h', 'i', 's', '|', 'h', 'e', 'r', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_his, g_hers
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence
+        <
+          char,
+          'h', 'e', '|', 's', 'h', 'e', '|', 'h', 'i', 's', '|',
+          'h', 'e', 'r', 's'
+        >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_he_she, g_his_hers
+    >;
+
+  using matcher = warp::spark::keyword_matcher< grammar >;
+
+  // detection
+  static_assert( warp::spark::detail::keyword_grammar< grammar >::
+                   is_keyword_grammar,
+                 "Uh oh..." );
+  static_assert( ! warp::spark::detail::keyword_grammar
+                     < typename minimal_interesting_group::type >::
+                       is_keyword_grammar,
+                 "Uh oh..." );
+  static_assert( matcher::keyword_count == 4, "Uh oh..." );
+
+  // compile time matching
+  static_assert( matcher::contains( "this" ), "Uh oh..." );
+  static_assert( ! matcher::contains( "shirt" ), "Uh oh..." );
+
+  // all occurrences, overlapping ones included
+  std::string occurrences;
+
+  matcher::for_each_match
+    ( "ushers",
+      [ & ]( std::size_t keyword, std::size_t begin, std::size_t end )
+      {
+        occurrences += std::to_string( keyword ) + ":" +
+                       std::to_string( begin ) + "-" +
+                       std::to_string( end ) + " ";
+      } );
+
+  // searching is dispatched to the keyword automaton
+  const auto match = warp::spark::search( grammar {}, "ushers" );
+  const auto late_match =
+    warp::spark::search( grammar {}, std::string( 700, 'x' ) + "hishe" );
+
+  if( occurrences != "1:1-4 0:2-4 3:2-6 " ||
+      ! match.is_found || match.begin != 1 || match.end != 4 ||
+      ! late_match.is_found || late_match.begin != 700 ||
+      late_match.end != 703 )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      he|she|his|hers : " << matcher::cell_count
+            << " double array cells, matches in ushers : " << occurrences
+            << std::endl << std::endl;
+}
+
+void test::spark_tester::test_parallel_matching()
+{
+  std::cout << "      +---------------------------------+" << std::endl
+            << "      | spark parallel matching testing |" << std::endl
+            << "      +---------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+
+  // a pool running tasks in the calling thread, in reverse order
+  struct sequential_pool
+  {
+    void run( std::size_t task_count, std::function< void( std::size_t ) > f )
+    {
+      for( auto task = task_count; task != 0; --task )
+        f( task - 1 );
+    }
+  };
+
+  const auto prefix = std::string( 10000, 'x' ) + std::string( 5000, 'a' );
+  const std::string inputs[] =
+  {
+    prefix + "cdb", prefix + "ba", prefix + "cdd", "xaacdb", "x", ""
+  };
+
+  warp::spark::thread_pool pool { 4 };
+  sequential_pool sequential;
+
+  for( const auto &input : inputs )
+  {
+    const auto expected =
+      warp::spark::bit_parallel_matcher< grammar >::recognize( input );
+
+    for( std::size_t chunk_count : { 1, 2, 3, 7, 64 } )
+      if( warp::spark::parallel_recognize
+            ( grammar {}, input, pool, chunk_count ) != expected ||
+          warp::spark::parallel_recognize
+            ( grammar {}, input, sequential, chunk_count ) != expected )
+        throw std::runtime_error( "Uh oh..." );
+
+    if( warp::spark::parallel_recognize( grammar {}, input ) != expected )
+      throw std::runtime_error( "Uh oh..." );
+  }
+
+  // a throwing task stops pending ones, its exception reaching the caller
+  // once every thread is joined
+  std::atomic< std::size_t > run_count { 0 };
+  bool is_rethrown = false;
+
+  try
+  {
+    pool.run
+      ( 1000,
+        [ & ]( std::size_t task )
+        {
+          ++run_count;
+
+          if( task == 10 )
+            throw std::invalid_argument( "task 10" );
+        } );
+  }
+  catch( const std::invalid_argument & )
+  {
+    is_rethrown = true;
+  }
+
+  if( ! is_rethrown || run_count == 1000 )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ : recognized on " << pool.thread_count()
+            << " threads" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_file_matching()
+{
+  std::cout << "      +-----------------------------+" << std::endl
+            << "      | spark file matching testing |" << std::endl
+            << "      +-----------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+
+  const auto directory = std::filesystem::temp_directory_path();
+  const auto path = directory / "warp-spark-file-matching.txt";
+  const auto empty_path = directory / "warp-spark-file-matching-empty.txt";
+  const auto content = std::string( 100000, 'x' ) + "aacdb";
+
+  std::ofstream { path, std::ios::binary } << content;
+  std::ofstream { empty_path, std::ios::binary };
+
+  // captures are offsets into the mapping, as with an in-memory buffer
+  warp::spark::capture_spans< grammar > file_spans;
+  warp::spark::capture_spans< grammar > buffer_spans;
+
+  const auto is_recognized =
+    warp::spark::match_file( path, grammar {}, file_spans );
+
+  warp::spark::capture( grammar {}, content, buffer_spans );
+
+  bool is_missing_reported = false;
+
+  try
+  {
+    warp::spark::match_file( directory / "warp-spark-missing", grammar {} );
+  }
+  catch( const std::system_error & )
+  {
+    is_missing_reported = true;
+  }
+
+  const auto is_empty_recognized =
+    warp::spark::match_file( empty_path, grammar {} );
+
+  std::filesystem::remove( path );
+  std::filesystem::remove( empty_path );
+
+  if( ! is_recognized || is_empty_recognized || ! is_missing_reported )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t g = 0; g < file_spans.group_count; ++g )
+    if( file_spans[ g ].begin != buffer_spans[ g ].begin ||
+        file_spans[ g ].end != buffer_spans[ g ].end )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ : (b|cd?)+ spans "
+            << file_spans[ 4 ].begin << "-" << file_spans[ 4 ].end
+            << " in a mapped file" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_stride_matching()
+{
+  std::cout << "      +-------------------------------+" << std::endl
+            << "      | spark stride matching testing |" << std::endl
+            << "      +-------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using matcher = warp::spark::stride_matcher< grammar >;
+  using tiny_matcher = warp::spark::stride_matcher< grammar, 16 >;
+
+  // the budget gates the stride table
+  static_assert( matcher::is_multi_stride, "Uh oh..." );
+  static_assert( ! tiny_matcher::is_multi_stride, "Uh oh..." );
+
+  // compile time recognition, with odd and even lengths
+  static_assert( matcher::recognize( "xaacdb" ), "Uh oh..." );
+  static_assert( matcher::recognize( "acd" ), "Uh oh..." );
+  static_assert( ! matcher::recognize( "cdd" ), "Uh oh..." );
+  static_assert( ! matcher::recognize( "ba" ), "Uh oh..." );
+  static_assert( tiny_matcher::recognize( "xaacdb" ), "Uh oh..." );
+
+  const std::string inputs[] =
+  {
+    "", "c", "b", "x", "xb", "bbbb", "cdcdb", "cdd", "ba",
+    std::string( 1001, 'x' ) + "acd", std::string( 1000, 'x' ) + "dcd"
+  };
+
+  for( const auto &input : inputs )
+    if( matcher::recognize( input ) != tiny_matcher::recognize( input ) ||
+        matcher::recognize( input ) !=
+          warp::spark::bit_parallel_matcher< grammar >::recognize( input ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ : stride table of " << matcher::table_size
+            << " bytes" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_interleaved_matching()
+{
+  std::cout << "      +------------------------------------+" << std::endl
+            << "      | spark interleaved matching testing |" << std::endl
+            << "      +------------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using matcher = warp::spark::interleaved_matcher< grammar, 4 >;
+
+  // compile time recognition of a batch
+  constexpr auto compile_time_results = []
+  {
+    const std::string_view batch[] = { "xaacdb", "ba", "", "c", "cdd" };
+    std::array< bool, 5 > results {};
+
+    matcher::recognize( batch, 5, results.data() );
+
+    return results;
+  }();
+
+  static_assert( compile_time_results[ 0 ] && ! compile_time_results[ 1 ] &&
+                   ! compile_time_results[ 2 ] && compile_time_results[ 3 ] &&
+                   ! compile_time_results[ 4 ],
+                 "Uh oh..." );
+
+  // more inputs than streams, of various lengths
+  std::vector< std::string > messages;
+
+  for( std::size_t m = 0; m < 100; ++m )
+    messages.push_back
+      ( std::string( m * 7 % 23, 'x' ) + ( m % 3 == 0 ? "ba" : "acd" ) +
+        std::string( m % 5, 'b' ) );
+
+  const std::vector< std::string_view > batch
+    ( messages.begin(), messages.end() );
+  bool flags[ 100 ] {};
+
+  matcher::recognize( batch.data(), batch.size(), flags );
+
+  for( std::size_t m = 0; m < batch.size(); ++m )
+    if( flags[ m ] !=
+          warp::spark::bit_parallel_matcher< grammar >::
+            recognize( batch[ m ] ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ : 100 messages recognized in "
+            << matcher::stream_count << " streams" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_match_modes()
+{
+  std::cout << "      +---------------------------+" << std::endl
+            << "      | spark match modes testing |" << std::endl
+            << "      +---------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a ab.* template expression
+  using s_any =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a', 'n', 'y' >,
+      warp::spark::symbol_types::any
+    >;
+
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, g_b
+    >;
+
+  using g_any_star =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, '.', '*' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_many,
+      s_any
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b', '.', '*' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_ab, g_any_star
+    >;
+
+  using interesting = typename minimal_interesting_group::type;
+  using warp::spark::match;
+  using warp::spark::match_modes;
+  using warp::spark::detail::state_types;
+
+  // the state reached after ab accepts whatever follows
+  constexpr auto &table =
+    warp::spark::detail::compiled_grammar< grammar >::table;
+  constexpr auto after_ab =
+    table.target( table.target( table.initial_state, 'a' ), 'b' );
+
+  static_assert( table.types[ table.initial_state ] == state_types::initial,
+                 "Uh oh..." );
+  static_assert( table.types[ after_ab ] == state_types::always_final,
+                 "Uh oh..." );
+
+  // compile time matches
+  constexpr auto full = match< match_modes::full >( grammar {}, "abxyz" );
+  constexpr auto shortest =
+    match< match_modes::anchored_shortest >( grammar {}, "abxyz" );
+  constexpr auto longest =
+    match< match_modes::anchored_longest >( interesting {}, "xbcdx" );
+  constexpr auto rejected = match< match_modes::full >( grammar {}, "ba" );
+
+  static_assert( full.is_found && full.begin == 0 && full.end == 5,
+                 "Uh oh..." );
+  static_assert( shortest.is_found && shortest.end == 2, "Uh oh..." );
+  static_assert( longest.is_found && longest.end == 4, "Uh oh..." );
+  static_assert( ! rejected.is_found, "Uh oh..." );
+
+  // run time matches
+  const std::string tail( 4096, 'z' );
+  const auto accepted =
+    match< match_modes::full >( grammar {}, "ab" + tail );
+  const auto found =
+    match< match_modes::unanchored >( grammar {}, "xxab" + tail );
+  const auto interesting_shortest =
+    match< match_modes::anchored_shortest >( interesting {}, "xbcdb" );
+  const auto interesting_longest =
+    match< match_modes::anchored_longest >( interesting {}, "xbcdb" );
+
+  if( ! accepted.is_found || accepted.end != tail.size() + 2 ||
+      ! found.is_found || found.begin != 2 || found.end != 4 ||
+      interesting_shortest.end != 2 || interesting_longest.end != 5 ||
+      match< match_modes::full >( interesting {}, "cdd" ).is_found ||
+      ! match< match_modes::full >( interesting {}, "xaacdb" ).is_found ||
+      match< match_modes::anchored_longest >( grammar {}, "a" ).is_found )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      ab.* : accepted " << tail.size() + 2
+            << " letters after reading 2" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_tokenizer()
+{
+  std::cout << "      +-------------------------+" << std::endl
+            << "      | spark tokenizer testing |" << std::endl
+            << "      +-------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a ab|(a|b)+| +|c|cdd template expression
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using s_c =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'c' >
+    >;
+
+  using s_d =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'd' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'd' >
+    >;
+
+  using s_space =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 's' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, ' ' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_c =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_c
+    >;
+
+  using g_d =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'd' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_d
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, g_b
+    >;
+
+  using g_a_or_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', '|', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_a, g_b
+    >;
+
+  using g_word =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, '(', 'a', '|', 'b', ')', '+' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_many,
+      g_a_or_b
+    >;
+
+  using g_spaces =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, ' ', '+' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_many,
+      s_space
+    >;
+
+  using g_dd =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'd', 'd' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_d, g_d
+    >;
+
+  using g_cdd =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', 'd', 'd' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_c, g_dd
+    >;
+
+  using g_keyword_or_word =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'k', '|', 'w' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_ab, g_word
+    >;
+
+  using g_texts =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'k', '|', 'w', '|', 's' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_keyword_or_word, g_spaces
+    >;
+
+  using g_c_or_cdd =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c', '|', 'c', 'd', 'd' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_c, g_cdd
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 't', '|', 'c' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_texts, g_c_or_cdd
+    >;
+
+  using tokenizer = warp::spark::tokenizer< grammar >;
+
+  // kinds are listed from left to right, c then d may be read beyond c
+  static_assert( tokenizer::kind_count == 5 && tokenizer::lookback == 1,
+                 "Uh oh..." );
+
+  // compile time tokenization, ab being a keyword rather than a word
+  constexpr auto compile_time_kinds = []
+  {
+    std::array< std::size_t, 4 > kinds {};
+    std::size_t count = 0;
+
+    tokenizer::for_each_token
+      ( "ab aba",
+        [ & ]( const warp::spark::token &t ) { kinds[ count++ ] = t.kind; } );
+
+    kinds[ 3 ] = count;
+
+    return kinds;
+  }();
+
+  static_assert( compile_time_kinds[ 0 ] == 0 &&
+                   compile_time_kinds[ 1 ] == 2 &&
+                   compile_time_kinds[ 2 ] == 1 &&
+                   compile_time_kinds[ 3 ] == 3,
+                 "Uh oh..." );
+
+  // run time tokenization, longest tokens winning
+  const std::string_view input = "ab  abba c cdd cc";
+  const auto tokens = tokenizer::tokenize( input );
+  const std::size_t expected[][ 3 ] =
+  {
+    { 0, 0, 2 }, { 2, 2, 4 }, { 1, 4, 8 }, { 2, 8, 9 }, { 3, 9, 10 },
+    { 2, 10, 11 }, { 4, 11, 14 }, { 2, 14, 15 }, { 3, 15, 16 },
+    { 3, 16, 17 }
+  };
+
+  if( tokens.size() != std::size( expected ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( std::size_t t = 0; t < tokens.size(); ++t )
+    if( tokens[ t ].kind != expected[ t ][ 0 ] ||
+        tokens[ t ].begin != expected[ t ][ 1 ] ||
+        tokens[ t ].end != expected[ t ][ 2 ] )
+      throw std::runtime_error( "Uh oh..." );
+
+  // c is a token, cd is not
+  if( tokenizer::for_each_token( "abcdc", []( const auto & ) {} ) != 3 )
+    throw std::runtime_error( "Uh oh..." );
+
+  // a|a*b reads any number of a looking for a b, an unbounded lookback
+  using g_a_star =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', '*' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_many,
+      s_a
+    >;
+
+  using g_a_star_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', '*', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a_star, g_b
+    >;
+
+  using backtracking =
+    warp::spark::tokenizer
+    <
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'a', '|', 'a', '*', 'b' >,
+        warp::spark::group_binary_closures,
+        warp::spark::group_binary_closures::alternation,
+        g_a, g_a_star_b
+      >
+    >;
+
+  static_assert( backtracking::lookback ==
+                   warp::spark::detail::unbounded_lookback,
+                 "Uh oh..." );
+
+  const auto munched = backtracking::tokenize( "aaba" );
+
+  if( munched.size() != 2 ||
+      munched[ 0 ].kind != 1 || munched[ 0 ].end != 3 ||
+      munched[ 1 ].kind != 0 || munched[ 1 ].end != 4 )
+    throw std::runtime_error( "Uh oh..." );
+
+  // failing runs are remembered, a quadratic scan would not end in time
+  const std::string letters( 1000000, 'a' );
+  std::size_t a_count = 0;
+
+  backtracking::for_each_token
+    ( letters,
+      [ & ]( const warp::spark::token &t ) { a_count += t.kind == 0; } );
+
+  if( a_count != letters.size() )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      ab|(a|b)+| +|c|cdd : " << tokens.size()
+            << " tokens in \"" << input << "\"" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_automaton_validation()
+{
+  std::cout << "      +------------------------------------+" << std::endl
+            << "      | spark automaton validation testing |" << std::endl
+            << "      +------------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark::detail;
+
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  // a deterministic automaton for a|aa
+  using states =
+    warp::type_sequence
+    <
+      automaton_state
+        < warp::integral_sequence< char, '0' >, state_types::initial >,
+      automaton_state
+        < warp::integral_sequence< char, '1' >, state_types::final >,
+      automaton_state
+        < warp::integral_sequence< char, '2' >, state_types::final >
+    >;
+
+  using t_functions =
+    warp::type_sequence
+    <
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'a' >,
+          warp::integral_sequence< char, '0' >, s_a,
+          warp::integral_sequence< char, '1' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'a', 'a' >,
+          warp::integral_sequence< char, '1' >, s_a,
+          warp::integral_sequence< char, '2' >
+        >
+    >;
+
+  using g_commands =
+    warp::type_sequence
+    <
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a' >,
+          warp::integral_sequence< char, 'a' >
+        >
+    >;
+
+  // single pass validation of all sequences
+  using validation = automaton_validation< states, t_functions, g_commands >;
+
+  static_assert( validation::initial_state_count == 1 &&
+                   validation::final_state_count == 2 &&
+                   validation::is_state_sequence &&
+                   validation::is_t_function_sequence &&
+                   validation::is_g_command_sequence &&
+                   validation::is_automaton,
+                 "Uh oh..." );
+
+  // misplaced sequences and types that are not sequences are rejected
+  static_assert( ! automaton_validation
+                     < states, g_commands, g_commands >::is_automaton,
+                 "Uh oh..." );
+  static_assert( ! automaton_validation
+                     < t_functions, t_functions, g_commands >::
+                     is_state_sequence,
+                 "Uh oh..." );
+  static_assert( ! automaton_validation< int, t_functions, g_commands >::
+                     is_automaton,
+                 "Uh oh..." );
+  static_assert( ! state_sequence_traits
+                     < warp::integral_sequence< char, 'a' > >::
+                     is_state_sequence &&
+                   ! g_command_sequence_traits< int >::is_g_command_sequence,
+                 "Uh oh..." );
+
+  // the per sequence traits agree with the single pass validation
+  static_assert( state_sequence_traits< states >::is_state_sequence &&
+                   t_function_sequence_traits< t_functions >::
+                     is_t_function_sequence &&
+                   g_command_sequence_traits< g_commands >::
+                     is_g_command_sequence &&
+                   ! state_sequence_traits< t_functions >::is_state_sequence,
+                 "Uh oh..." );
+
+  std::cout << "      a|aa : " << validation::initial_state_count
+            << " initial state, " << validation::final_state_count
+            << " final states" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_shared_group_nodes()
+{
+  std::cout << "      +---------------------------------+" << std::endl
+            << "      | spark shared group node testing |" << std::endl
+            << "      +---------------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a (ab)(ab) template expression
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_ab =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_a, g_b
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', 'b', 'a', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_ab, g_ab
+    >;
+
+  using namespace warp::spark::detail;
+
+  // the tree holds each occurrence, the graph each distinct subtree
+  constexpr const auto &tree = group_node_table_from< grammar >::value;
+  constexpr const auto &dag = group_dag_from< grammar >::value;
+
+  static_assert( tree.node_count == 11 && dag.node_count == 6, "Uh oh..." );
+  static_assert( dag.nodes[ dag.root ].first == dag.nodes[ dag.root ].second,
+                 "Uh oh..." );
+  static_assert( dag.group_count == tree.group_count, "Uh oh..." );
+
+  // the graph is sized by distinct types, and measured once per node
+  using thompson = thompson_grammar< grammar >;
+
+  static_assert( group_dag_from< grammar >::table_type::node_capacity == 6,
+                 "Uh oh..." );
+  static_assert( thompson::nfa.state_count == thompson::nfa_size.state_count &&
+                   thompson::nfa.edge_count == thompson::nfa_size.edge_count &&
+                   thompson::nfa.command_count ==
+                     thompson::nfa_size.command_count,
+                 "Uh oh..." );
+
+  // the fixture has no repeated subtree
+  static_assert( group_dag_from
+                   < typename minimal_interesting_group::type >::value.
+                   node_count ==
+                 group_node_table_from
+                   < typename minimal_interesting_group::type >::value.
+                   node_count,
+                 "Uh oh..." );
+
+  // automata built from the graph still see both occurrences
+  using warp::spark::match;
+  using warp::spark::match_modes;
+
+  static_assert( match< match_modes::full >( grammar {}, "abab" ).is_found,
+                 "Uh oh..." );
+  static_assert( ! match< match_modes::full >( grammar {}, "ab" ).is_found,
+                 "Uh oh..." );
+
+  if( ! warp::spark::bit_parallel_matcher< grammar >::recognize( "abab" ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      (ab)(ab) : " << dag.node_count << " shared nodes out of "
+            << tree.node_count << std::endl << std::endl;
+}
+
+void test::spark_tester::test_grammar_simplification()
+{
+  std::cout << "      +--------------------------------------+" << std::endl
+            << "      | spark grammar simplification testing |" << std::endl
+            << "      +--------------------------------------+" << std::endl
+            << std::endl;
+
+  // attempting to build a (((a|b)*)*)?c template expression
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  using s_b =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'b' >
+    >;
+
+  using s_c =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'c' >
+    >;
+
+  using g_a =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_a
+    >;
+
+  using g_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'b' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_b
+    >;
+
+  using g_c =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'c' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::one_one,
+      s_c
+    >;
+
+  using g_a_or_b =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'a', '|', 'b' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::alternation,
+      g_a, g_b
+    >;
+
+  using g_star =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 's' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_many,
+      g_a_or_b
+    >;
+
+  using g_star_star =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 's', 's' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_many,
+      g_star
+    >;
+
+  using g_maybe =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'm' >,
+      warp::spark::group_unary_closures,
+      warp::spark::group_unary_closures::zero_one,
+      g_star_star
+    >;
+
+  using grammar =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'g' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      g_maybe, g_c
+    >;
+
+  using namespace warp::spark::detail;
+
+  using compiled = compiled_grammar< grammar >;
+  using recognition = recognition_grammar< grammar >;
+
+  // [ab]*c : a symbol, a closure, a symbol and a concatenation
+  static_assert( group_dag_from< grammar >::value.node_count == 11,
+                 "Uh oh..." );
+  static_assert( recognition::nodes.node_count == 4, "Uh oh..." );
+  static_assert( recognition::nodes.nodes[ 0 ].letters.contains( 'b' ),
+                 "Uh oh..." );
+  static_assert( recognition::nfa_size.state_count <
+                   compiled::nfa_size.state_count &&
+                 recognition::nfa.command_count == 0,
+                 "Uh oh..." );
+  static_assert( recognition::table.state_count <=
+                   compiled::table.state_count,
+                 "Uh oh..." );
+
+  // recognized languages are the same
+  using warp::spark::match;
+  using warp::spark::match_modes;
+
+  static_assert( match< match_modes::full >( grammar {}, "abbac" ).is_found,
+                 "Uh oh..." );
+  static_assert( match< match_modes::full >( grammar {}, "c" ).is_found,
+                 "Uh oh..." );
+  static_assert( ! match< match_modes::full >( grammar {}, "ca" ).is_found,
+                 "Uh oh..." );
+
+  using interesting = typename minimal_interesting_group::type;
+
+  for( const auto input : { "xaacdb", "c", "b", "xb", "acd", "bbbb",
+                            "ba", "x", "cdd", "" } )
+    if( match< match_modes::full >( interesting {}, input ).is_found !=
+          warp::spark::bit_parallel_matcher< interesting >::recognize( input ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      (((a|b)*)*)?c : " << recognition::nfa_size.state_count
+            << " Thompson states instead of "
+            << compiled::nfa_size.state_count << std::endl
+            << "      .*a*(b|cd?)+ : "
+            << recognition_grammar< interesting >::nfa_size.state_count
+            << " Thompson states instead of "
+            << compiled_grammar< interesting >::nfa_size.state_count
+            << std::endl << std::endl;
+}
+
+void test::spark_tester::test_epsilon_elimination()
+{
+  std::cout << "      +-----------------------------------+" << std::endl
+            << "      | spark epsilon elimination testing |" << std::endl
+            << "      +-----------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark::detail;
+
+  using s_a =
+    warp::spark::symbol
+    <
+      warp::integral_sequence< char, 'a' >,
+      warp::spark::symbol_types::inclusive,
+      warp::integral_sequence< char, 'a' >
+    >;
+
+  // an automaton for a+, the group a+ being delimited by epsilon transitions
+  using states =
+    warp::type_sequence
+    <
+      automaton_state
+        < warp::integral_sequence< char, '0' >, state_types::initial >,
+      automaton_state
+        < warp::integral_sequence< char, '1' >, state_types::intermediate >,
+      automaton_state
+        < warp::integral_sequence< char, '2' >, state_types::intermediate >,
+      automaton_state
+        < warp::integral_sequence< char, '3' >, state_types::final >
+    >;
+
+  using t_functions =
+    warp::type_sequence
+    <
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'e', '0' >,
+          warp::integral_sequence< char, '0' >, epsilon_transition,
+          warp::integral_sequence< char, '1' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'a' >,
+          warp::integral_sequence< char, '1' >, s_a,
+          warp::integral_sequence< char, '2' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'e', '1' >,
+          warp::integral_sequence< char, '2' >, epsilon_transition,
+          warp::integral_sequence< char, '3' >
+        >,
+      automaton_t_function
+        <
+          warp::integral_sequence< char, 'e', '2' >,
+          warp::integral_sequence< char, '2' >, epsilon_transition,
+          warp::integral_sequence< char, '1' >
+        >
+    >;
+
+  using g_commands =
+    warp::type_sequence
+    <
+      automaton_g_command
+        <
+          group_command_types::resetting,
+          warp::integral_sequence< char, 'a', '+' >,
+          warp::integral_sequence< char, 'e', '0' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::capturing,
+          warp::integral_sequence< char, 'a', '+' >,
+          warp::integral_sequence< char, 'a' >
+        >,
+      automaton_g_command
+        <
+          group_command_types::finishing,
+          warp::integral_sequence< char, 'a', '+' >,
+          warp::integral_sequence< char, 'e', '1' >
+        >
+    >;
+
+  using eliminated =
+    epsilon_free_automaton< automaton< states, t_functions, g_commands > >;
+
+  constexpr const auto &nfa = eliminated::value;
+
+  // the start state and the state reached by a, looping on a
+  static_assert( nfa.state_count == 2 && nfa.edge_count == 2, "Uh oh..." );
+  static_assert( ! nfa.final_states[ 0 ] && nfa.final_states[ 1 ],
+                 "Uh oh..." );
+
+  // commands of epsilon transitions are moved to letter transitions
+  constexpr auto resetting =
+    command_bit( group_command_types::resetting, 0, nfa.group_count );
+  constexpr auto capturing =
+    command_bit( group_command_types::capturing, 0, nfa.group_count );
+  constexpr auto finishing =
+    command_bit( group_command_types::finishing, 0, nfa.group_count );
+
+  static_assert( nfa.edges[ 0 ].commands.contains( resetting ) &&
+                   nfa.edges[ 0 ].commands.contains( capturing ),
+                 "Uh oh..." );
+  static_assert( ! nfa.edges[ 1 ].commands.contains( resetting ) &&
+                   nfa.edges[ 1 ].commands.contains( capturing ),
+                 "Uh oh..." );
+  static_assert( nfa.final_commands[ 1 ].contains( finishing ), "Uh oh..." );
+
+  // stepping only on letters
+  static_assert( nfa.recognize( "aaa" ) && ! nfa.recognize( "" ) &&
+                   ! nfa.recognize( "ab" ),
+                 "Uh oh..." );
+
+  std::cout << "      a+ : " << eliminated::thompson.edge_count
+            << " edges, " << nfa.edge_count << " without epsilon transitions"
+            << std::endl << std::endl;
+}
+
+// artifacts of the minimal interesting grammar are compiled here only
+template struct
+  warp::spark::grammar_artifacts
+    < test::spark_tester::minimal_interesting_group::type >;
+
+void test::spark_tester::test_grammar_artifacts()
+{
+  std::cout << "      +---------------------------------+" << std::endl
+            << "      | spark grammar artifacts testing |" << std::endl
+            << "      +---------------------------------+" << std::endl
+            << std::endl;
+
+  using grammar = typename minimal_interesting_group::type;
+  using artifacts = warp::spark::grammar_artifacts< grammar >;
+
+  // the same tree under another name
+  using renamed =
+    warp::spark::group
+    <
+      warp::integral_sequence< char, 'r' >,
+      warp::spark::group_binary_closures,
+      warp::spark::group_binary_closures::concatenation,
+      typename minimal_interesting_group::g_any_star,
+      typename minimal_interesting_group::g_a_star__b_or_cd_maybe_plus
+    >;
+
+  static_assert( warp::spark::grammar_fingerprint_v< grammar > ==
+                   warp::spark::grammar_fingerprint_v< renamed >,
+                 "Uh oh..." );
+  static_assert( warp::spark::grammar_fingerprint_v< grammar > !=
+                   warp::spark::grammar_fingerprint_v
+                     < typename minimal_interesting_group::g_any_star >,
+                 "Uh oh..." );
+  static_assert( artifacts::fingerprint ==
+                   warp::spark::grammar_fingerprint_v< grammar >,
+                 "Uh oh..." );
+
+  // definitions of a different form but with the same letters
+  using string_grammar =
+    warp::spark::regular_grammar< regular_grammar_string >;
+  using function_grammar =
+    warp::spark::regular_grammar< regular_grammar_string_function >;
+  using sequence_grammar =
+    warp::spark::regular_grammar
+      < typename regular_grammar_sequence::sequence >;
+
+  static_assert( warp::spark::grammar_fingerprint_v< string_grammar > ==
+                   warp::spark::grammar_fingerprint_v< function_grammar >,
+                 "Uh oh..." );
+  static_assert( warp::spark::grammar_fingerprint_v< string_grammar > !=
+                   warp::spark::grammar_fingerprint_v< sequence_grammar >,
+                 "Uh oh..." );
+
+  // artifacts reference the tables compiled for the grammar
+  static_assert( &artifacts::recognition_table ==
+                   &warp::spark::recognition_table_v< grammar >,
+                 "Uh oh..." );
+  static_assert( &artifacts::compiled_table ==
+                   &warp::spark::detail::compiled_grammar< grammar >::table,
+                 "Uh oh..." );
+
+  for( const auto input : { "xaacdb", "c", "b", "xb", "acd", "bbbb" } )
+    if( ! artifacts::recognize( input ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  for( const auto input : { "ba", "x", "cdd", "" } )
+    if( artifacts::recognize( input ) )
+      throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      fingerprint of .*a*(b|cd?)+ : " << std::hex
+            << artifacts::fingerprint << std::dec << std::endl << std::endl;
+}
+
+void test::spark_tester::test_grammar_compiler()
+{
+  std::cout << "      +--------------------------------+" << std::endl
+            << "      | spark grammar compiler testing |" << std::endl
+            << "      +--------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark;
+
+  using grammar = typename minimal_interesting_group::type;
+  using compiled = detail::compiled_grammar< grammar >;
+  using recognition = detail::recognition_grammar< grammar >;
+  using tables = minimal_interesting_tables;
+
+  // tables emitted by warp-sparkc are the ones compiled at compile time
+  static_assert( std::is_same< tables::table_type,
+                               compiled::table_type >::value &&
+                   std::is_same< tables::recognition_table_type,
+                                 recognition::table_type >::value,
+                 "Uh oh..." );
+  static_assert( same_tables( tables::table, compiled::table ) &&
+                   same_tables( tables::recognition_table,
+                                recognition::table ),
+                 "Uh oh..." );
+  static_assert( tables::fingerprint == grammar_fingerprint_v< grammar >,
+                 "Uh oh..." );
+  static_assert( match_table< match_modes::anchored_longest >
+                   ( tables::recognition_table, "xbcdx" ).end == 4,
+                 "Uh oh..." );
+
+  // so are tables compiled at run time
+  const auto definition =
+    parse_grammar_definition( minimal_interesting_definition::value );
+  const auto runtime_compiled =
+    detail::compile_runtime_grammar
+      ( detail::runtime_thompson_grammar_from( definition ), 128 );
+  const auto runtime_recognition =
+    detail::compile_runtime_grammar
+      ( detail::simplified_runtime_thompson_grammar_from( definition ),
+        128 );
+
+  if( ! same_tables( runtime_compiled.table, compiled::table ) ||
+      ! same_tables( runtime_recognition.table, recognition::table ) ||
+      runtime_compiled.statistics.state_count_before !=
+        compiled::statistics.state_count_before ||
+      runtime_recognition.statistics.transition_count_before !=
+        recognition::statistics.transition_count_before ||
+      detail::group_nodes_fingerprint
+        ( detail::runtime_group_dag_from( definition ) ) !=
+        grammar_fingerprint_v< grammar > )
+    throw std::runtime_error( "Uh oh..." );
+
+  for( const auto input : { "xaacdb", "c", "b", "xb", "acd", "bbbb" } )
+    if( ! match_table< match_modes::full >
+            ( runtime_recognition.table, input ).is_found )
+      throw std::runtime_error( "Uh oh..." );
+
+  for( const auto input : { "ba", "x", "cdd", "" } )
+    if( match_table< match_modes::full >
+          ( runtime_recognition.table, input ).is_found )
+      throw std::runtime_error( "Uh oh..." );
+
+  // invalid definitions and exhausted budgets are reported
+  bool is_reported = false;
+
+  try
+  {
+    parse_grammar_definition
+      ( "BEGIN_SYMBOLS;a=a;END_SYMBOLS;BEGIN_GROUPS;a=b;END_GROUPS;" );
+  }
+  catch( const grammar_definition_error &error )
+  {
+    is_reported = error.offset() == 45;
+  }
+
+  if( ! is_reported )
+    throw std::runtime_error( "Uh oh..." );
+
+  is_reported = false;
+
+  try
+  {
+    detail::compile_runtime_grammar
+      ( detail::runtime_thompson_grammar_from( definition ), 2 );
+  }
+  catch( const std::length_error & )
+  {
+    is_reported = true;
+  }
+
+  if( ! is_reported )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ compiled at run time : "
+            << runtime_compiled.table.state_count << " states, "
+            << runtime_recognition.table.state_count
+            << " states for recognition" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_compilation_agreement()
+{
+  std::cout << "      +-------------------------------------+" << std::endl
+            << "      | spark compilation agreement testing |" << std::endl
+            << "      +-------------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark;
+
+  using s_a = typename minimal_interesting_group::s_a;
+  using s_d = typename minimal_interesting_group::s_d;
+  using s_any = typename minimal_interesting_group::s_any;
+  using g_b = typename minimal_interesting_group::g_b;
+  using g_c = typename minimal_interesting_group::g_c;
+
+  using s_not_ab =
+    symbol
+    <
+      warp::integral_sequence< char, 'n', 'o', 't', 'a', 'b' >,
+      symbol_types::exclusive,
+      warp::integral_sequence< char, 'a', 'b' >
+    >;
+
+  using g_a =
+    group
+    <
+      warp::integral_sequence< char, 'a' >,
+      group_unary_closures, group_unary_closures::one_one, s_a
+    >;
+
+  using g_d =
+    group
+    <
+      warp::integral_sequence< char, 'd' >,
+      group_unary_closures, group_unary_closures::one_one, s_d
+    >;
+
+  using g_ab =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b' >,
+      group_binary_closures, group_binary_closures::concatenation, g_a, g_b
+    >;
+
+  // ((ab)+c?)*d, closures nested in closures
+  using g_ab_plus =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b', '+' >,
+      group_unary_closures, group_unary_closures::one_many, g_ab
+    >;
+
+  using g_c_maybe =
+    group
+    <
+      warp::integral_sequence< char, 'c', '?' >,
+      group_unary_closures, group_unary_closures::zero_one, g_c
+    >;
+
+  using g_ab_plus_c_maybe =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b', '+', 'c', '?' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_ab_plus, g_c_maybe
+    >;
+
+  using g_nested_star =
+    group
+    <
+      warp::integral_sequence< char, 'n', 'e', 's', 't' >,
+      group_unary_closures, group_unary_closures::zero_many,
+      g_ab_plus_c_maybe
+    >;
+
+  using nested_closures =
+    group
+    <
+      warp::integral_sequence< char, 'n', 'e', 's', 't', 'e', 'd' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_nested_star, g_d
+    >;
+
+  constexpr auto nested_closures_definition =
+    "BEGIN_SYMBOLS;"
+      "BASIC_SYMBOLS abcd;"
+    "END_SYMBOLS;"
+    "BEGIN_GROUPS;"
+      "SYMBOLS_AS_GROUPS a b c d;"
+      "ab = a.b;"
+      "abp = ab+;"
+      "cq = c?;"
+      "abpcq = abp.cq;"
+      "nest = abpcq*;"
+      "nested = nest.d;"
+    "END_GROUPS;";
+
+  // ab|cab|bd|abd, alternations of literals sharing ab
+  using g_cab =
+    group
+    <
+      warp::integral_sequence< char, 'c', 'a', 'b' >,
+      group_binary_closures, group_binary_closures::concatenation, g_c, g_ab
+    >;
+
+  using g_bd =
+    group
+    <
+      warp::integral_sequence< char, 'b', 'd' >,
+      group_binary_closures, group_binary_closures::concatenation, g_b, g_d
+    >;
+
+  using g_abd =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b', 'd' >,
+      group_binary_closures, group_binary_closures::concatenation, g_ab, g_d
+    >;
+
+  using g_ab_cab =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b', '|', 'c', 'a', 'b' >,
+      group_binary_closures, group_binary_closures::alternation, g_ab, g_cab
+    >;
+
+  using g_bd_abd =
+    group
+    <
+      warp::integral_sequence< char, 'b', 'd', '|', 'a', 'b', 'd' >,
+      group_binary_closures, group_binary_closures::alternation, g_bd, g_abd
+    >;
+
+  using literals =
+    group
+    <
+      warp::integral_sequence< char, 'l', 'i', 't' >,
+      group_binary_closures, group_binary_closures::alternation,
+      g_ab_cab, g_bd_abd
+    >;
+
+  constexpr auto literals_definition =
+    "BEGIN_SYMBOLS;"
+      "BASIC_SYMBOLS abcd;"
+    "END_SYMBOLS;"
+    "BEGIN_GROUPS;"
+      "SYMBOLS_AS_GROUPS a b c d;"
+      "ab = a.b;"
+      "cab = c.ab;"
+      "bd = b.d;"
+      "abd = ab.d;"
+      "abcab = ab|cab;"
+      "bdabd = bd|abd;"
+      "lit = abcab|bdabd;"
+    "END_GROUPS;";
+
+  // .[^ab]*a, any and exclusive symbols
+  using g_any =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'n', 'y' >,
+      group_unary_closures, group_unary_closures::one_one, s_any
+    >;
+
+  using g_not_ab_star =
+    group
+    <
+      warp::integral_sequence< char, 'n', '*' >,
+      group_unary_closures, group_unary_closures::zero_many, s_not_ab
+    >;
+
+  using g_any_not_ab_star =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'n' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_any, g_not_ab_star
+    >;
+
+  using symbols =
+    group
+    <
+      warp::integral_sequence< char, 's', 'y', 'm' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_any_not_ab_star, g_a
+    >;
+
+  constexpr auto symbols_definition =
+    "BEGIN_SYMBOLS;"
+      "BASIC_SYMBOLS a;"
+      "any = .;"
+      "notab = -ab;"
+    "END_SYMBOLS;"
+    "BEGIN_GROUPS;"
+      "SYMBOLS_AS_GROUPS a any;"
+      "n = notab*;"
+      "an = any.n;"
+      "sym = an.a;"
+    "END_GROUPS;";
+
+  // (ab|b)+(ab|b), the same subtree being used twice
+  using g_ab_b =
+    group
+    <
+      warp::integral_sequence< char, 'a', 'b', '|', 'b' >,
+      group_binary_closures, group_binary_closures::alternation, g_ab, g_b
+    >;
+
+  using g_ab_b_plus =
+    group
+    <
+      warp::integral_sequence< char, '(', 'a', 'b', '|', 'b', ')', '+' >,
+      group_unary_closures, group_unary_closures::one_many, g_ab_b
+    >;
+
+  using shared =
+    group
+    <
+      warp::integral_sequence< char, 's', 'h', 'a', 'r', 'e', 'd' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_ab_b_plus, g_ab_b
+    >;
+
+  constexpr auto shared_definition =
+    "BEGIN_SYMBOLS;"
+      "BASIC_SYMBOLS ab;"
+    "END_SYMBOLS;"
+    "BEGIN_GROUPS;"
+      "SYMBOLS_AS_GROUPS a b;"
+      "ab = a.b;"
+      "u = ab|b;"
+      "p = u+;"
+      "shared = p.u;"
+    "END_GROUPS;";
+
+  // both pipelines build the same tables, counting the same states and
+  // transitions before and after minimization
+  const auto compiles_alike = [ ]( auto grammar, const char *value )
+  {
+    using type = decltype( grammar );
+    using compiled = detail::compiled_grammar< type >;
+    using recognition = detail::recognition_grammar< type >;
+
+    const auto definition = parse_grammar_definition( value );
+    const auto runtime_compiled =
+      detail::compile_runtime_grammar
+        ( detail::runtime_thompson_grammar_from( definition ), 128 );
+    const auto runtime_recognition =
+      detail::compile_runtime_grammar
+        ( detail::simplified_runtime_thompson_grammar_from( definition ),
+          128 );
+
+    const auto same_statistics =
+      []( const detail::automaton_statistics &left,
+          const detail::automaton_statistics &right )
+      {
+        return
+          left.state_count_before == right.state_count_before &&
+          left.state_count_after == right.state_count_after &&
+          left.transition_count_before == right.transition_count_before &&
+          left.transition_count_after == right.transition_count_after;
+      };
+
+    return
+      same_tables( runtime_compiled.table, compiled::table ) &&
+      same_tables( runtime_recognition.table, recognition::table ) &&
+      same_statistics
+        ( runtime_compiled.statistics, compiled::statistics ) &&
+      same_statistics
+        ( runtime_recognition.statistics, recognition::statistics ) &&
+      detail::group_nodes_fingerprint
+        ( detail::runtime_group_dag_from( definition ) ) ==
+        grammar_fingerprint_v< type >;
+  };
+
+  if( ! compiles_alike( nested_closures {}, nested_closures_definition ) ||
+      ! compiles_alike( literals {}, literals_definition ) ||
+      ! compiles_alike( symbols {}, symbols_definition ) ||
+      ! compiles_alike( shared {}, shared_definition ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  // (a|b)*a(a|b)(a|b), needing 8 deterministic states at least, fits a
+  // budget in both pipelines or in none
+  using g_a_b =
+    group
+    <
+      warp::integral_sequence< char, 'a', '|', 'b' >,
+      group_binary_closures, group_binary_closures::alternation, g_a, g_b
+    >;
+
+  using g_a_b_star =
+    group
+    <
+      warp::integral_sequence< char, '(', 'a', '|', 'b', ')', '*' >,
+      group_unary_closures, group_unary_closures::zero_many, g_a_b
+    >;
+
+  using g_a_b_star_a =
+    group
+    <
+      warp::integral_sequence< char, 's', 'a' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_a_b_star, g_a
+    >;
+
+  using g_a_b_star_a_a_b =
+    group
+    <
+      warp::integral_sequence< char, 's', 'a', 'x' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_a_b_star_a, g_a_b
+    >;
+
+  using budgeted =
+    group
+    <
+      warp::integral_sequence< char, 'b', 'u', 'd' >,
+      group_binary_closures, group_binary_closures::concatenation,
+      g_a_b_star_a_a_b, g_a_b
+    >;
+
+  constexpr auto budgeted_definition =
+    "BEGIN_SYMBOLS;"
+      "BASIC_SYMBOLS ab;"
+    "END_SYMBOLS;"
+    "BEGIN_GROUPS;"
+      "SYMBOLS_AS_GROUPS a b;"
+      "x = a|b;"
+      "s = x*;"
+      "sa = s.a;"
+      "sax = sa.x;"
+      "bud = sax.x;"
+    "END_GROUPS;";
+
+  using thompson = detail::thompson_grammar< budgeted >;
+
+  constexpr auto budget =
+    detail::compiled_grammar< budgeted >::statistics.state_count_before;
+
+  using exhausted_subset =
+    detail::subset_automaton
+    <
+      budget - 1,
+      thompson::classes.class_count,
+      thompson::nfa_size.state_count,
+      3 * thompson::nfa.group_count
+    >;
+
+  static_assert( budget >= 8, "Uh oh..." );
+  static_assert( ! detail::determinize< exhausted_subset >
+                     ( thompson::nfa, thompson::classes ).is_complete,
+                 "Uh oh..." );
+
+  const auto definition = parse_grammar_definition( budgeted_definition );
+  const auto fitting =
+    detail::compile_runtime_grammar
+      ( detail::runtime_thompson_grammar_from( definition ), budget );
+
+  bool is_reported = false;
+
+  try
+  {
+    detail::compile_runtime_grammar
+      ( detail::runtime_thompson_grammar_from( definition ), budget - 1 );
+  }
+  catch( const std::length_error & )
+  {
+    is_reported = true;
+  }
+
+  if( ! is_reported ||
+      ! same_tables
+          ( fitting.table,
+            detail::compiled_grammar< budgeted, budget >::table ) )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      (a|b)*a(a|b)(a|b) : " << budget
+            << " deterministic states in both pipelines" << std::endl
+            << std::endl;
+}
+
+void test::spark_tester::test_runtime_grammar()
+{
+  std::cout << "      +-------------------------------+" << std::endl
+            << "      | spark runtime grammar testing |" << std::endl
+            << "      +-------------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark;
+
+  using grammar = typename minimal_interesting_group::type;
+  using compiled = detail::compiled_grammar< grammar >;
+  using recognition = detail::recognition_grammar< grammar >;
+
+  // a grammar built at run time holds tables compiled at compile time
+  const runtime_grammar built { minimal_interesting_definition::value };
+
+  if( ! same_tables( built.table(), compiled::table ) ||
+      ! same_tables( built.recognition_table(), recognition::table ) ||
+      built.fingerprint() != grammar_fingerprint_v< grammar > ||
+      built.statistics().state_count_after !=
+        compiled::statistics.state_count_after )
+    throw std::runtime_error( "Uh oh..." );
+
+  // and is run by the same engines
+  for( const auto input : { "xaacdb", "c", "xbcdx", "ba", "cdd", "" } )
+  {
+    const auto longest =
+      built.match< match_modes::anchored_longest >( input );
+    const auto shortest =
+      built.match< match_modes::anchored_shortest >( input );
+    const auto expected_longest =
+      match< match_modes::anchored_longest >( grammar {}, input );
+    const auto expected_shortest =
+      match< match_modes::anchored_shortest >( grammar {}, input );
+
+    counting_transducer at_run_time;
+    counting_transducer at_compile_time;
+
+    const auto is_transcribed = built.transcribe( input, at_run_time );
+    const auto is_expected =
+      transcribe( grammar {}, input, at_compile_time );
+
+    if( longest.is_found != expected_longest.is_found ||
+        longest.end != expected_longest.end ||
+        shortest.is_found != expected_shortest.is_found ||
+        shortest.end != expected_shortest.end ||
+        built.recognize( input ) != is_expected ||
+        is_transcribed != is_expected )
+      throw std::runtime_error( "Uh oh..." );
+
+    for( std::size_t g = 0; g < compiled::table.group_count; ++g )
+      if( at_run_time.captures[ g ] != at_compile_time.captures[ g ] ||
+          at_run_time.finishes[ g ] != at_compile_time.finishes[ g ] ||
+          at_run_time.resets[ g ] != at_compile_time.resets[ g ] )
+        throw std::runtime_error( "Uh oh..." );
+  }
+
+  // invalid definitions are reported at construction
+  bool is_reported = false;
+
+  try
+  {
+    runtime_grammar { "BEGIN_SYMBOLS;a=a;END_SYMBOLS;BEGIN_GROUPS;" };
+  }
+  catch( const grammar_definition_error & )
+  {
+    is_reported = true;
+  }
+
+  if( ! is_reported )
+    throw std::runtime_error( "Uh oh..." );
+
+  std::cout << "      .*a*(b|cd?)+ built at run time in "
+            << std::chrono::duration_cast< std::chrono::microseconds >
+                 ( built.compile_latency() ).count()
+            << " us" << std::endl << std::endl;
+}
+
+void test::spark_tester::test_grammar_arena()
+{
+  std::cout << "      +-----------------------------+" << std::endl
+            << "      | spark grammar arena testing |" << std::endl
+            << "      +-----------------------------+" << std::endl
+            << std::endl;
+
+  using namespace warp::spark;
+
+  using grammar = typename minimal_interesting_group::type;
+  using compiled = detail::compiled_grammar< grammar >;
+
+  // allocations are aligned and carved out of blocks
+  grammar_arena arena { 64 };
+
+  {
+    std::pmr::vector< double > values( 100, 1.0, &arena );
+
+    if( reinterpret_cast< std::uintptr_t >( values.data() ) %
+          alignof( double ) != 0 ||
+        arena.used() != 100 * sizeof( double ) || arena.block_count() != 1 )
+      throw std::runtime_error( "Uh oh..." );
+  }
+
+  // a reset keeps blocks, a release gives them back
+  arena.reset();
+
+  if( arena.used() != 0 || arena.block_count() != 1 )
+    throw std::runtime_error( "Uh oh..." );
+
+  arena.release();
+
+  if( arena.block_count() != 0 || arena.capacity() != 0 )
+    throw std::runtime_error( "Uh oh..." );
+
+  // recompiling with the same arena reuses its blocks
+  const runtime_grammar first
+    { minimal_interesting_definition::value, arena };
+  const auto block_count = arena.block_count();
+  const auto capacity = arena.capacity();
+  const auto used = arena.used();
+
+  for( auto reload = 0; reload < 10; ++reload )
+  {
+    const runtime_grammar reloaded
+      { minimal_interesting_definition::value, arena };
+
+    if( ! same_tables( reloaded.table(), compiled::table ) ||
+        reloaded.fingerprint() != first.fingerprint() ||
+        arena.block_count() != block_count ||
+        arena.capacity() != capacity || arena.used() != used )
+      throw std::runtime_error( "Uh oh..." );
+  }
+
+  std::cout << "      .*a*(b|cd?)+ recompiled in " << capacity
+            << " bytes of arena, " << used << " bytes used" << std::endl
+            << std::endl;
 }
 
 // doxygen
@@ -416,6 +416,318 @@ END_GROUPS;
       "END_GROUPS;";
   };
 
+  /**
+   * \brief The group tree of the minimal interesting regular grammar, built
+   * by hand using the regular grammar type system. Group indexes, in
+   * pre-order, are : .*a*(b|cd?)+ 0, .* 1, a*(b|cd?)+ 2, a* 3, (b|cd?)+ 4,
+   * b|cd? 5, b 6, cd? 7, c 8 and d? 9
+   */
+  struct minimal_interesting_group
+  {
+    /**
+     * \brief Matches any letter
+     */
+    using s_any =
+      warp::spark::symbol
+      <
+        warp::integral_sequence< char, 'a', 'n', 'y' >,
+        warp::spark::symbol_types::any
+      >;
+
+    /**
+     * \brief Matches the a letter
+     */
+    using s_a =
+      warp::spark::symbol
+      <
+        warp::integral_sequence< char, 'a' >,
+        warp::spark::symbol_types::inclusive,
+        warp::integral_sequence< char, 'a' >
+      >;
+
+    /**
+     * \brief Matches the b letter
+     */
+    using s_b =
+      warp::spark::symbol
+      <
+        warp::integral_sequence< char, 'b' >,
+        warp::spark::symbol_types::inclusive,
+        warp::integral_sequence< char, 'b' >
+      >;
+
+    /**
+     * \brief Matches the c letter
+     */
+    using s_c =
+      warp::spark::symbol
+      <
+        warp::integral_sequence< char, 'c' >,
+        warp::spark::symbol_types::inclusive,
+        warp::integral_sequence< char, 'c' >
+      >;
+
+    /**
+     * \brief Matches the d letter
+     */
+    using s_d =
+      warp::spark::symbol
+      <
+        warp::integral_sequence< char, 'd' >,
+        warp::spark::symbol_types::inclusive,
+        warp::integral_sequence< char, 'd' >
+      >;
+
+    /**
+     * \brief The .* group
+     */
+    using g_any_star =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, '.', '*' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::zero_many,
+        s_any
+      >;
+
+    /**
+     * \brief The a* group
+     */
+    using g_a_star =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'a', '*' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::zero_many,
+        s_a
+      >;
+
+    /**
+     * \brief The b group
+     */
+    using g_b =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'b' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::one_one,
+        s_b
+      >;
+
+    /**
+     * \brief The c group
+     */
+    using g_c =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'c' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::one_one,
+        s_c
+      >;
+
+    /**
+     * \brief The d? group
+     */
+    using g_d_maybe =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'd', '?' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::zero_one,
+        s_d
+      >;
+
+    /**
+     * \brief The cd? group
+     */
+    using g_cd_maybe =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'c', 'd', '?' >,
+        warp::spark::group_binary_closures,
+        warp::spark::group_binary_closures::concatenation,
+        g_c, g_d_maybe
+      >;
+
+    /**
+     * \brief The b|cd? group
+     */
+    using g_b_or_cd_maybe =
+      warp::spark::group
+      <
+        warp::integral_sequence< char, 'b', '|', 'c', 'd', '?' >,
+        warp::spark::group_binary_closures,
+        warp::spark::group_binary_closures::alternation,
+        g_b, g_cd_maybe
+      >;
+
+    /**
+     * \brief The (b|cd?)+ group
+     */
+    using g_b_or_cd_maybe_plus =
+      warp::spark::group
+      <
+        warp::integral_sequence
+          < char, '(', 'b', '|', 'c', 'd', '?', ')', '+' >,
+        warp::spark::group_unary_closures,
+        warp::spark::group_unary_closures::one_many,
+        g_b_or_cd_maybe
+      >;
+
+    /**
+     * \brief The a*(b|cd?)+ group
+     */
+    using g_a_star__b_or_cd_maybe_plus =
+      warp::spark::group
+      <
+        warp::integral_sequence
+          < char, 'a', '*', '(', 'b', '|', 'c', 'd', '?', ')', '+' >,
+        warp::spark::group_binary_closures,
+        warp::spark::group_binary_closures::concatenation,
+        g_a_star, g_b_or_cd_maybe_plus
+      >;
+
+    /**
+     * \brief The root group, .*a*(b|cd?)+
+     */
+    using type =
+      warp::spark::group
+      <
+        warp::integral_sequence
+          < char, '.', '*', 'a', '*', '(', 'b', '|', 'c', 'd', '?', ')', '+' >,
+        warp::spark::group_binary_closures,
+        warp::spark::group_binary_closures::concatenation,
+        g_any_star, g_a_star__b_or_cd_maybe_plus
+      >;
+  };
+
+  /**
+   * \brief A transducer counting commands it receives, for each group
+   */
+  struct counting_transducer
+  {
+    /**
+     * \brief Counts a capture
+     *
+     * \param group the index of the capturing group
+     */
+    template< class ITERATOR >
+      constexpr void capturing( std::size_t group, ITERATOR )
+      { ++captures[ group ]; }
+
+    /**
+     * \brief Counts a group end
+     *
+     * \param group the index of the finishing group
+     */
+    template< class ITERATOR >
+      constexpr void finishing( std::size_t group, ITERATOR )
+      { ++finishes[ group ]; }
+
+    /**
+     * \brief Counts a group start
+     *
+     * \param group the index of the resetting group
+     */
+    template< class ITERATOR >
+      constexpr void resetting( std::size_t group, ITERATOR )
+      { ++resets[ group ]; }
+
+    /**
+     * \brief Captures count of each group
+     */
+    std::size_t captures[ 10 ] {};
+
+    /**
+     * \brief Finishes count of each group
+     */
+    std::size_t finishes[ 10 ] {};
+
+    /**
+     * \brief Resets count of each group
+     */
+    std::size_t resets[ 10 ] {};
+  };
+
+  /**
+   * \brief Exposes the definition of the minimal interesting group, read at
+   * run time. minimal_interesting.grammar, compiled by warp-sparkc, holds the
+   * same definition
+   */
+  struct minimal_interesting_definition
+  {
+    /**
+     * \brief The definition, whose groups are the ones of the
+     * minimal_interesting_group type, named the same way
+     */
+    static constexpr auto value =
+      "BEGIN_SYMBOLS;"
+        "BASIC_SYMBOLS abcd;"
+        "any = .;"
+      "END_SYMBOLS;"
+      "BEGIN_GROUPS;"
+        ".* = any*;"
+        "a* = a*;"
+        "SYMBOLS_AS_GROUPS b c;"
+        "d? = d?;"
+        "cd? = c.d?;"
+        "b|cd? = b|cd?;"
+        "(b|cd?)+ = `b|cd?`+;"
+        "a*(b|cd?)+ = `a*`.(b|cd?)+;"
+        ".*a*(b|cd?)+ = `.*`.a*(b|cd?)+;"
+      "END_GROUPS;";
+  };
+
+  /**
+   * \brief Compares two compact tables, value by value, whatever the way
+   * they have been compiled
+   *
+   * \tparam LEFT a compact table type
+   * \tparam RIGHT a compact table type
+   *
+   * \param left a table
+   * \param right another table
+   *
+   * \return true if both tables hold the same values
+   */
+  template< class LEFT, class RIGHT >
+    static constexpr bool same_tables( const LEFT &left, const RIGHT &right )
+    {
+      if( left.state_count != right.state_count ||
+          left.class_count != right.class_count ||
+          left.action_count != right.action_count ||
+          left.command_count != right.command_count ||
+          left.initial_state != right.initial_state ||
+          left.group_count != right.group_count )
+        return false;
+
+      const auto cell_count = left.state_count * left.class_count;
+      bool same = true;
+
+      for( std::size_t l = 0; l < left.classes.size(); ++l )
+        same = same && left.classes[ l ] == right.classes[ l ];
+
+      for( std::size_t s = 0; s < left.state_count; ++s )
+        same =
+          same && left.final_states[ s ] == right.final_states[ s ] &&
+          left.final_actions[ s ] == right.final_actions[ s ] &&
+          left.types[ s ] == right.types[ s ];
+
+      for( std::size_t c = 0; c < cell_count; ++c )
+        same =
+          same && left.targets[ c ] == right.targets[ c ] &&
+          left.actions[ c ] == right.actions[ c ];
+
+      for( std::size_t a = 0; a <= left.action_count; ++a )
+        same = same && left.action_offsets[ a ] == right.action_offsets[ a ];
+
+      for( std::size_t c = 0; c < left.command_count; ++c )
+        same = same && left.commands[ c ] == right.commands[ c ];
+
+      return same;
+    }
+
   /**
    * \brief Test all features of spark
    */
@@ -437,6 +749,18 @@ END_GROUPS;
    */
   static void test_regular_grammar_instantiation();
 
+  /**
+   * \brief Test the minimization of deterministic automata, ensuring group
+   * boundaries are preserved
+   */
+  static void test_automaton_minimization();
+
+  /**
+   * \brief Test the computation of letter classes and the compression of
+   * automaton tables using them
+   */
+  static void test_automaton_compression();
+
   /**
    * \brief testing the transcription algorithm to use at compile time
    */
@@ -446,6 +770,123 @@ END_GROUPS;
    * \brief testing the transcription algorithm to use at run time
    */
   static void test_run_time_transcription();
+
+  /**
+   * \brief Test the stream matcher, fed with chunks split at arbitrary
+   * boundaries
+   */
+  static void test_stream_matching();
+
+  /**
+   * \brief Test capture spans, reported as offsets in the input
+   */
+  static void test_capture_spans();
+
+  /**
+   * \brief Test the lazy matcher, building deterministic states on demand
+   */
+  static void test_lazy_matching();
+
+  /**
+   * \brief Test the bit-parallel recognizer of small grammars
+   */
+  static void test_bit_parallel_matching();
+
+  /**
+   * \brief Test the extraction of required literals and the search using
+   * them as a prefilter
+   */
+  static void test_literal_prefilter();
+
+  /**
+   * \brief Test the union of several grammars matched in a single pass
+   */
+  static void test_union_matching();
+
+  /**
+   * \brief Test the Aho-Corasick automaton of alternations of literals
+   */
+  static void test_keyword_matching();
+
+  /**
+   * \brief Test the recognition of large inputs split into chunks run in
+   * parallel
+   */
+  static void test_parallel_matching();
+
+  /**
+   * \brief Test the transcription of memory mapped files
+   */
+  static void test_file_matching();
+
+  /**
+   * \brief Test the recognizer reading two letters per table lookup
+   */
+  static void test_stride_matching();
+
+  /**
+   * \brief Test the recognition of batches of inputs advanced in lockstep
+   */
+  static void test_interleaved_matching();
+
+  /**
+   * \brief Test full, anchored and unanchored match modes, and early
+   * termination on dead and always final states
+   */
+  static void test_match_modes();
+
+  /**
+   * \brief Test the longest match tokenizer
+   */
+  static void test_tokenizer();
+
+  /**
+   * \brief Test the single pass validation of automaton sequences
+   */
+  static void test_automaton_validation();
+
+  /**
+   * \brief Test the sharing of identical subtrees in group node tables
+   */
+  static void test_shared_group_nodes();
+
+  /**
+   * \brief Test algebraic simplifications of grammars used for recognition
+   */
+  static void test_grammar_simplification();
+
+  /**
+   * \brief Test the removal of epsilon transitions of automata
+   */
+  static void test_epsilon_elimination();
+
+  /**
+   * \brief Test grammar fingerprints and artifacts shared by translation
+   * units
+   */
+  static void test_grammar_artifacts();
+
+  /**
+   * \brief Test grammars compiled at run time and by warp-sparkc, giving the
+   * tables compiled at compile time
+   */
+  static void test_grammar_compiler();
+
+  /**
+   * \brief Test the agreement of run-time and compile-time compilations on
+   * grammars stressing each step of the pipeline
+   */
+  static void test_compilation_agreement();
+
+  /**
+   * \brief Test grammars built at run time from a definition string
+   */
+  static void test_runtime_grammar();
+
+  /**
+   * \brief Test the arena reused by successive run-time compilations
+   */
+  static void test_grammar_arena();
 };
 }
 
@@ -0,0 +1,118 @@
+#ifndef _WARP_SPARK_BIT_PARALLEL_MATCHER_HPP_
+#define _WARP_SPARK_BIT_PARALLEL_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/glushkov_automaton.hpp"
+#include "detail/group_node_table.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::spark
+{
+  /**
+   * \brief Bit-parallel recognizer for small grammars. The Glushkov automaton
+   * of the grammar, up to 64 positions, is simulated without any
+   * determinization : the set of active positions is a single 64 bits word,
+   * updated once per letter using per letter masks computed at compile time
+   * from symbol letter sequences. There is neither state blow-up nor memory
+   * beyond a few kilobytes of tables. Group commands are not reported, use
+   * transcribe for that matter.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct bit_parallel_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+    private :
+      /**
+       * \brief The flattened group tree
+       */
+      static constexpr auto &nodes_ =
+        detail::group_node_table_from< GRAMMAR >::value;
+
+    public :
+      /**
+       * \brief The number of positions of the grammar, that is, its number
+       * of symbols
+       */
+      static constexpr std::size_t position_count =
+        detail::count_glushkov_positions( nodes_ );
+
+      /**
+       * \brief The type of the Glushkov automaton
+       */
+      using automaton_type = detail::glushkov_automaton< position_count >;
+
+      /**
+       * \brief The Glushkov automaton of the grammar
+       */
+      static constexpr automaton_type automaton =
+        detail::build_glushkov_automaton< automaton_type >( nodes_ );
+
+      /**
+       * \brief Recognizes an input
+       *
+       * \tparam ITERATOR a forward iterator type on letters
+       *
+       * \param first the beginning of the input
+       * \param last the end of the input
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      template< class ITERATOR >
+        static constexpr bool recognize( ITERATOR first, ITERATOR last )
+        {
+          static_assert( std::is_base_of
+                           <
+                             std::forward_iterator_tag,
+                             typename std::iterator_traits< ITERATOR >::
+                               iterator_category
+                           >::value,
+                         "Invalid type used. Only forward iterator types are "
+                         "allowed." );
+
+          if( first == last )
+            return automaton.nullable;
+
+          std::uint64_t active =
+            automaton.first &
+            automaton.masks[ static_cast< unsigned char >( *first ) ];
+
+          for( ++first; active != 0 && first != last; ++first )
+            active =
+              automaton.follow( active ) &
+              automaton.masks[ static_cast< unsigned char >( *first ) ];
+
+          return ( active & automaton.last ) != 0;
+        }
+
+      /**
+       * \brief Recognizes a string
+       *
+       * \param input the string to recognize
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      static constexpr bool recognize( std::string_view input )
+      { return recognize( input.begin(), input.end() ); }
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_BIT_PARALLEL_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the bit-parallel recognizer of spark, simulating Glushkov
+ * automata of small grammars
+ */
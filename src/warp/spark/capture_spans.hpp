@@ -0,0 +1,217 @@
+#ifndef _WARP_SPARK_CAPTURE_SPANS_HPP_
+#define _WARP_SPARK_CAPTURE_SPANS_HPP_
+
+#include "group_traits.hpp"
+#include "detail/capture_engine.hpp"
+#include "detail/group_node_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief The part of the input captured by a group, designated by offsets
+   * in the input buffer. Letters are never copied.
+   */
+  struct capture_span
+  {
+    /**
+     * \brief The index of the group
+     */
+    std::size_t group;
+
+    /**
+     * \brief The offset of the first captured letter
+     */
+    std::size_t begin;
+
+    /**
+     * \brief The offset after the last captured letter
+     */
+    std::size_t end;
+  };
+
+  /**
+   * \brief Records a capture span for each group of a grammar, usable with
+   * capture, with a stream matcher and with match_file. Spans are those of
+   * the leftmost greedy parse of the input : alternatives are tried in
+   * order, closures take as many letters as possible, and groups of parses
+   * failing later never show up. A group span begins where the group is
+   * reset and ends after the last letter it captured ; a group is matched if
+   * it is finished in the accepted parse. Pending parses are held by value,
+   * thus, spans can be copied along with a stream state to resume a capture
+   * later. The storage is made of fixed-size arrays, sized by the number of
+   * automaton states and named groups of the grammar.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    class capture_spans
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      /**
+       * \brief The engine simulating parses of the grammar
+       */
+      using machine = detail::capture_machine< GRAMMAR >;
+
+    public :
+      /**
+       * \brief The number of named groups of the grammar
+       */
+      static constexpr std::size_t group_count =
+        detail::group_node_table_from< GRAMMAR >::value.group_count;
+
+      /**
+       * \brief Builds spans, no group being matched and no letter read
+       */
+      constexpr capture_spans()
+      : spans_ {}, matched_ {}, threads_ { machine::start() }
+      {
+        for( std::size_t g = 0; g < group_count; ++g )
+          spans_[ g ].group = g;
+      }
+
+      /**
+       * \brief Forgets pending parses and spans, to capture a new input
+       */
+      constexpr void reset()
+      {
+        threads_ = machine::start();
+
+        for( std::size_t g = 0; g < group_count; ++g )
+        {
+          spans_[ g ] = capture_span { g, 0, 0 };
+          matched_[ g ] = false;
+        }
+      }
+
+      /**
+       * \brief Reads a letter, advancing pending parses
+       *
+       * \param letter the letter to read
+       * \param offset the offset of the letter in the input
+       *
+       * \return false if the input read so far starts no parse anymore
+       */
+      constexpr bool step( char letter, std::size_t offset )
+      {
+        return machine::step
+          ( threads_, static_cast< unsigned char >( letter ), offset );
+      }
+
+      /**
+       * \brief Records spans of the accepted parse of the input read so far.
+       * Pending parses are kept, thus, more letters can be read afterward
+       *
+       * \return true if the input read so far is recognized by the grammar,
+       * false otherwise, no group being matched then
+       */
+      constexpr bool finish()
+      {
+        const auto *registers = machine::accepted( threads_ );
+
+        for( std::size_t g = 0; g < group_count; ++g )
+        {
+          spans_[ g ] = registers == nullptr ?
+            capture_span { g, 0, 0 } :
+            capture_span { g, registers->begins[ g ], registers->ends[ g ] };
+
+          matched_[ g ] = registers != nullptr && registers->matched[ g ];
+        }
+
+        return registers != nullptr;
+      }
+
+      /**
+       * \brief Gives the span of a group
+       *
+       * \param group the group index
+       *
+       * \return the span of the group, meaningful if the group is matched
+       */
+      constexpr const capture_span &operator[]( std::size_t group ) const
+      { return spans_[ group ]; }
+
+      /**
+       * \brief Indicates if a group is matched
+       *
+       * \param group the group index
+       *
+       * \return true if the group is finished in the accepted parse
+       */
+      constexpr bool is_matched( std::size_t group ) const
+      { return matched_[ group ]; }
+
+      /**
+       * \brief Gives the first span, for iteration purpose
+       *
+       * \return an iterator on the first span
+       */
+      constexpr auto begin() const { return spans_.begin(); }
+
+      /**
+       * \brief Gives the end of spans, for iteration purpose
+       *
+       * \return an iterator after the last span
+       */
+      constexpr auto end() const { return spans_.end(); }
+
+    private :
+      /**
+       * \brief The span of each group
+       */
+      std::array< capture_span, group_count > spans_;
+
+      /**
+       * \brief Indicates, for each group, if it is matched
+       */
+      std::array< bool, group_count > matched_;
+
+      /**
+       * \brief Pending parses of the input read so far
+       */
+      typename machine::threads_type threads_;
+    };
+
+  /**
+   * \brief Parses a buffer using a grammar, recording capture spans of all
+   * groups for the leftmost greedy parse
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param input the buffer to parse
+   * \param spans the capture spans to fill
+   *
+   * \return true if the whole input is recognized by the grammar, false
+   * otherwise
+   */
+  template< class GRAMMAR >
+    constexpr bool capture
+    (
+      const GRAMMAR &, std::string_view input,
+      capture_spans< GRAMMAR > &spans
+    )
+    {
+      spans.reset();
+
+      for( std::size_t i = 0; i < input.size(); ++i )
+        if( ! spans.step( input[ i ], i ) )
+          break;
+
+      return spans.finish();
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_CAPTURE_SPANS_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains capture spans, the zero-copy representation of group
+ * captures
+ */
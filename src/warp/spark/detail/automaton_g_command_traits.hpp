@@ -2,8 +2,11 @@
 #define _WARP_SPARK_DETAIL_AUTOMATON_G_COMMAND_TRAITS_HPP_
 
 #include "automaton_g_command_types.hpp"
+#include "../../core/types.hpp"
 #include "../../sequences/sequence_traits.hpp"
 
+#include <type_traits>
+
 namespace warp::spark::detail
 {
   /**
@@ -18,6 +21,21 @@ namespace warp::spark::detail
        * \brief Not a group command type
        */
       static constexpr bool is_automaton_g_command = false;
+
+      /**
+       * \brief Not a group command type
+       */
+      static constexpr auto type = static_cast< group_command_types >( -1 );
+
+      /**
+       * \brief Not a group command type
+       */
+      using group_name = undefined_type;
+
+      /**
+       * \brief Not a group command type
+       */
+      using t_function_id = undefined_type;
     };
 
   /**
@@ -71,6 +89,36 @@ namespace warp::spark::detail
         meta_sequence_traits
           < T_FUNCTION_ID_SEQUENCE< TFIS_T, TFI1, TFIN... > >::
           is_integral_sequence;
+
+      /**
+       * \brief The type of the command, exposed if the command is valid
+       */
+      static constexpr auto type =
+        is_automaton_g_command ?
+        TYPE : static_cast< group_command_types >( -1 );
+
+      /**
+       * \brief The name of the group this command is working on
+       */
+      using group_name =
+        std::conditional_t
+        <
+          is_automaton_g_command,
+          GROUP_NAME_SEQUENCE< GNS_T, GN1, GNN... >,
+          undefined_type
+        >;
+
+      /**
+       * \brief The identifier of the transition function this command is
+       * attached to
+       */
+      using t_function_id =
+        std::conditional_t
+        <
+          is_automaton_g_command,
+          T_FUNCTION_ID_SEQUENCE< TFIS_T, TFI1, TFIN... >,
+          undefined_type
+        >;
     };
 }
 
@@ -0,0 +1,222 @@
+#ifndef _WARP_SPARK_DETAIL_AUTOMATON_MINIMIZATION_HPP_
+#define _WARP_SPARK_DETAIL_AUTOMATON_MINIMIZATION_HPP_
+
+#include "automaton_table.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Statistics reported by the minimization of an automaton, giving a
+   * way to watch the footprint of a grammar
+   */
+  struct automaton_statistics
+  {
+    /**
+     * \brief The number of states before minimization
+     */
+    std::size_t state_count_before;
+
+    /**
+     * \brief The number of states after minimization
+     */
+    std::size_t state_count_after;
+
+    /**
+     * \brief The number of transitions before minimization
+     */
+    std::size_t transition_count_before;
+
+    /**
+     * \brief The number of transitions after minimization
+     */
+    std::size_t transition_count_after;
+  };
+
+  /**
+   * \brief Minimizes a deterministic automaton table, using the Moore partition
+   * refinement. Unreachable states are discarded first. Then, states are
+   * initially split by their final flag and final action, and blocks are
+   * refined until two states of a same block have, for each letter class, the
+   * same action and a target in a same block. Thus, states whose transitions
+   * drive distinct group commands are never merged. States of the resulting
+   * table are numbered in the breadth first order of the original automaton,
+   * the initial state being the state 0.
+   *
+   * \tparam TABLE an automaton table type
+   *
+   * \param table the deterministic table to minimize
+   *
+   * \return the minimal table, using the same capacities and actions
+   */
+  template< class TABLE >
+    constexpr TABLE minimize_automaton_table( const TABLE &table )
+    {
+      constexpr auto no_state = TABLE::no_state;
+      const auto class_count = table.classes.class_count;
+
+      // breadth first exploration, discarding unreachable states
+      std::array< std::size_t, TABLE::state_capacity > order {};
+      std::array< bool, TABLE::state_capacity > reached {};
+      std::size_t order_count = 0;
+
+      order[ order_count++ ] = table.initial_state;
+      reached[ table.initial_state ] = true;
+
+      for( std::size_t o = 0; o < order_count; ++o )
+        for( std::size_t c = 0; c < class_count; ++c )
+        {
+          const auto target = table.class_target( order[ o ], c );
+
+          if( target != no_state && ! reached[ target ] )
+          {
+            reached[ target ] = true;
+            order[ order_count++ ] = target;
+          }
+        }
+
+      // initial partition : final flag and final action
+      std::array< std::size_t, TABLE::state_capacity > blocks {};
+      std::array< std::size_t, TABLE::state_capacity > refined {};
+      std::size_t block_count = 0;
+
+      for( std::size_t o = 0; o < order_count; ++o )
+      {
+        const auto state = order[ o ];
+        std::size_t p = 0;
+
+        while( p < o &&
+               ( table.final_states[ order[ p ] ] !=
+                   table.final_states[ state ] ||
+                 table.final_actions[ order[ p ] ] !=
+                   table.final_actions[ state ] ) )
+          ++p;
+
+        blocks[ state ] = p < o ? blocks[ order[ p ] ] : block_count++;
+      }
+
+      // refinement until stability
+      for( bool stable = false; ! stable; )
+      {
+        std::size_t refined_count = 0;
+
+        for( std::size_t o = 0; o < order_count; ++o )
+        {
+          const auto state = order[ o ];
+          std::size_t p = 0;
+
+          for( ; p < o; ++p )
+          {
+            const auto other = order[ p ];
+
+            if( blocks[ other ] != blocks[ state ] )
+              continue;
+
+            bool equivalent = true;
+
+            for( std::size_t c = 0; equivalent && c < class_count; ++c )
+            {
+              const auto target = table.class_target( state, c );
+              const auto other_target = table.class_target( other, c );
+
+              equivalent =
+                table.class_action( state, c ) ==
+                  table.class_action( other, c ) &&
+                ( target == no_state ?
+                  other_target == no_state :
+                  other_target != no_state &&
+                    blocks[ target ] == blocks[ other_target ] );
+            }
+
+            if( equivalent )
+              break;
+          }
+
+          refined[ state ] = p < o ? refined[ order[ p ] ] : refined_count++;
+        }
+
+        stable = refined_count == block_count;
+        block_count = refined_count;
+        blocks = refined;
+      }
+
+      // building the quotient table
+      TABLE result;
+
+      result.state_count = block_count;
+      result.initial_state = blocks[ table.initial_state ];
+      result.action_count = table.action_count;
+      result.command_count = table.command_count;
+      result.group_count = table.group_count;
+      result.classes = table.classes;
+      result.action_offsets = table.action_offsets;
+      result.commands = table.commands;
+
+      for( std::size_t o = 0; o < order_count; ++o )
+      {
+        const auto state = order[ o ];
+        const auto block = blocks[ state ];
+
+        result.final_states[ block ] = table.final_states[ state ];
+        result.final_actions[ block ] = table.final_actions[ state ];
+
+        for( std::size_t c = 0; c < class_count; ++c )
+        {
+          const auto target = table.class_target( state, c );
+          const auto cell = block * TABLE::class_capacity + c;
+
+          result.targets[ cell ] =
+            target == no_state ? no_state : blocks[ target ];
+          result.actions[ cell ] = table.class_action( state, c );
+        }
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Minimization of an automaton type. The automaton is flattened into
+   * an automaton table, then minimized at compile time. Statistics are
+   * exposed to watch the benefit of the minimization.
+   *
+   * \tparam AUTOMATON a valid and deterministic automaton type
+   */
+  template< class AUTOMATON >
+    struct automaton_minimization
+    {
+      static_assert( automaton_table_from< AUTOMATON >::is_deterministic,
+                     "Invalid type used. Only deterministic automaton types "
+                     "can be minimized." );
+
+      /**
+       * \brief The table of the automaton, as it is defined
+       */
+      static constexpr auto original = automaton_table_from< AUTOMATON >::value;
+
+      /**
+       * \brief The minimal table
+       */
+      static constexpr auto table = minimize_automaton_table( original );
+
+      /**
+       * \brief State and transition counts before and after minimization
+       */
+      static constexpr automaton_statistics statistics
+      {
+        original.state_count, table.state_count,
+        original.transition_count(), table.transition_count()
+      };
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_AUTOMATON_MINIMIZATION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the minimization pass working on deterministic automata,
+ * reducing the size of tables used by transcription algorithms
+ */
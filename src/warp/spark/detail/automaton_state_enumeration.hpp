@@ -30,7 +30,20 @@ namespace warp::spark::detail
      * initial and a final state. An automaton might have one and unique initial
      * and final state.
      */
-    initial_and_final
+    initial_and_final,
+
+    /**
+     * \brief A dead state. No final state can be reached from a dead state,
+     * thus, a run reaching it is rejected without reading further.
+     */
+    dead,
+
+    /**
+     * \brief An always final state. A final state from which only always
+     * final states can be reached, thus, a run reaching it is recognized
+     * whatever the remaining letters are.
+     */
+    always_final
   };
 }
 
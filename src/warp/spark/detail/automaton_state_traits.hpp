@@ -45,6 +45,16 @@ namespace warp::spark::detail
        * \brief Not a valid state
        */
       static constexpr bool is_final = false;
+
+      /**
+       * \brief Not a valid state
+       */
+      static constexpr bool is_dead = false;
+
+      /**
+       * \brief Not a valid state
+       */
+      static constexpr bool is_always_final = false;
     };
 
   /**
@@ -111,7 +121,24 @@ namespace warp::spark::detail
       static constexpr bool is_final =
         is_automaton_state ?
         ( ( ST == state_types::final ) ||
-          ( ST == state_types::initial_and_final ) ) :
+          ( ST == state_types::initial_and_final ) ||
+          ( ST == state_types::always_final ) ) :
+        false;
+
+      /**
+       * \brief useful for early termination
+       */
+      static constexpr bool is_dead =
+        is_automaton_state ?
+        ( ST == state_types::dead ) :
+        false;
+
+      /**
+       * \brief useful for early termination
+       */
+      static constexpr bool is_always_final =
+        is_automaton_state ?
+        ( ST == state_types::always_final ) :
         false;
     };
 }
@@ -220,6 +220,12 @@ namespace warp::spark::detail
         automaton_state_id_traits< TARGET_STATE_ID >::is_automaton_state_id &&
         symbol_traits< FN_ARG >::is_symbol;
 
+      /**
+       * \brief the identifier of the transition function
+       */
+      using id =
+        std::conditional_t< is_automaton_t_function, ID, undefined_type >;
+
       /**
        * \brief The source state identifier
        */
@@ -0,0 +1,617 @@
+#ifndef _WARP_SPARK_DETAIL_AUTOMATON_TABLE_HPP_
+#define _WARP_SPARK_DETAIL_AUTOMATON_TABLE_HPP_
+
+#include "automaton_traits.hpp"
+#include "automaton_state_traits.hpp"
+#include "automaton_t_function_traits.hpp"
+#include "automaton_t_function_args.hpp"
+#include "automaton_g_command_traits.hpp"
+#include "automaton_g_command_types.hpp"
+#include "letter_set.hpp"
+#include "letter_classes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Value representation of a group command, once flattened in an
+   * automaton table. The group is designated by its index in the automaton
+   */
+  struct command_entry
+  {
+    /**
+     * \brief The type of the command, applied on the group
+     */
+    group_command_types type;
+
+    /**
+     * \brief The index of the group the command is working on
+     */
+    std::size_t group;
+
+    /**
+     * \brief Equality of two commands
+     *
+     * \param other the command to compare with this one
+     *
+     * \return true if both command type and group are the same
+     */
+    constexpr bool operator == ( const command_entry &other ) const
+    { return type == other.type && group == other.group; }
+
+    /**
+     * \brief Inequality of two commands
+     *
+     * \param other the command to compare with this one
+     *
+     * \return true if command type or group differ
+     */
+    constexpr bool operator != ( const command_entry &other ) const
+    { return ! ( *this == other ); }
+  };
+
+  /**
+   * \brief Value representation of a deterministic automaton. Letters are
+   * mapped to their class and each state owns a row made of a cell per letter
+   * class, each cell containing the target state and the action (a set of
+   * group commands) to apply when a letter of the class is read. Each state
+   * also owns a final action, applied when the input ends in this state.
+   * Capacities are template parameters making the table usable in constant
+   * expressions, only the first state_count rows are meaningful
+   *
+   * \tparam STATE_CAPACITY the maximum number of states the table can hold
+   * \tparam CLASS_CAPACITY the width of a row, large enough for all letter
+   * classes
+   * \tparam ACTION_CAPACITY the maximum number of distinct actions, the empty
+   * action included
+   * \tparam COMMAND_CAPACITY the maximum number of commands stored in all
+   * actions
+   */
+  template
+    <
+      std::size_t STATE_CAPACITY,
+      std::size_t CLASS_CAPACITY,
+      std::size_t ACTION_CAPACITY,
+      std::size_t COMMAND_CAPACITY
+    >
+    struct automaton_table
+    {
+      static_assert( STATE_CAPACITY > 0 && CLASS_CAPACITY > 0 &&
+                       ACTION_CAPACITY > 0,
+                     "Invalid table capacities. An automaton table needs at "
+                     "least a state, a letter class and the empty action." );
+
+      /**
+       * \brief Exposes the state capacity of this table
+       */
+      static constexpr std::size_t state_capacity = STATE_CAPACITY;
+
+      /**
+       * \brief Exposes the width of a row of this table
+       */
+      static constexpr std::size_t class_capacity = CLASS_CAPACITY;
+
+      /**
+       * \brief Exposes the action capacity of this table
+       */
+      static constexpr std::size_t action_capacity = ACTION_CAPACITY;
+
+      /**
+       * \brief Exposes the command capacity of this table
+       */
+      static constexpr std::size_t command_capacity = COMMAND_CAPACITY;
+
+      /**
+       * \brief Marks a cell without any transition
+       */
+      static constexpr std::size_t no_state = STATE_CAPACITY;
+
+      /**
+       * \brief Identifier of the action containing no command
+       */
+      static constexpr std::size_t no_action = 0;
+
+      /**
+       * \brief Builds an empty table. All cells are transition free and only
+       * the empty action is registered
+       */
+      constexpr automaton_table()
+      {
+        for( std::size_t i = 0; i < targets.size(); ++i )
+          targets[ i ] = no_state;
+      }
+
+      /**
+       * \brief Gets the target state of a transition, using a letter class
+       *
+       * \param state the source state
+       * \param klass the class of the letter read in the source state
+       *
+       * \return the target state or no_state if there is no transition
+       */
+      constexpr std::size_t class_target
+      ( std::size_t state, std::size_t klass ) const
+      { return targets[ state * CLASS_CAPACITY + klass ]; }
+
+      /**
+       * \brief Gets the action of a transition, using a letter class
+       *
+       * \param state the source state
+       * \param klass the class of the letter read in the source state
+       *
+       * \return the action identifier, no_action if nothing has to be done
+       */
+      constexpr std::size_t class_action
+      ( std::size_t state, std::size_t klass ) const
+      { return actions[ state * CLASS_CAPACITY + klass ]; }
+
+      /**
+       * \brief Gets the target state of a transition
+       *
+       * \param state the source state
+       * \param letter the letter read in the source state
+       *
+       * \return the target state or no_state if there is no transition
+       */
+      constexpr std::size_t target
+      ( std::size_t state, unsigned char letter ) const
+      { return class_target( state, classes.class_of[ letter ] ); }
+
+      /**
+       * \brief Gets the action attached to a transition
+       *
+       * \param state the source state
+       * \param letter the letter read in the source state
+       *
+       * \return the action identifier, no_action if nothing has to be done
+       */
+      constexpr std::size_t action
+      ( std::size_t state, unsigned char letter ) const
+      { return class_action( state, classes.class_of[ letter ] ); }
+
+      /**
+       * \brief Gets the first command of an action
+       *
+       * \param action an action identifier
+       *
+       * \return the index of the first command of the action
+       */
+      constexpr std::size_t action_begin( std::size_t action ) const
+      { return action_offsets[ action ]; }
+
+      /**
+       * \brief Gets the end of the command range of an action
+       *
+       * \param action an action identifier
+       *
+       * \return the index after the last command of the action
+       */
+      constexpr std::size_t action_end( std::size_t action ) const
+      { return action_offsets[ action + 1 ]; }
+
+      /**
+       * \brief Counts cells owning a transition in meaningful rows
+       *
+       * \return the number of transitions of this table
+       */
+      constexpr std::size_t transition_count() const
+      {
+        std::size_t count = 0;
+
+        for( std::size_t s = 0; s < state_count; ++s )
+          for( std::size_t c = 0; c < classes.class_count; ++c )
+            if( class_target( s, c ) != no_state )
+              ++count;
+
+        return count;
+      }
+
+      /**
+       * \brief Registers an action made of a range of commands. If an
+       * identical action already exists, it is reused
+       *
+       * \param first the first command of the range
+       * \param count the number of command in the range
+       *
+       * \return the identifier of the action
+       */
+      constexpr std::size_t add_action
+      ( const command_entry *first, std::size_t count )
+      {
+        if( count == 0 )
+          return no_action;
+
+        for( std::size_t a = 1; a < action_count; ++a )
+        {
+          if( action_end( a ) - action_begin( a ) != count )
+            continue;
+
+          bool same = true;
+
+          for( std::size_t c = 0; same && c < count; ++c )
+            same = commands[ action_begin( a ) + c ] == first[ c ];
+
+          if( same )
+            return a;
+        }
+
+        for( std::size_t c = 0; c < count; ++c )
+          commands[ command_count++ ] = first[ c ];
+
+        action_offsets[ action_count + 1 ] = command_count;
+
+        return action_count++;
+      }
+
+      /**
+       * \brief The number of meaningful states
+       */
+      std::size_t state_count = 0;
+
+      /**
+       * \brief Index of the initial state
+       */
+      std::size_t initial_state = 0;
+
+      /**
+       * \brief The number of registered actions, the empty one included
+       */
+      std::size_t action_count = 1;
+
+      /**
+       * \brief The number of registered commands
+       */
+      std::size_t command_count = 0;
+
+      /**
+       * \brief The number of distinct groups commands are working on
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief The letter partition giving the column of each letter
+       */
+      letter_classes classes {};
+
+      /**
+       * \brief Indicates, for each state, if it is final
+       */
+      std::array< bool, STATE_CAPACITY > final_states {};
+
+      /**
+       * \brief The action applied when the input ends in a final state
+       */
+      std::array< std::size_t, STATE_CAPACITY > final_actions {};
+
+      /**
+       * \brief Target state of each cell
+       */
+      std::array< std::size_t, STATE_CAPACITY * CLASS_CAPACITY > targets {};
+
+      /**
+       * \brief Action of each cell
+       */
+      std::array< std::size_t, STATE_CAPACITY * CLASS_CAPACITY > actions {};
+
+      /**
+       * \brief Command ranges of actions. Commands of the action a are located
+       * between action_offsets[ a ] and action_offsets[ a + 1 ]
+       */
+      std::array< std::size_t, ACTION_CAPACITY + 1 > action_offsets {};
+
+      /**
+       * \brief Storage for commands of all actions
+       */
+      std::array< command_entry, COMMAND_CAPACITY > commands {};
+    };
+
+  /**
+   * \brief Gives the position of a type inside a type pack
+   *
+   * \tparam T the type to look for
+   * \tparam TS the type pack to explore
+   *
+   * \return the position of the first occurrence of T in TS or the size of the
+   * pack if T is not found
+   */
+  template< class T, class... TS >
+    constexpr std::size_t index_of_type()
+    {
+      constexpr bool matches[] = { std::is_same< T, TS >::value..., false };
+
+      for( std::size_t i = 0; i < sizeof...( TS ); ++i )
+        if( matches[ i ] )
+          return i;
+
+      return sizeof...( TS );
+    }
+
+  /**
+   * \brief Flattens a type level automaton into an automaton table. This
+   * unspecialized version is used when the provided type does not have the
+   * template signature of an automaton
+   *
+   * \tparam AUTOMATON a type that is not an automaton
+   */
+  template< class AUTOMATON >
+    struct automaton_table_from
+    {
+      static_assert( automaton_traits< AUTOMATON >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+    };
+
+  /**
+   * \brief Specialization used with a type looking like an automaton. States
+   * are indexed in the order of the state sequence, groups are indexed in the
+   * order of their first appearance in the group command sequence and each
+   * transition function gives an action made of its attached commands.
+   *
+   * \tparam AUTOMATON template signature for an automaton
+   * \tparam STATE_SEQUENCE the type sequence template holding states
+   * \tparam STATES states of the automaton
+   * \tparam T_FUNCTION_SEQUENCE the type sequence template holding transition
+   * functions
+   * \tparam T_FUNCTIONS transition functions of the automaton
+   * \tparam G_COMMAND_SEQUENCE the type sequence template holding group
+   * commands
+   * \tparam G_COMMANDS group commands of the automaton
+   */
+  template
+    <
+      template< class, class, class > class AUTOMATON,
+      template< class... > class STATE_SEQUENCE, class... STATES,
+      template< class... > class T_FUNCTION_SEQUENCE, class... T_FUNCTIONS,
+      template< class... > class G_COMMAND_SEQUENCE, class... G_COMMANDS
+    >
+    struct automaton_table_from
+    <
+      AUTOMATON
+        <
+          STATE_SEQUENCE< STATES... >,
+          T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+          G_COMMAND_SEQUENCE< G_COMMANDS... >
+        >
+    >
+    {
+      static_assert( automaton_traits
+                       <
+                         AUTOMATON
+                           <
+                             STATE_SEQUENCE< STATES... >,
+                             T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+                             G_COMMAND_SEQUENCE< G_COMMANDS... >
+                           >
+                       >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+
+    private :
+      /**
+       * \brief Letter partition of the automaton
+       */
+      static constexpr letter_classes classes_ =
+        letter_classes_from
+        <
+          AUTOMATON
+            <
+              STATE_SEQUENCE< STATES... >,
+              T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+              G_COMMAND_SEQUENCE< G_COMMANDS... >
+            >
+        >::value;
+
+    public :
+      /**
+       * \brief The table type used to hold the automaton, large enough for all
+       * states and letter classes, an action per transition function and all
+       * commands
+       */
+      using table_type =
+        automaton_table
+        <
+          sizeof...( STATES ),
+          classes_.class_count,
+          sizeof...( T_FUNCTIONS ) + 1,
+          sizeof...( G_COMMANDS )
+        >;
+
+    private :
+      /**
+       * \brief Source state index of each transition function
+       */
+      static constexpr std::size_t sources_[] =
+      {
+        index_of_type
+          <
+            typename automaton_t_function_traits< T_FUNCTIONS >::
+              source_state_id,
+            typename automaton_state_traits< STATES >::identifier...
+          >()...
+      };
+
+      /**
+       * \brief Target state index of each transition function
+       */
+      static constexpr std::size_t targets_[] =
+      {
+        index_of_type
+          <
+            typename automaton_t_function_traits< T_FUNCTIONS >::
+              target_state_id,
+            typename automaton_state_traits< STATES >::identifier...
+          >()...
+      };
+
+      /**
+       * \brief Indicates which transition functions are epsilon transitions
+       */
+      static constexpr bool epsilons_[] =
+      {
+        automaton_t_function_traits< T_FUNCTIONS >::is_epsilon_transition...
+      };
+
+      /**
+       * \brief Letters consumed by each transition function
+       */
+      static constexpr letter_set letters_[] =
+      {
+        t_function_letters
+          <
+            typename automaton_t_function_traits< T_FUNCTIONS >::
+              function_argument
+          >::value...
+      };
+
+      /**
+       * \brief Type of each group command
+       */
+      static constexpr group_command_types command_types_[] =
+      { automaton_g_command_traits< G_COMMANDS >::type... };
+
+      /**
+       * \brief For each group command, the position of the first command
+       * working on the same group
+       */
+      static constexpr std::size_t command_groups_[] =
+      {
+        index_of_type
+          <
+            typename automaton_g_command_traits< G_COMMANDS >::group_name,
+            typename automaton_g_command_traits< G_COMMANDS >::group_name...
+          >()...
+      };
+
+      /**
+       * \brief For each group command, the index of the attached transition
+       * function
+       */
+      static constexpr std::size_t command_t_functions_[] =
+      {
+        index_of_type
+          <
+            typename automaton_g_command_traits< G_COMMANDS >::t_function_id,
+            typename automaton_t_function_traits< T_FUNCTIONS >::id...
+          >()...
+      };
+
+      /**
+       * \brief Checks that no epsilon transition exist and that transition
+       * functions leaving a same state do not share any letter
+       *
+       * \return true if the automaton is deterministic
+       */
+      static constexpr bool check_determinism()
+      {
+        for( std::size_t i = 0; i < sizeof...( T_FUNCTIONS ); ++i )
+        {
+          if( epsilons_[ i ] )
+            return false;
+
+          for( std::size_t j = 0; j < i; ++j )
+            if( sources_[ i ] == sources_[ j ] &&
+                ! ( letters_[ i ] & letters_[ j ] ).empty() )
+              return false;
+        }
+
+        return true;
+      }
+
+      /**
+       * \brief Builds the table
+       *
+       * \return the table representing the automaton
+       */
+      static constexpr table_type make()
+      {
+        constexpr bool initials[] =
+        { automaton_state_traits< STATES >::is_initial... };
+
+        constexpr bool finals[] =
+        { automaton_state_traits< STATES >::is_final... };
+
+        table_type result;
+
+        result.state_count = sizeof...( STATES );
+        result.classes = classes_;
+
+        for( std::size_t s = 0; s < sizeof...( STATES ); ++s )
+        {
+          if( initials[ s ] )
+            result.initial_state = s;
+
+          result.final_states[ s ] = finals[ s ];
+        }
+
+        // dense group indices, in order of first appearance
+        std::array< std::size_t, sizeof...( G_COMMANDS ) + 1 > groups {};
+
+        for( std::size_t c = 0; c < sizeof...( G_COMMANDS ); ++c )
+          if( command_groups_[ c ] == c )
+            groups[ c ] = result.group_count++;
+          else
+            groups[ c ] = groups[ command_groups_[ c ] ];
+
+        for( std::size_t t = 0; t < sizeof...( T_FUNCTIONS ); ++t )
+        {
+          // gathering attached commands, ignoring duplicates
+          std::array< command_entry, sizeof...( G_COMMANDS ) + 1 > pending {};
+          std::size_t pending_count = 0;
+
+          for( std::size_t c = 0; c < sizeof...( G_COMMANDS ); ++c )
+          {
+            if( command_t_functions_[ c ] != t )
+              continue;
+
+            const command_entry entry { command_types_[ c ], groups[ c ] };
+            bool known = false;
+
+            for( std::size_t p = 0; ! known && p < pending_count; ++p )
+              known = pending[ p ] == entry;
+
+            if( ! known )
+              pending[ pending_count++ ] = entry;
+          }
+
+          const auto action = result.add_action( &pending[ 0 ], pending_count );
+
+          for( std::size_t c = 0; c < classes_.class_count; ++c )
+          {
+            if( ( classes_.letters_of( c ) & letters_[ t ] ).empty() )
+              continue;
+
+            const auto cell = sources_[ t ] * classes_.class_count + c;
+
+            result.targets[ cell ] = targets_[ t ];
+            result.actions[ cell ] = action;
+          }
+        }
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief Indicates if the automaton is deterministic. If not, the
+       * exposed table is meaningless
+       */
+      static constexpr bool is_deterministic = check_determinism();
+
+      /**
+       * \brief The table representing the automaton
+       */
+      static constexpr table_type value = make();
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_AUTOMATON_TABLE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the value representation of a deterministic automaton, used
+ * by algorithms that are too expensive to be expressed on types, as well as
+ * the way to obtain it from an automaton type
+ */
@@ -3,260 +3,183 @@
 
 #include "../../core/types.hpp"
 #include "../../sequences/sequence_traits.hpp"
-#include "../../sequences/algorithm.hpp"
+#include "../../sequences/sequence_types.hpp"
 #include "automaton_state_traits.hpp"
 #include "automaton_t_function_traits.hpp"
 #include "automaton_g_command_traits.hpp"
 
+#include <cstddef>
 #include <type_traits>
 
 namespace warp::spark::detail
 {
   /**
-   * \brief Internal traits class designed to recognize a group command
-   * sequence. This unspecialized sfinae friendly version is used when the
-   * specified type is not even a type sequence.
+   * \brief Validates the three sequences of an assumed automaton in a single
+   * instantiation. Each sequence is explored by fold expressions, thus, the
+   * instantiation depth does not depend on the size of the automaton. This
+   * unspecialized sfinae friendly version is used when one of the specified
+   * types is not even a type sequence.
    */
-  template< class, class = sfinae_type_t<> >
-    struct g_command_sequence_traits
+  template< class, class, class, class = sfinae_type_t<> >
+    struct automaton_validation
     {
       /**
-       * \brief Template parameter is not even a type sequence, thus, it connot
-       * be a group command sequence.
+       * \brief Not a sequence, nothing to count
        */
-      static constexpr bool is_g_command_sequence = false;
-    };
+      static constexpr std::size_t initial_state_count = 0;
 
-  /**
-   * \brief Specialization dealing with at least a type sequence, assumed to
-   * contain only group commands
-   *
-   * \tparam A type sequence assumed to contain group commands
-   */
-  template< class G_COMMAND_SEQUENCE >
-    struct g_command_sequence_traits
-    <
-      G_COMMAND_SEQUENCE,
-      sfinae_type_t
-        <
-          std::enable_if_t
-            < meta_sequence_traits< G_COMMAND_SEQUENCE >::is_type_sequence >
-        >
-    >
-    {
-    private :
       /**
-       * \brief A static predicate indicating if the specified type is an
-       * automaton group command
-       *
-       * \tparam T an explored type in a type sequence
+       * \brief Not a sequence, nothing to count
        */
-      template< class T >
-        struct is_g_command
-        {
-          /**
-           * \brief Relying on a specific traits class for automaton group
-           * command type
-           */
-          static constexpr auto value =
-            automaton_g_command_traits< T >::is_automaton_g_command;
-        };
+      static constexpr std::size_t final_state_count = 0;
 
-    public :
       /**
-       * \brief Some static computation ensuring first the sequence is not empty
-       * then, each element in the sequence is an automaton group command
+       * \brief Not an automaton state sequence
        */
-      static constexpr auto is_g_command_sequence =
-        ! is_empty_sequence< G_COMMAND_SEQUENCE >::value &&
-        (
-          std::is_same
-            <
-              G_COMMAND_SEQUENCE,
-              find_all_in_type_sequence_t< G_COMMAND_SEQUENCE, is_g_command >
-            >::value
-        );
-    };
-
-  /**
-   * \brief Meta functor designed to work on a type sequence containing
-   * automaton states. For each state explored, two internal counter may be
-   * updated. This functor exposes a counter for initial and final states.
-   * Unspecialized version used as declaration.
-   */
-  template< class, class... >
-    struct count_required_states;
+      static constexpr bool is_state_sequence = false;
 
-  /**
-   * \brief Specialization working for the first element explored in the
-   * sequence, initializes counters to zero.
-   *
-   * \tparam STATE the currently explored type of the sequence, assumed to be an
-   * automaton state
-   */
-  template< class STATE >
-    struct count_required_states< STATE >
-    {
       /**
-       * \brief Counter for initial state. A valid automaton has only one
-       * initial state
+       * \brief Not a transition function sequence
        */
-      static constexpr size_t initial_state_count = 0;
+      static constexpr bool is_t_function_sequence = false;
 
       /**
-       * \brief Counter for final states. A valid automaton has at least one
-       * final state.
+       * \brief Not a group command sequence
        */
-      static constexpr size_t final_state_count = 0;
+      static constexpr bool is_g_command_sequence = false;
 
       /**
-       * \brief Type exposed for the next computation occurring on the next
-       * element of the sequence. A check is made to ensure STATE is a valid
-       * state. If not, a specific specialization of this functor is used to
-       * break the recursion, and discard the sequence
+       * \brief Not an automaton
        */
-      using next =
-        std::conditional_t
-        <
-          automaton_state_traits< STATE >::is_automaton_state,
-          // valid automaton state, continue recursion
-          count_required_states
-            <
-              ignore,
-              std::integral_constant< size_t, initial_state_count >,
-              std::integral_constant< size_t, final_state_count >
-            >,
-          // not an automaton state, break by invoking specific specialization
-          count_required_states
-            <
-              ignore,
-              std::integral_constant< size_t, 2 >,
-              std::integral_constant< size_t, 0 >
-            >
-        >;
+      static constexpr bool is_automaton = false;
     };
 
   /**
-   * \brief Specialization used for all elements in a state sequence but the
-   * first. All element in the sequence explored so far are valid automaton
-   * states.
+   * \brief Specialization dealing with three type sequences, assumed to
+   * contain automaton states, transition functions and group commands
    *
-   * \tparam STATE the currently explored type in the type sequence
-   * \tparam INITIAL value of the initial state counter
-   * \tparam FINAL value of the final state counter
+   * \tparam STATE_SEQUENCE a type sequence template
+   * \tparam STATES types assumed to be automaton states
+   * \tparam T_FUNCTION_SEQUENCE a type sequence template
+   * \tparam T_FUNCTIONS types assumed to be transition functions
+   * \tparam G_COMMAND_SEQUENCE a type sequence template
+   * \tparam G_COMMANDS types assumed to be group commands
    */
-  template< class STATE, std::size_t INITIAL, std::size_t FINAL >
-    struct count_required_states
+  template
+    <
+      template< class... > class STATE_SEQUENCE, class... STATES,
+      template< class... > class T_FUNCTION_SEQUENCE, class... T_FUNCTIONS,
+      template< class... > class G_COMMAND_SEQUENCE, class... G_COMMANDS
+    >
+    struct automaton_validation
     <
-      STATE,
-      std::integral_constant< std::size_t, INITIAL >,
-      std::integral_constant< std::size_t, FINAL >
+      STATE_SEQUENCE< STATES... >,
+      T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+      G_COMMAND_SEQUENCE< G_COMMANDS... >,
+      // ok, type sequences evaluated
+      sfinae_type_t
+        <
+          std::enable_if_t
+            <
+              meta_sequence_traits< STATE_SEQUENCE< STATES... > >::
+                is_type_sequence &&
+              meta_sequence_traits< T_FUNCTION_SEQUENCE< T_FUNCTIONS... > >::
+                is_type_sequence &&
+              meta_sequence_traits< G_COMMAND_SEQUENCE< G_COMMANDS... > >::
+                is_type_sequence
+            >
+        >
     >
     {
       /**
-       * \brief initializes the initial counter regarding template parameters
+       * \brief The number of initial states. A valid automaton has only one
+       * initial state
        */
-      static constexpr auto initial_state_count = INITIAL;
+      static constexpr std::size_t initial_state_count =
+        ( std::size_t { 0 } + ... +
+          ( automaton_state_traits< STATES >::is_initial ? 1 : 0 ) );
 
       /**
-       * \brief initializes the final counter regarding template parameters
+       * \brief The number of final states. A valid automaton has at least one
+       * final state
        */
-      static constexpr auto final_state_count = FINAL;
+      static constexpr std::size_t final_state_count =
+        ( std::size_t { 0 } + ... +
+          ( automaton_state_traits< STATES >::is_final ? 1 : 0 ) );
 
       /**
-       * \brief So far, the exploration shown the sequence contain only valid
-       * automaton states.
+       * \brief Each element must be an automaton state, with exactly one
+       * initial state and at least one final state
        */
-      using next =
-        std::conditional_t
-        <
-          automaton_state_traits< STATE >::is_automaton_state,
-          // automaton state explored, going ahead, incrementing counters if
-          // necessary
-          count_required_states
-            <
-              ignore,
-              std::integral_constant
-                <
-                  std::size_t,
-                  INITIAL +
-                    automaton_state_traits< STATE >::is_initial ? 1 : 0
-                >,
-              std::integral_constant
-                <
-                  std::size_t,
-                  FINAL +
-                    automaton_state_traits< STATE >::is_final ? 1 : 0
-                >
-            >,
-          // type explored is not an automaton state, using the specific
-          // specialization breaking the recursion
-          count_required_states
-            <
-              ignore,
-              std::integral_constant< size_t, 2 >,
-              std::integral_constant< size_t, 0 >
-            >
-        >;
-    };
+      static constexpr bool is_state_sequence =
+        ( automaton_state_traits< STATES >::is_automaton_state && ... ) &&
+        ( initial_state_count == 1 ) &&
+        ( final_state_count > 0 );
 
-  /**
-   * \brief Specific specialization breaking the exploration. Indeed, as soon as
-   * two initial states have been discovered, the automaton state sequence is
-   * invalid and it is not necessary to explore anymore
-   *
-   * \tparam FINAL current value of the final state counter. Doesn't matter
-   * here, the sequence will be discarded
-   */
-  template< std::size_t FINAL >
-    struct count_required_states
-    <
-      ignore,
-      std::integral_constant< std::size_t, 2 >,
-      std::integral_constant< std::size_t, FINAL >
-    >
-    {
       /**
-       * \brief Two initial state give an invalid automaton
+       * \brief Each element must be a transition function
        */
-      static constexpr auto initial_state_count = 2;
+      static constexpr bool is_t_function_sequence =
+        ( automaton_t_function_traits< T_FUNCTIONS >::is_automaton_t_function
+          && ... );
 
       /**
-       * \brief If an automaton does not have at least one final state, it's
-       * invalid
+       * \brief The sequence must not be empty and each element must be a
+       * group command
        */
-      static constexpr auto final_state_count = 0;
+      static constexpr bool is_g_command_sequence =
+        ( sizeof...( G_COMMANDS ) != 0 ) &&
+        ( automaton_g_command_traits< G_COMMANDS >::is_automaton_g_command
+          && ... );
 
       /**
-       * \brief The stop type, exposing the result of an invalid automaton state
-       * and breaking sequence iteration
+       * \brief Validity of the automaton made of the three sequences
        */
-      using stop =
-        count_required_states
-        <
-          ignore,
-          // two initial states
-          std::integral_constant< std::size_t, 2 >,
-          // zero final state
-          std::integral_constant< std::size_t, 0 >
-        >;
+      static constexpr bool is_automaton =
+        is_state_sequence && is_t_function_sequence && is_g_command_sequence;
     };
 
   /**
-   * \brief Meta predicate designed to be used on a type sequence, looking for a
-   * non automaton transition function type.
+   * \brief Internal traits class designed to recognize a group command
+   * sequence. This unspecialized sfinae friendly version is used when the
+   * specified type is not even a type sequence.
+   */
+  template< class, class = sfinae_type_t<> >
+    struct g_command_sequence_traits
+    {
+      /**
+       * \brief Template parameter is not even a type sequence, thus, it connot
+       * be a group command sequence.
+       */
+      static constexpr bool is_g_command_sequence = false;
+    };
+
+  /**
+   * \brief Specialization dealing with at least a type sequence, assumed to
+   * contain only group commands
    *
-   * \tparam T A type inside a type sequence
+   * \tparam G_COMMAND_SEQUENCE a type sequence assumed to contain group
+   * commands
    */
-  template< class T >
-    struct not_an_automaton_t_function
+  template< class G_COMMAND_SEQUENCE >
+    struct g_command_sequence_traits
+    <
+      G_COMMAND_SEQUENCE,
+      sfinae_type_t
+        <
+          std::enable_if_t
+            < meta_sequence_traits< G_COMMAND_SEQUENCE >::is_type_sequence >
+        >
+    >
     {
       /**
-       * \brief Using the currently explored type in a automaton transition
-       * function traits class
+       * \brief The sequence is not empty and each element in the sequence is
+       * an automaton group command
        */
-      static constexpr auto value =
-        ! automaton_t_function_traits< T >::is_automaton_t_function;
+      static constexpr auto is_g_command_sequence =
+        automaton_validation
+          < type_sequence<>, type_sequence<>, G_COMMAND_SEQUENCE >::
+          is_g_command_sequence;
     };
 
   /**
@@ -264,7 +187,7 @@ namespace warp::spark::detail
    * This unspecialized version works with a type that is not even a type
    * sequence.
    */
-  template< class, class = warp::sfinae_type_t<> >
+  template< class, class = sfinae_type_t<> >
     struct state_sequence_traits
     {
       /**
@@ -278,6 +201,8 @@ namespace warp::spark::detail
    * remains however to check the content of the sequence as a valid automaton
    * state sequence must contains at least two states amongst it must be an
    * initial state and at least one final state.
+   *
+   * \tparam T a type sequence assumed to contain automaton states
    */
   template< class T >
     struct state_sequence_traits
@@ -288,22 +213,13 @@ namespace warp::spark::detail
         < std::enable_if_t< meta_sequence_traits< T >::is_type_sequence > >
     >
     {
-    private :
-      /**
-       * \brief Not an exposed trait but, contains information about how many
-       * initial and final states there is in the sequence
-       */
-      using required_state_counter =
-        for_each_type_in_t< T, count_required_states >;
-
-    public :
       /**
        * \brief Trait indicating the state sequence is valid regarding the count
        * of initial and final states in the sequence
        */
       static constexpr auto is_state_sequence =
-      ( required_state_counter::initial_state_count == 1 ) &&
-      ( required_state_counter::final_state_count > 0 );
+        automaton_validation< T, type_sequence<>, type_sequence<> >::
+          is_state_sequence;
     };
 
   /**
@@ -324,7 +240,7 @@ namespace warp::spark::detail
    * \brief Specialization used when the specified type is a valid type
    * sequence. However, the content of the sequence has to be checked.
    *
-   * \tparam T a type sequence supposed to contain transtion function types
+   * \tparam T a type sequence assumed to contain transition functions
    */
   template< class T >
     struct t_function_sequence_traits
@@ -335,24 +251,13 @@ namespace warp::spark::detail
         < std::enable_if_t< meta_sequence_traits< T >::is_type_sequence > >
     >
     {
-    private :
-      /**
-       * \brief Not a trait, but looks for a type that isn't a transition
-       * function. If the sequence contains one element matching this predicate,
-       * the complete sequence is discarded and seen as invalid sequence of
-       * transition functions
-       */
-      using not_a_t_function_type =
-        find_first_in_type_sequence_t< T, not_an_automaton_t_function >;
-
-    public :
       /**
-       * \brief This trait depends of the type found when looking for a non
-       * transition function. If undefined_type, the sequence is considered as
-       * valid, otherwise, not.
+       * \brief Each element of the sequence must be a transition function, an
+       * empty sequence being valid
        */
       static constexpr auto is_t_function_sequence =
-        std::is_same< undefined_type, not_a_t_function_type >::value;
+        automaton_validation< type_sequence<>, T, type_sequence<> >::
+          is_t_function_sequence;
     };
 
   /**
@@ -366,6 +271,21 @@ namespace warp::spark::detail
        * \brief Specified type is not an automaton type
        */
       static constexpr bool is_automaton = false;
+
+      /**
+       * \brief Specified type is not an automaton type
+       */
+      using state_sequence = undefined_type;
+
+      /**
+       * \brief Specified type is not an automaton type
+       */
+      using t_function_sequence = undefined_type;
+
+      /**
+       * \brief Specified type is not an automaton type
+       */
+      using g_command_sequence = undefined_type;
     };
 
   /**
@@ -411,16 +331,48 @@ namespace warp::spark::detail
        * sequence
        */
       static constexpr auto is_automaton =
-        state_sequence_traits
-          < STATE_SEQUENCE< STATE_1, STATE_2, STATES... > >::
-          is_state_sequence &&
-        t_function_sequence_traits
-          < T_FUNCTION_SEQUENCE< T_FUNCTION_1, T_FUNCTIONS... > >::
-          is_t_function_sequence &&
-        g_command_sequence_traits
-          < G_COMMAND_SEQUENCE< G_COMMAND_1, G_COMMANDS... > >::
-          is_g_command_sequence;
+        automaton_validation
+        <
+          STATE_SEQUENCE< STATE_1, STATE_2, STATES... >,
+          T_FUNCTION_SEQUENCE< T_FUNCTION_1, T_FUNCTIONS... >,
+          G_COMMAND_SEQUENCE< G_COMMAND_1, G_COMMANDS... >
+        >::is_automaton;
 
+      /**
+       * \brief The state sequence of the automaton, exposed if the automaton
+       * is valid
+       */
+      using state_sequence =
+        std::conditional_t
+        <
+          is_automaton,
+          STATE_SEQUENCE< STATE_1, STATE_2, STATES... >,
+          undefined_type
+        >;
+
+      /**
+       * \brief The transition function sequence of the automaton, exposed if
+       * the automaton is valid
+       */
+      using t_function_sequence =
+        std::conditional_t
+        <
+          is_automaton,
+          T_FUNCTION_SEQUENCE< T_FUNCTION_1, T_FUNCTIONS... >,
+          undefined_type
+        >;
+
+      /**
+       * \brief The group command sequence of the automaton, exposed if the
+       * automaton is valid
+       */
+      using g_command_sequence =
+        std::conditional_t
+        <
+          is_automaton,
+          G_COMMAND_SEQUENCE< G_COMMAND_1, G_COMMANDS... >,
+          undefined_type
+        >;
     };
 }
 
@@ -0,0 +1,383 @@
+#ifndef _WARP_SPARK_DETAIL_BIT_SET_HPP_
+#define _WARP_SPARK_DETAIL_BIT_SET_HPP_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief A compile-time usable set of small integers, stored as bits. Used
+   * by automaton construction algorithms to represent sets of automaton
+   * states or sets of group commands
+   *
+   * \tparam CAPACITY the number of distinct values the set can hold, values
+   * range from 0 to CAPACITY - 1
+   */
+  template< std::size_t CAPACITY >
+    class bit_set
+    {
+    public :
+      /**
+       * \brief The number of distinct values the set can hold
+       */
+      static constexpr std::size_t capacity = CAPACITY;
+
+      /**
+       * \brief The number of words used to store the set
+       */
+      static constexpr std::size_t word_count =
+        CAPACITY == 0 ? 1 : ( CAPACITY + 63 ) / 64;
+
+      /**
+       * \brief Builds an empty set
+       */
+      constexpr bit_set() : words_ {} {}
+
+      /**
+       * \brief Adds a value in the set
+       *
+       * \param value the value to add
+       */
+      constexpr void insert( std::size_t value )
+      { words_[ value / 64 ] |= std::uint64_t { 1 } << ( value % 64 ); }
+
+      /**
+       * \brief Indicates if a value is part of this set
+       *
+       * \param value the value to look for
+       *
+       * \return true if the value is in the set, false otherwise
+       */
+      constexpr bool contains( std::size_t value ) const
+      { return ( words_[ value / 64 ] >> ( value % 64 ) ) & 1; }
+
+      /**
+       * \brief Indicates if the set does not contain any value
+       *
+       * \return true if the set is empty, false otherwise
+       */
+      constexpr bool empty() const
+      {
+        for( std::size_t i = 0; i < word_count; ++i )
+          if( words_[ i ] != 0 )
+            return false;
+
+        return true;
+      }
+
+      /**
+       * \brief Counts values of the set
+       *
+       * \return the number of values in the set
+       */
+      constexpr std::size_t size() const
+      {
+        std::size_t result = 0;
+
+        for( std::size_t i = 0; i < word_count; ++i )
+          for( auto word = words_[ i ]; word != 0; word &= word - 1 )
+            ++result;
+
+        return result;
+      }
+
+      /**
+       * \brief Indicates if all values of another set are in this one
+       *
+       * \param other the set that may be included in this one
+       *
+       * \return true if other is a subset of this set
+       */
+      constexpr bool includes( const bit_set &other ) const
+      {
+        for( std::size_t i = 0; i < word_count; ++i )
+          if( ( other.words_[ i ] & ~words_[ i ] ) != 0 )
+            return false;
+
+        return true;
+      }
+
+      /**
+       * \brief Adds all values of another set in this one
+       *
+       * \param other the set to merge in this one
+       *
+       * \return this set
+       */
+      constexpr bit_set &operator |= ( const bit_set &other )
+      {
+        for( std::size_t i = 0; i < word_count; ++i )
+          words_[ i ] |= other.words_[ i ];
+
+        return *this;
+      }
+
+      /**
+       * \brief Union of two sets
+       *
+       * \param other the set to merge with this one
+       *
+       * \return a set containing values of both sets
+       */
+      constexpr bit_set operator | ( const bit_set &other ) const
+      {
+        bit_set result = *this;
+
+        result |= other;
+
+        return result;
+      }
+
+      /**
+       * \brief Equality of two sets
+       *
+       * \param other the set to compare with this one
+       *
+       * \return true if both sets contain exactly the same values
+       */
+      constexpr bool operator == ( const bit_set &other ) const
+      {
+        for( std::size_t i = 0; i < word_count; ++i )
+          if( words_[ i ] != other.words_[ i ] )
+            return false;
+
+        return true;
+      }
+
+      /**
+       * \brief Inequality of two sets
+       *
+       * \param other the set to compare with this one
+       *
+       * \return true if sets differ by at least one value
+       */
+      constexpr bool operator != ( const bit_set &other ) const
+      { return ! ( *this == other ); }
+
+    private :
+      /**
+       * \brief Storage of the set, one bit per value
+       */
+      std::array< std::uint64_t, word_count > words_;
+    };
+
+  /**
+   * \brief A set of small integers stored as bits, whose capacity is chosen
+   * at run time. Used by run-time automaton construction algorithms where
+   * bit_set is used at compile time. Being allocator aware, sets stored in
+   * polymorphic containers share the memory resource of their container
+   */
+  class dynamic_bit_set
+  {
+  public :
+    /**
+     * \brief The allocator type of the set
+     */
+    using allocator_type = std::pmr::polymorphic_allocator< std::uint64_t >;
+
+    /**
+     * \brief Builds an empty set
+     *
+     * \param capacity the number of distinct values the set can hold
+     * \param allocator the allocator of the storage
+     */
+    explicit dynamic_bit_set
+    ( std::size_t capacity = 0, const allocator_type &allocator = {} ) :
+      words_( ( capacity + 63 ) / 64, allocator ) {}
+
+    /**
+     * \brief Builds an empty set without any capacity
+     *
+     * \param allocator the allocator of the storage
+     */
+    explicit dynamic_bit_set( const allocator_type &allocator ) :
+      words_( allocator ) {}
+
+    /**
+     * \brief Copies a set, the copy using another allocator
+     *
+     * \param other the copied set
+     * \param allocator the allocator of the copy
+     */
+    dynamic_bit_set
+    ( const dynamic_bit_set &other, const allocator_type &allocator ) :
+      words_( other.words_, allocator ) {}
+
+    /**
+     * \brief Moves a set, the result using another allocator
+     *
+     * \param other the moved set
+     * \param allocator the allocator of the result
+     */
+    dynamic_bit_set
+    ( dynamic_bit_set &&other, const allocator_type &allocator ) :
+      words_( std::move( other.words_ ), allocator ) {}
+
+    /**
+     * \brief Copies a set, using the default memory resource
+     */
+    dynamic_bit_set( const dynamic_bit_set & ) = default;
+
+    /**
+     * \brief Moves a set, keeping its allocator
+     */
+    dynamic_bit_set( dynamic_bit_set && ) = default;
+
+    /**
+     * \brief Copies values of a set, keeping the allocator of this set
+     *
+     * \return this set
+     */
+    dynamic_bit_set &operator = ( const dynamic_bit_set & ) = default;
+
+    /**
+     * \brief Moves values of a set, keeping the allocator of this set
+     *
+     * \return this set
+     */
+    dynamic_bit_set &operator = ( dynamic_bit_set && ) = default;
+
+    /**
+     * \brief Gives the allocator of the set
+     *
+     * \return the allocator of the storage
+     */
+    allocator_type get_allocator() const { return words_.get_allocator(); }
+
+    /**
+     * \brief Adds a value in the set
+     *
+     * \param value the value to add, lower than the capacity
+     */
+    void insert( std::size_t value )
+    { words_[ value / 64 ] |= std::uint64_t { 1 } << ( value % 64 ); }
+
+    /**
+     * \brief Tells if a value belongs to the set
+     *
+     * \param value the value to look for, lower than the capacity
+     *
+     * \return true if the value is in the set
+     */
+    bool contains( std::size_t value ) const
+    { return ( words_[ value / 64 ] >> ( value % 64 ) ) & 1; }
+
+    /**
+     * \brief Tells if the set is empty
+     *
+     * \return true if the set contains no value
+     */
+    bool empty() const
+    {
+      for( const auto word : words_ )
+        if( word != 0 )
+          return false;
+
+      return true;
+    }
+
+    /**
+     * \brief Counts values of the set
+     *
+     * \return the number of values in the set
+     */
+    std::size_t size() const
+    {
+      std::size_t result = 0;
+
+      for( auto word : words_ )
+        for( ; word != 0; word &= word - 1 )
+          ++result;
+
+      return result;
+    }
+
+    /**
+     * \brief Tells if all values of another set, of the same capacity,
+     * belong to this set
+     *
+     * \param other the other set
+     *
+     * \return true if other is a subset of this set
+     */
+    bool includes( const dynamic_bit_set &other ) const
+    {
+      for( std::size_t i = 0; i < words_.size(); ++i )
+        if( ( other.words_[ i ] & ~words_[ i ] ) != 0 )
+          return false;
+
+      return true;
+    }
+
+    /**
+     * \brief Adds all values of another set, of the same capacity
+     *
+     * \param other the set to merge in this one
+     *
+     * \return this set
+     */
+    dynamic_bit_set &operator |= ( const dynamic_bit_set &other )
+    {
+      for( std::size_t i = 0; i < words_.size(); ++i )
+        words_[ i ] |= other.words_[ i ];
+
+      return *this;
+    }
+
+    /**
+     * \brief Compares two sets of the same capacity
+     *
+     * \param other the set to compare with this one
+     *
+     * \return true if both sets contain the same values
+     */
+    bool operator == ( const dynamic_bit_set &other ) const
+    { return words_ == other.words_; }
+
+    /**
+     * \brief Compares two sets of the same capacity
+     *
+     * \param other the set to compare with this one
+     *
+     * \return true if sets differ by at least one value
+     */
+    bool operator != ( const dynamic_bit_set &other ) const
+    { return ! ( *this == other ); }
+
+    /**
+     * \brief Computes a hash of the set, equal sets having equal hashes
+     *
+     * \return the hash of the set
+     */
+    std::uint64_t hash() const
+    {
+      std::uint64_t result = 0;
+
+      for( const auto word : words_ )
+        result = ( result ^ word ) * 0x100000001b3u;
+
+      return result;
+    }
+
+  private :
+    /**
+     * \brief Storage of the set, one bit per value
+     */
+    std::pmr::vector< std::uint64_t > words_;
+  };
+}
+
+#endif // _WARP_SPARK_DETAIL_BIT_SET_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains bit sets used by automaton construction algorithms, at
+ * compile time and at run time
+ */
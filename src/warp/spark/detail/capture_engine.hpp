@@ -0,0 +1,349 @@
+#ifndef _WARP_SPARK_DETAIL_CAPTURE_ENGINE_HPP_
+#define _WARP_SPARK_DETAIL_CAPTURE_ENGINE_HPP_
+
+#include "automaton_g_command_types.hpp"
+#include "automaton_table.hpp"
+#include "compiled_grammar.hpp"
+#include "thompson_nfa.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Capture registers of a single parse, a span per group, updated by
+   * group commands met along the path of the parse
+   *
+   * \tparam GROUP_COUNT the number of groups of the grammar
+   */
+  template< std::size_t GROUP_COUNT >
+    struct capture_registers
+    {
+      /**
+       * \brief Applies a group command
+       *
+       * \param command the command to apply
+       * \param offset the offset of the letter being read, or of the end of
+       * the input
+       */
+      constexpr void apply( const command_entry &command, std::size_t offset )
+      {
+        switch( command.type )
+        {
+          case group_command_types::resetting :
+            begins[ command.group ] = ends[ command.group ] = offset;
+            matched[ command.group ] = false;
+            break;
+
+          case group_command_types::capturing :
+            ends[ command.group ] = offset + 1;
+            break;
+
+          case group_command_types::finishing :
+            matched[ command.group ] = true;
+            break;
+        }
+      }
+
+      /**
+       * \brief The offset of the first letter of each group
+       */
+      std::array< std::size_t, GROUP_COUNT > begins {};
+
+      /**
+       * \brief The offset after the last letter of each group
+       */
+      std::array< std::size_t, GROUP_COUNT > ends {};
+
+      /**
+       * \brief Indicates, for each group, if it is finished since its last
+       * reset
+       */
+      std::array< bool, GROUP_COUNT > matched {};
+    };
+
+  /**
+   * \brief Edges of a Thompson automaton grouped by source state. Edges of a
+   * state keep their construction order, which is their priority : the first
+   * alternative comes first and closures try one more iteration before
+   * leaving
+   *
+   * \tparam STATE_COUNT the number of states of the automaton
+   * \tparam EDGE_COUNT the number of edges of the automaton
+   */
+  template< std::size_t STATE_COUNT, std::size_t EDGE_COUNT >
+    struct capture_edge_order
+    {
+      /**
+       * \brief For each state, the index of its first edge in edges, the last
+       * entry being the number of edges
+       */
+      std::array< std::size_t, STATE_COUNT + 1 > offsets {};
+
+      /**
+       * \brief Edge indices, grouped by source state
+       */
+      std::array< std::size_t, EDGE_COUNT > edges {};
+    };
+
+  /**
+   * \brief Groups edges of a Thompson automaton by source state, keeping
+   * their priority
+   *
+   * \tparam NFA a Thompson automaton type
+   *
+   * \param nfa the automaton
+   *
+   * \return edges grouped by source state
+   */
+  template< class NFA >
+    constexpr capture_edge_order< NFA::state_capacity, NFA::edge_capacity >
+    order_capture_edges( const NFA &nfa )
+    {
+      capture_edge_order< NFA::state_capacity, NFA::edge_capacity > result;
+      std::array< std::size_t, NFA::state_capacity > next {};
+
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+        ++result.offsets[ nfa.edges[ e ].from + 1 ];
+
+      for( std::size_t s = 0; s < nfa.state_count; ++s )
+      {
+        result.offsets[ s + 1 ] += result.offsets[ s ];
+        next[ s ] = result.offsets[ s ];
+      }
+
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+        result.edges[ next[ nfa.edges[ e ].from ]++ ] = e;
+
+      return result;
+    }
+
+  /**
+   * \brief Pending parses of an input prefix, in priority order, at most one
+   * per automaton state. It is a literal type without any pointer, thus, it
+   * can be copied to resume a capture later
+   *
+   * \tparam STATE_COUNT the number of states of the automaton
+   * \tparam GROUP_COUNT the number of groups of the grammar
+   */
+  template< std::size_t STATE_COUNT, std::size_t GROUP_COUNT >
+    struct capture_threads
+    {
+      /**
+       * \brief The number of pending parses
+       */
+      std::size_t count = 0;
+
+      /**
+       * \brief The automaton state of each parse
+       */
+      std::array< std::size_t, STATE_COUNT > states {};
+
+      /**
+       * \brief The capture registers of each parse
+       */
+      std::array< capture_registers< GROUP_COUNT >, STATE_COUNT > registers {};
+    };
+
+  /**
+   * \brief Simulates the Thompson automaton of a grammar, carrying capture
+   * registers along each parse. Parses reaching a same state at a same
+   * offset are merged, the one of highest priority being kept, thus, the
+   * accepted parse is the leftmost greedy one and group commands of parses
+   * failing later are never seen. The cost is linear in the size of the
+   * input, each letter costing a step of every pending parse.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct capture_machine
+    {
+    private :
+      /**
+       * \brief The non deterministic form of the grammar, with commands
+       */
+      using thompson = thompson_grammar< GRAMMAR >;
+
+    public :
+      /**
+       * \brief The number of states of the automaton
+       */
+      static constexpr std::size_t state_count =
+        thompson::nfa_type::state_capacity;
+
+      /**
+       * \brief The number of groups of the grammar
+       */
+      static constexpr std::size_t group_count = thompson::nfa.group_count;
+
+      /**
+       * \brief The type of capture registers of a parse
+       */
+      using registers_type = capture_registers< group_count >;
+
+      /**
+       * \brief The type of pending parses
+       */
+      using threads_type = capture_threads< state_count, group_count >;
+
+      /**
+       * \brief Edges of the automaton grouped by source state
+       */
+      static constexpr auto order = order_capture_edges( thompson::nfa );
+
+      /**
+       * \brief Gives the pending parses of an empty input
+       *
+       * \return parses reaching a state without reading any letter
+       */
+      static constexpr threads_type start()
+      {
+        threads_type result;
+        std::array< bool, state_count > visited {};
+
+        add( result, visited, thompson::nfa.start, registers_type {}, 0 );
+
+        return result;
+      }
+
+      /**
+       * \brief Reads a letter, advancing all pending parses
+       *
+       * \param threads the pending parses, updated
+       * \param letter the letter to read
+       * \param offset the offset of the letter in the input
+       *
+       * \return false if no parse survives the letter
+       */
+      static constexpr bool step
+      ( threads_type &threads, unsigned char letter, std::size_t offset )
+      {
+        threads_type next;
+        std::array< bool, state_count > visited {};
+
+        for( std::size_t t = 0; t < threads.count; ++t )
+          for( auto e = order.offsets[ threads.states[ t ] ];
+               e < order.offsets[ threads.states[ t ] + 1 ];
+               ++e )
+          {
+            const auto &edge = thompson::nfa.edges[ order.edges[ e ] ];
+
+            if( edge.is_epsilon || ! edge.letters.contains( letter ) )
+              continue;
+
+            auto registers = threads.registers[ t ];
+
+            for( auto c = edge.command_begin; c < edge.command_end; ++c )
+              registers.apply( thompson::nfa.commands[ c ], offset );
+
+            add( next, visited, edge.to, registers, offset + 1 );
+          }
+
+        threads.count = next.count;
+
+        for( std::size_t t = 0; t < next.count; ++t )
+        {
+          threads.states[ t ] = next.states[ t ];
+          threads.registers[ t ] = next.registers[ t ];
+        }
+
+        return threads.count != 0;
+      }
+
+      /**
+       * \brief Gives the accepted parse of the input read so far
+       *
+       * \param threads the pending parses
+       *
+       * \return the registers of the parse of highest priority reaching the
+       * accepting state, nullptr if there is none
+       */
+      static constexpr const registers_type *accepted
+      ( const threads_type &threads )
+      {
+        for( std::size_t t = 0; t < threads.count; ++t )
+          if( threads.states[ t ] == thompson::nfa.accept )
+            return &threads.registers[ t ];
+
+        return nullptr;
+      }
+
+    private :
+      /**
+       * \brief Adds a parse reaching a state, then follows epsilon edges of
+       * the state in priority order. A state already reached at this offset
+       * is left as is, being reached by a parse of higher priority
+       *
+       * \param threads the parses to complete
+       * \param visited states already reached at this offset
+       * \param state the reached state
+       * \param registers the capture registers of the parse
+       * \param offset the offset of the next letter
+       */
+      static constexpr void add
+      (
+        threads_type &threads, std::array< bool, state_count > &visited,
+        std::size_t state, const registers_type &registers,
+        std::size_t offset
+      )
+      {
+        if( visited[ state ] )
+          return;
+
+        visited[ state ] = true;
+
+        bool is_pending = state == thompson::nfa.accept;
+
+        for( auto e = order.offsets[ state ];
+             e < order.offsets[ state + 1 ];
+             ++e )
+        {
+          const auto &edge = thompson::nfa.edges[ order.edges[ e ] ];
+
+          is_pending = is_pending || ! edge.is_epsilon;
+        }
+
+        // only parses able to read a letter or to accept are kept
+        if( is_pending )
+        {
+          threads.states[ threads.count ] = state;
+          threads.registers[ threads.count++ ] = registers;
+        }
+
+        for( auto e = order.offsets[ state ];
+             e < order.offsets[ state + 1 ];
+             ++e )
+        {
+          const auto &edge = thompson::nfa.edges[ order.edges[ e ] ];
+
+          if( ! edge.is_epsilon )
+            continue;
+
+          if( edge.command_begin == edge.command_end )
+          {
+            add( threads, visited, edge.to, registers, offset );
+
+            continue;
+          }
+
+          auto followed = registers;
+
+          for( auto c = edge.command_begin; c < edge.command_end; ++c )
+            followed.apply( thompson::nfa.commands[ c ], offset );
+
+          add( threads, visited, edge.to, followed, offset );
+        }
+      }
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_CAPTURE_ENGINE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the engine finding the leftmost greedy parse of an input,
+ * used to report capture spans consistent with each other
+ */
@@ -0,0 +1,399 @@
+#ifndef _WARP_SPARK_DETAIL_COMPACT_AUTOMATON_TABLE_HPP_
+#define _WARP_SPARK_DETAIL_COMPACT_AUTOMATON_TABLE_HPP_
+
+#include "../../core/numeric.hpp"
+#include "automaton_table.hpp"
+#include "automaton_minimization.hpp"
+#include "automaton_state_enumeration.hpp"
+#include "letter_classes.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Compressed value representation of a deterministic automaton.
+   * Letters are first mapped to their class, then a [states][classes] table
+   * gives the target state and the action of each transition. Each state also
+   * owns a final action, applied when the input ends in this state. Sizes are
+   * exact and each cell uses the smallest unsigned integral type able to hold
+   * its values, keeping hot tables small.
+   *
+   * \tparam STATE_COUNT the number of states of the automaton
+   * \tparam CLASS_COUNT the number of letter classes
+   * \tparam ACTION_COUNT the number of distinct actions, the empty one
+   * included
+   * \tparam COMMAND_COUNT the number of commands stored in all actions
+   */
+  template
+    <
+      std::size_t STATE_COUNT,
+      std::size_t CLASS_COUNT,
+      std::size_t ACTION_COUNT,
+      std::size_t COMMAND_COUNT
+    >
+    struct compact_automaton_table
+    {
+      static_assert( STATE_COUNT > 0 && CLASS_COUNT > 0 && ACTION_COUNT > 0,
+                     "Invalid table sizes. A compact automaton table needs at "
+                     "least a state, a letter class and the empty action." );
+
+      /**
+       * \brief Type of a cell containing a state, the no_state marker included
+       */
+      using state_type = unsigned_auto_constant_t< STATE_COUNT >;
+
+      /**
+       * \brief Type of a cell containing a letter class
+       */
+      using class_type = unsigned_auto_constant_t< CLASS_COUNT - 1 >;
+
+      /**
+       * \brief Type of a cell containing an action identifier
+       */
+      using action_type = unsigned_auto_constant_t< ACTION_COUNT - 1 >;
+
+      /**
+       * \brief Type of an offset in the command storage
+       */
+      using command_offset_type = unsigned_auto_constant_t< COMMAND_COUNT >;
+
+      /**
+       * \brief The number of states
+       */
+      static constexpr std::size_t state_count = STATE_COUNT;
+
+      /**
+       * \brief The number of letter classes, that is, the width of a row
+       */
+      static constexpr std::size_t class_count = CLASS_COUNT;
+
+      /**
+       * \brief The number of actions
+       */
+      static constexpr std::size_t action_count = ACTION_COUNT;
+
+      /**
+       * \brief The number of commands
+       */
+      static constexpr std::size_t command_count = COMMAND_COUNT;
+
+      /**
+       * \brief Marks a cell without any transition
+       */
+      static constexpr std::size_t no_state = STATE_COUNT;
+
+      /**
+       * \brief Identifier of the action containing no command
+       */
+      static constexpr std::size_t no_action = 0;
+
+      /**
+       * \brief Gets the target state of a transition, using a letter class
+       *
+       * \param state the source state
+       * \param klass the class of the letter read in the source state
+       *
+       * \return the target state or no_state if there is no transition
+       */
+      constexpr std::size_t class_target
+      ( std::size_t state, std::size_t klass ) const
+      { return targets[ state * CLASS_COUNT + klass ]; }
+
+      /**
+       * \brief Gets the action of a transition, using a letter class
+       *
+       * \param state the source state
+       * \param klass the class of the letter read in the source state
+       *
+       * \return the action identifier, no_action if nothing has to be done
+       */
+      constexpr std::size_t class_action
+      ( std::size_t state, std::size_t klass ) const
+      { return actions[ state * CLASS_COUNT + klass ]; }
+
+      /**
+       * \brief Gets the target state of a transition
+       *
+       * \param state the source state
+       * \param letter the letter read in the source state
+       *
+       * \return the target state or no_state if there is no transition
+       */
+      constexpr std::size_t target
+      ( std::size_t state, unsigned char letter ) const
+      { return class_target( state, classes[ letter ] ); }
+
+      /**
+       * \brief Gets the action attached to a transition
+       *
+       * \param state the source state
+       * \param letter the letter read in the source state
+       *
+       * \return the action identifier, no_action if nothing has to be done
+       */
+      constexpr std::size_t action
+      ( std::size_t state, unsigned char letter ) const
+      { return class_action( state, classes[ letter ] ); }
+
+      /**
+       * \brief Gets the first command of an action
+       *
+       * \param action an action identifier
+       *
+       * \return the index of the first command of the action
+       */
+      constexpr std::size_t action_begin( std::size_t action ) const
+      { return action_offsets[ action ]; }
+
+      /**
+       * \brief Gets the end of the command range of an action
+       *
+       * \param action an action identifier
+       *
+       * \return the index after the last command of the action
+       */
+      constexpr std::size_t action_end( std::size_t action ) const
+      { return action_offsets[ action + 1 ]; }
+
+      /**
+       * \brief Index of the initial state
+       */
+      std::size_t initial_state = 0;
+
+      /**
+       * \brief The number of distinct groups commands are working on
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief The class of each letter
+       */
+      std::array< class_type, letter_set::letter_count > classes {};
+
+      /**
+       * \brief Indicates, for each state, if it is final
+       */
+      std::array< bool, STATE_COUNT > final_states {};
+
+      /**
+       * \brief The action applied when the input ends in a final state
+       */
+      std::array< action_type, STATE_COUNT > final_actions {};
+
+      /**
+       * \brief The type of each state. Dead and always final states are
+       * precomputed, allowing runs to stop as soon as their outcome is known
+       */
+      std::array< state_types, STATE_COUNT > types {};
+
+      /**
+       * \brief Target state of each cell
+       */
+      std::array< state_type, STATE_COUNT * CLASS_COUNT > targets {};
+
+      /**
+       * \brief Action of each cell
+       */
+      std::array< action_type, STATE_COUNT * CLASS_COUNT > actions {};
+
+      /**
+       * \brief Command ranges of actions. Commands of the action a are located
+       * between action_offsets[ a ] and action_offsets[ a + 1 ]
+       */
+      std::array< command_offset_type, ACTION_COUNT + 1 > action_offsets {};
+
+      /**
+       * \brief Storage for commands of all actions
+       */
+      std::array< command_entry, COMMAND_COUNT > commands {};
+    };
+
+  /**
+   * \brief Computes the type of each state of a compact table. A state is
+   * dead when no final state can be reached from it, always final when it is
+   * final and all its transitions, on every letter class, lead to always
+   * final states. Both sets are fixed points, computed by iterating over the
+   * table until nothing changes.
+   *
+   * \tparam COMPACT_TABLE a compact automaton table type
+   *
+   * \param table the table whose types are computed
+   */
+  template< class COMPACT_TABLE >
+    constexpr void classify_states( COMPACT_TABLE &table )
+    {
+      constexpr auto state_count = COMPACT_TABLE::state_count;
+      constexpr auto class_count = COMPACT_TABLE::class_count;
+
+      // growing the set of states leading to a final state
+      std::array< bool, state_count > live = table.final_states;
+
+      for( bool is_changed = true; is_changed; )
+      {
+        is_changed = false;
+
+        for( std::size_t s = 0; s < state_count; ++s )
+          for( std::size_t c = 0; c < class_count && ! live[ s ]; ++c )
+          {
+            const auto target = table.class_target( s, c );
+
+            if( target != COMPACT_TABLE::no_state && live[ target ] )
+              is_changed = live[ s ] = true;
+          }
+      }
+
+      // shrinking the set of final states staying final whatever is read
+      std::array< bool, state_count > always = table.final_states;
+
+      for( bool is_changed = true; is_changed; )
+      {
+        is_changed = false;
+
+        for( std::size_t s = 0; s < state_count; ++s )
+          for( std::size_t c = 0; c < class_count && always[ s ]; ++c )
+          {
+            const auto target = table.class_target( s, c );
+
+            if( target == COMPACT_TABLE::no_state || ! always[ target ] )
+            {
+              always[ s ] = false;
+              is_changed = true;
+            }
+          }
+      }
+
+      for( std::size_t s = 0; s < state_count; ++s )
+      {
+        const auto is_initial = s == table.initial_state;
+        const auto is_final = table.final_states[ s ];
+
+        table.types[ s ] =
+          ! live[ s ] ? state_types::dead :
+          always[ s ] ? state_types::always_final :
+          is_initial && is_final ? state_types::initial_and_final :
+          is_initial ? state_types::initial :
+          is_final ? state_types::final :
+          state_types::intermediate;
+      }
+    }
+
+  /**
+   * \brief Compresses an automaton table, keeping only meaningful rows and
+   * columns and narrowing each cell to the type used by the compact table.
+   *
+   * \tparam COMPACT_TABLE the resulting compact table type, whose sizes must
+   * match the source table
+   * \tparam TABLE the source automaton table type
+   *
+   * \param table the automaton table to compress
+   *
+   * \return the compressed table
+   */
+  template< class COMPACT_TABLE, class TABLE >
+    constexpr COMPACT_TABLE compress_automaton_table( const TABLE &table )
+    {
+      using state_type = typename COMPACT_TABLE::state_type;
+      using class_type = typename COMPACT_TABLE::class_type;
+      using action_type = typename COMPACT_TABLE::action_type;
+      using command_offset_type = typename COMPACT_TABLE::command_offset_type;
+
+      COMPACT_TABLE result;
+
+      result.initial_state = table.initial_state;
+      result.group_count = table.group_count;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        result.classes[ l ] =
+          static_cast< class_type >( table.classes.class_of[ l ] );
+
+      for( std::size_t s = 0; s < COMPACT_TABLE::state_count; ++s )
+      {
+        result.final_states[ s ] = table.final_states[ s ];
+        result.final_actions[ s ] =
+          static_cast< action_type >( table.final_actions[ s ] );
+
+        for( std::size_t c = 0; c < COMPACT_TABLE::class_count; ++c )
+        {
+          const auto target = table.class_target( s, c );
+          const auto cell = s * COMPACT_TABLE::class_count + c;
+
+          result.targets[ cell ] =
+            static_cast< state_type >
+              ( target == TABLE::no_state ? COMPACT_TABLE::no_state : target );
+          result.actions[ cell ] =
+            static_cast< action_type >( table.class_action( s, c ) );
+        }
+      }
+
+      for( std::size_t a = 0; a <= COMPACT_TABLE::action_count; ++a )
+        result.action_offsets[ a ] =
+          static_cast< command_offset_type >( table.action_offsets[ a ] );
+
+      for( std::size_t c = 0; c < COMPACT_TABLE::command_count; ++c )
+        result.commands[ c ] = table.commands[ c ];
+
+      classify_states( result );
+
+      return result;
+    }
+
+  /**
+   * \brief Builds the exactly sized compact table type able to hold an
+   * automaton table
+   *
+   * \tparam TABLE an automaton table
+   */
+  template< const auto &TABLE >
+    using compact_automaton_table_for =
+      compact_automaton_table
+      <
+        TABLE.state_count,
+        TABLE.classes.class_count,
+        TABLE.action_count,
+        TABLE.command_count
+      >;
+
+  /**
+   * \brief Minimizes and compresses an automaton type. Letter classes are
+   * computed from symbols used by transition functions and the minimal table
+   * is reduced to a column per class.
+   *
+   * \tparam AUTOMATON a valid and deterministic automaton type
+   */
+  template< class AUTOMATON >
+    struct compact_automaton
+    {
+      /**
+       * \brief The minimization of the automaton
+       */
+      using minimization = automaton_minimization< AUTOMATON >;
+
+      /**
+       * \brief The letter partition of the automaton
+       */
+      static constexpr letter_classes classes = minimization::table.classes;
+
+      /**
+       * \brief The type of the compact table, with exact sizes
+       */
+      using table_type = compact_automaton_table_for< minimization::table >;
+
+      /**
+       * \brief The compact table of the minimal automaton
+       */
+      static constexpr table_type table =
+        compress_automaton_table< table_type >( minimization::table );
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_COMPACT_AUTOMATON_TABLE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compressed form of automaton tables, using letter
+ * equivalence classes and exactly sized cells
+ */
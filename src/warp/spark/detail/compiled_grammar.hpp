@@ -0,0 +1,349 @@
+#ifndef _WARP_SPARK_DETAIL_COMPILED_GRAMMAR_HPP_
+#define _WARP_SPARK_DETAIL_COMPILED_GRAMMAR_HPP_
+
+#include "automaton_minimization.hpp"
+#include "automaton_table.hpp"
+#include "compact_automaton_table.hpp"
+#include "group_node_table.hpp"
+#include "group_simplification.hpp"
+#include "letter_classes.hpp"
+#include "subset_construction.hpp"
+#include "thompson_nfa.hpp"
+
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Non deterministic form of a grammar, expressed as a group tree.
+   * The group tree is flattened into a group node table sharing identical
+   * subtrees, then a Thompson automaton is built from it and letter classes
+   * are computed from symbols of the grammar. Everything is done at compile
+   * time.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct thompson_grammar
+    {
+      /**
+       * \brief The flattened group tree, identical subtrees being shared
+       */
+      static constexpr auto nodes = group_dag_from< GRAMMAR >::value;
+
+      /**
+       * \brief Exact sizes of the Thompson automaton
+       */
+      static constexpr thompson_nfa_size nfa_size =
+        measure_thompson_nfa( nodes );
+
+      /**
+       * \brief The type of the Thompson automaton
+       */
+      using nfa_type =
+        thompson_nfa
+        <
+          nfa_size.state_count,
+          nfa_size.edge_count,
+          nfa_size.command_count
+        >;
+
+      /**
+       * \brief The Thompson automaton of the grammar
+       */
+      static constexpr nfa_type nfa = build_thompson_nfa< nfa_type >( nodes );
+
+      /**
+       * \brief The letter partition of the grammar
+       */
+      static constexpr letter_classes classes = nodes.classes();
+    };
+
+  /**
+   * \brief Non deterministic form of a grammar used for recognition only.
+   * The flattened group tree is simplified first, then the Thompson automaton
+   * built from it is stripped of its commands. Fewer closures give fewer
+   * states and epsilon transitions, and the lack of commands lets
+   * minimization merge more states.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct simplified_thompson_grammar
+    {
+      /**
+       * \brief The simplified group tree, without any group
+       */
+      static constexpr auto nodes =
+        simplify_group_nodes( group_dag_from< GRAMMAR >::value );
+
+      /**
+       * \brief Exact sizes of the Thompson automaton
+       */
+      static constexpr thompson_nfa_size nfa_size =
+        measure_thompson_nfa( nodes );
+
+      /**
+       * \brief The type of the Thompson automaton, without commands
+       */
+      using nfa_type =
+        thompson_nfa< nfa_size.state_count, nfa_size.edge_count, 0 >;
+
+      /**
+       * \brief The Thompson automaton of the simplified grammar
+       */
+      static constexpr nfa_type nfa =
+        strip_thompson_commands< nfa_type >
+          ( build_thompson_nfa
+            <
+              thompson_nfa
+              <
+                nfa_size.state_count,
+                nfa_size.edge_count,
+                nfa_size.command_count
+              >
+            >( nodes ) );
+
+      /**
+       * \brief The letter partition of the simplified grammar
+       */
+      static constexpr letter_classes classes = nodes.classes();
+    };
+
+  /**
+   * \brief Unanchored form of the simplified Thompson automaton of a grammar,
+   * looping on its start state on any letter, used to find where the first
+   * match of a search ends in a single pass
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct unanchored_thompson_grammar
+    {
+    private :
+      /**
+       * \brief Shortcut to the anchored form of the grammar
+       */
+      using anchored = simplified_thompson_grammar< GRAMMAR >;
+
+    public :
+      /**
+       * \brief Exact sizes of the Thompson automaton, with the looping edge
+       */
+      static constexpr thompson_nfa_size nfa_size
+      {
+        anchored::nfa_size.state_count, anchored::nfa_size.edge_count + 1, 0
+      };
+
+      /**
+       * \brief The type of the Thompson automaton, without commands
+       */
+      using nfa_type =
+        thompson_nfa< nfa_size.state_count, nfa_size.edge_count, 0 >;
+
+      /**
+       * \brief The unanchored Thompson automaton of the simplified grammar
+       */
+      static constexpr nfa_type nfa =
+        unanchor_thompson_nfa< nfa_type >( anchored::nfa );
+
+      /**
+       * \brief The letter partition of the simplified grammar
+       */
+      static constexpr letter_classes classes = anchored::classes;
+    };
+
+  /**
+   * \brief Reversed form of the simplified Thompson automaton of a grammar,
+   * reading inputs backward, used to find where a match of a search begins
+   * once its end is known
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct reversed_thompson_grammar
+    {
+    private :
+      /**
+       * \brief Shortcut to the forward form of the grammar
+       */
+      using forward = simplified_thompson_grammar< GRAMMAR >;
+
+    public :
+      /**
+       * \brief Exact sizes of the Thompson automaton
+       */
+      static constexpr thompson_nfa_size nfa_size = forward::nfa_size;
+
+      /**
+       * \brief The type of the Thompson automaton, without commands
+       */
+      using nfa_type = typename forward::nfa_type;
+
+      /**
+       * \brief The reversed Thompson automaton of the simplified grammar
+       */
+      static constexpr nfa_type nfa =
+        reverse_thompson_nfa< nfa_type >( forward::nfa );
+
+      /**
+       * \brief The letter partition of the simplified grammar
+       */
+      static constexpr letter_classes classes = forward::classes;
+    };
+
+  /**
+   * \brief Compiles the non deterministic form of a grammar into a compact
+   * automaton table. The whole pipeline runs at compile time :
+   * - the Thompson automaton is determinized, within a state budget
+   * - the deterministic automaton is minimized then compressed
+   *
+   * \tparam THOMPSON the non deterministic form of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class THOMPSON, std::size_t STATE_BUDGET >
+    struct basic_compiled_grammar : THOMPSON
+    {
+    private :
+      /**
+       * \brief Shortcut to the non deterministic form of the grammar
+       */
+      using thompson = THOMPSON;
+
+    public :
+      /**
+       * \brief The type of the subset automaton
+       */
+      using subset_type =
+        subset_automaton
+        <
+          STATE_BUDGET,
+          thompson::classes.class_count,
+          thompson::nfa_size.state_count,
+          3 * thompson::nfa.group_count
+        >;
+
+      /**
+       * \brief The determinized automaton
+       */
+      static constexpr subset_type subset =
+        determinize< subset_type >( thompson::nfa, thompson::classes );
+
+      static_assert( subset.is_complete,
+                     "Invalid grammar used. The deterministic automaton of "
+                     "the grammar exceeds the state budget." );
+
+      /**
+       * \brief Exact sizes of the action storage
+       */
+      static constexpr subset_action_size action_size =
+        measure_subset_actions( subset );
+
+      /**
+       * \brief The type of the deterministic automaton table
+       */
+      using dfa_type =
+        automaton_table
+        <
+          subset.state_count,
+          thompson::classes.class_count,
+          action_size.action_count,
+          action_size.command_count
+        >;
+
+      /**
+       * \brief The deterministic automaton table
+       */
+      static constexpr dfa_type dfa =
+        subset_to_automaton_table< dfa_type >( subset, thompson::classes );
+
+      /**
+       * \brief The minimal automaton table
+       */
+      static constexpr dfa_type minimal = minimize_automaton_table( dfa );
+
+      /**
+       * \brief The type of the compact table, with exact sizes
+       */
+      using table_type = compact_automaton_table_for< minimal >;
+
+      /**
+       * \brief The compact table of the grammar
+       */
+      static constexpr table_type table =
+        compress_automaton_table< table_type >( minimal );
+
+      /**
+       * \brief State and transition counts before and after minimization
+       */
+      static constexpr automaton_statistics statistics
+      {
+        dfa.state_count, minimal.state_count,
+        dfa.transition_count(), minimal.transition_count()
+      };
+    };
+
+  /**
+   * \brief Compiles a grammar, expressed as a group tree, into a compact
+   * automaton table reporting group commands, used by transcription
+   * algorithms
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    struct compiled_grammar :
+      basic_compiled_grammar< thompson_grammar< GRAMMAR >, STATE_BUDGET > {};
+
+  /**
+   * \brief Compiles a grammar into a compact automaton table without any
+   * command, from its simplified form, used by recognition algorithms
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    struct recognition_grammar :
+      basic_compiled_grammar
+        < simplified_thompson_grammar< GRAMMAR >, STATE_BUDGET > {};
+
+  /**
+   * \brief Compiles a grammar into a compact automaton table without any
+   * command, reaching a final state each time a match ends, wherever it
+   * begins, used by search algorithms
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    struct unanchored_recognition_grammar :
+      basic_compiled_grammar
+        < unanchored_thompson_grammar< GRAMMAR >, STATE_BUDGET > {};
+
+  /**
+   * \brief Compiles a grammar into a compact automaton table without any
+   * command, recognizing inputs read backward, used by search algorithms
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    struct reversed_recognition_grammar :
+      basic_compiled_grammar
+        < reversed_thompson_grammar< GRAMMAR >, STATE_BUDGET > {};
+}
+
+#endif // _WARP_SPARK_DETAIL_COMPILED_GRAMMAR_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compile-time pipeline turning a grammar into a compact
+ * automaton table
+ */
@@ -0,0 +1,638 @@
+#ifndef _WARP_SPARK_DETAIL_EPSILON_ELIMINATION_HPP_
+#define _WARP_SPARK_DETAIL_EPSILON_ELIMINATION_HPP_
+
+#include "automaton_g_command_traits.hpp"
+#include "automaton_state_traits.hpp"
+#include "automaton_t_function_traits.hpp"
+#include "automaton_table.hpp"
+#include "automaton_traits.hpp"
+#include "bit_set.hpp"
+#include "compiled_grammar.hpp"
+#include "letter_classes.hpp"
+#include "letter_set.hpp"
+#include "subset_construction.hpp"
+#include "thompson_nfa.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief An edge of an epsilon free automaton, consuming a letter of its
+   * letter set and applying a set of commands
+   *
+   * \tparam COMMAND_SET a bit set type
+   */
+  template< class COMMAND_SET >
+    struct epsilon_free_edge
+    {
+      /**
+       * \brief The source state
+       */
+      std::size_t from;
+
+      /**
+       * \brief The target state
+       */
+      std::size_t to;
+
+      /**
+       * \brief Letters consumed by the edge
+       */
+      letter_set letters;
+
+      /**
+       * \brief Commands applied when the edge is followed, commands met on
+       * removed epsilon paths included, encoded as in subset_automaton
+       */
+      COMMAND_SET commands;
+    };
+
+  /**
+   * \brief Sizes of an epsilon free automaton, computed before its
+   * construction to allocate an exactly sized automaton
+   */
+  struct epsilon_free_size
+  {
+    /**
+     * \brief The number of states reachable from the start state
+     */
+    std::size_t state_count;
+
+    /**
+     * \brief The number of edges leaving reachable states
+     */
+    std::size_t edge_count;
+  };
+
+  /**
+   * \brief A non deterministic automaton without any epsilon transition.
+   * Several states may be final, each final state owning the commands to
+   * apply when the input ends there. Engines simulating it step only on
+   * letters, without computing any closure.
+   *
+   * \tparam STATE_CAPACITY the maximum number of states
+   * \tparam EDGE_CAPACITY the maximum number of edges
+   * \tparam COMMAND_BIT_COUNT the number of distinct commands
+   */
+  template
+    <
+      std::size_t STATE_CAPACITY,
+      std::size_t EDGE_CAPACITY,
+      std::size_t COMMAND_BIT_COUNT
+    >
+    struct epsilon_free_nfa
+    {
+      /**
+       * \brief Type of a set of commands
+       */
+      using command_set_type = bit_set< COMMAND_BIT_COUNT >;
+
+      /**
+       * \brief Type of a set of states
+       */
+      using state_set_type = bit_set< STATE_CAPACITY >;
+
+      /**
+       * \brief Exposes the state capacity
+       */
+      static constexpr std::size_t state_capacity = STATE_CAPACITY;
+
+      /**
+       * \brief Exposes the edge capacity
+       */
+      static constexpr std::size_t edge_capacity = EDGE_CAPACITY;
+
+      /**
+       * \brief Follows all edges leaving active states for a set of letters
+       * sharing a same behavior. No closure is computed, epsilon paths being
+       * already folded into edges.
+       *
+       * \param active the active states
+       * \param letters letters of a letter class
+       * \param next receives target states
+       * \param action receives commands of followed edges
+       */
+      constexpr void step
+      (
+        const state_set_type &active, const letter_set &letters,
+        state_set_type &next, command_set_type &action
+      ) const
+      {
+        for( std::size_t e = 0; e < edge_count; ++e )
+        {
+          const auto &edge = edges[ e ];
+
+          if( ! active.contains( edge.from ) ||
+              ( edge.letters & letters ).empty() )
+            continue;
+
+          next.insert( edge.to );
+          action |= edge.commands;
+        }
+      }
+
+      /**
+       * \brief Ends an input in a set of active states
+       *
+       * \param active the active states
+       * \param action receives final commands of active final states
+       *
+       * \return true if a final state is active
+       */
+      constexpr bool finish
+      ( const state_set_type &active, command_set_type &action ) const
+      {
+        bool result = false;
+
+        for( std::size_t s = 0; s < state_count; ++s )
+          if( final_states[ s ] && active.contains( s ) )
+          {
+            action |= final_commands[ s ];
+            result = true;
+          }
+
+        return result;
+      }
+
+      /**
+       * \brief Indicates if an input is recognized, following all edges
+       * consuming each letter from all active states at once
+       *
+       * \param input the input to recognize
+       *
+       * \return true if a final state is active at the end of the input
+       */
+      constexpr bool recognize( std::string_view input ) const
+      {
+        state_set_type active;
+        command_set_type ignored;
+
+        active.insert( start );
+
+        for( const auto letter : input )
+        {
+          state_set_type next;
+          letter_set letters;
+
+          letters.insert( static_cast< unsigned char >( letter ) );
+          step( active, letters, next, ignored );
+
+          if( next.empty() )
+            return false;
+
+          active = next;
+        }
+
+        return finish( active, ignored );
+      }
+
+      /**
+       * \brief The number of states
+       */
+      std::size_t state_count = 0;
+
+      /**
+       * \brief The number of edges
+       */
+      std::size_t edge_count = 0;
+
+      /**
+       * \brief The start state
+       */
+      std::size_t start = 0;
+
+      /**
+       * \brief The number of groups commands are working on
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief Indicates, for each state, if it is final
+       */
+      std::array< bool, STATE_CAPACITY > final_states {};
+
+      /**
+       * \brief Commands applied when the input ends in each final state
+       */
+      std::array< command_set_type, STATE_CAPACITY > final_commands {};
+
+      /**
+       * \brief Edges storage
+       */
+      std::array< epsilon_free_edge< command_set_type >, EDGE_CAPACITY >
+        edges {};
+    };
+
+  /**
+   * \brief Walks the epsilon free form of a Thompson automaton. The state p
+   * gets an edge p -> r for each letter edge q -> r such that q is reached
+   * from p by epsilon transitions, carrying commands met on the way to q
+   * followed by commands of the letter edge. The state p is final if the
+   * accepting state is reached from p by epsilon transitions. Only states
+   * reachable from the start state are kept, numbered in the order they are
+   * discovered, the start state being 0.
+   *
+   * \tparam COMMAND_SET a bit set type
+   * \tparam NFA a Thompson automaton type
+   * \tparam STATE_FUNCTION a callable type taking a state index, a final
+   * flag and final commands
+   * \tparam EDGE_FUNCTION a callable type taking an epsilon free edge
+   *
+   * \param nfa the automaton
+   * \param on_state called for each kept state
+   * \param on_edge called for each kept edge
+   */
+  template
+    < class COMMAND_SET, class NFA, class STATE_FUNCTION, class EDGE_FUNCTION >
+    constexpr void walk_epsilon_free
+    (
+      const NFA &nfa, STATE_FUNCTION &&on_state, EDGE_FUNCTION &&on_edge
+    )
+    {
+      constexpr auto capacity = NFA::state_capacity;
+
+      std::array< std::size_t, capacity > numbers {};
+      std::array< std::size_t, capacity > pending {};
+      std::size_t count = 0;
+
+      for( auto &number : numbers )
+        number = capacity;
+
+      numbers[ nfa.start ] = count;
+      pending[ count++ ] = nfa.start;
+
+      for( std::size_t p = 0; p < count; ++p )
+      {
+        bit_set< capacity > kernel;
+
+        kernel.insert( pending[ p ] );
+
+        const auto closure = close_kernel< COMMAND_SET >( nfa, kernel );
+
+        on_state
+          ( p, closure.reached[ nfa.accept ],
+            closure.commands[ nfa.accept ] );
+
+        for( std::size_t e = 0; e < nfa.edge_count; ++e )
+        {
+          const auto &edge = nfa.edges[ e ];
+
+          if( edge.is_epsilon || ! closure.reached[ edge.from ] )
+            continue;
+
+          if( numbers[ edge.to ] == capacity )
+          {
+            numbers[ edge.to ] = count;
+            pending[ count++ ] = edge.to;
+          }
+
+          on_edge
+            ( epsilon_free_edge< COMMAND_SET >
+              {
+                p, numbers[ edge.to ], edge.letters,
+                closure.commands[ edge.from ] |
+                  edge_command_set< COMMAND_SET >( nfa, e )
+              } );
+        }
+      }
+    }
+
+  /**
+   * \brief Computes sizes of the epsilon free form of a Thompson automaton
+   *
+   * \tparam NFA a Thompson automaton type
+   *
+   * \param nfa the automaton
+   *
+   * \return sizes of the epsilon free automaton
+   */
+  template< class NFA >
+    constexpr epsilon_free_size measure_epsilon_free( const NFA &nfa )
+    {
+      epsilon_free_size result { 0, 0 };
+
+      walk_epsilon_free< bit_set< 3 * NFA::command_capacity > >
+        ( nfa,
+          [ & ]( std::size_t, bool, const auto & ) { ++result.state_count; },
+          [ & ]( const auto & ) { ++result.edge_count; } );
+
+      return result;
+    }
+
+  /**
+   * \brief Removes epsilon transitions of a Thompson automaton, see
+   * walk_epsilon_free
+   *
+   * \tparam RESULT an epsilon free automaton type, sized using
+   * measure_epsilon_free
+   * \tparam NFA a Thompson automaton type
+   *
+   * \param nfa the automaton
+   *
+   * \return the epsilon free automaton
+   */
+  template< class RESULT, class NFA >
+    constexpr RESULT eliminate_epsilons( const NFA &nfa )
+    {
+      using command_set_type = typename RESULT::command_set_type;
+
+      RESULT result;
+
+      result.group_count = nfa.group_count;
+
+      walk_epsilon_free< command_set_type >
+        ( nfa,
+          [ & ]
+          ( std::size_t state, bool is_final,
+            const command_set_type &commands )
+          {
+            result.final_states[ state ] = is_final;
+            result.final_commands[ state ] = commands;
+            ++result.state_count;
+          },
+          [ & ]( const epsilon_free_edge< command_set_type > &edge )
+          { result.edges[ result.edge_count++ ] = edge; } );
+
+      return result;
+    }
+
+  /**
+   * \brief Epsilon free form of a grammar, built at compile time from its
+   * Thompson automaton. Engines building deterministic states on demand step
+   * on it without computing any closure.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct epsilon_free_grammar
+    {
+    private :
+      /**
+       * \brief The non deterministic form of the grammar
+       */
+      using thompson_ = thompson_grammar< GRAMMAR >;
+
+    public :
+      /**
+       * \brief Exact sizes of the epsilon free automaton
+       */
+      static constexpr epsilon_free_size size =
+        measure_epsilon_free( thompson_::nfa );
+
+      /**
+       * \brief The type of the epsilon free automaton, commands being encoded
+       * as in subset_automaton
+       */
+      using nfa_type =
+        epsilon_free_nfa
+        <
+          size.state_count,
+          size.edge_count,
+          3 * thompson_::nodes.group_count
+        >;
+
+      /**
+       * \brief The epsilon free automaton of the grammar
+       */
+      static constexpr nfa_type nfa =
+        eliminate_epsilons< nfa_type >( thompson_::nfa );
+
+      /**
+       * \brief The letter partition of the grammar
+       */
+      static constexpr letter_classes classes = thompson_::classes;
+    };
+
+  /**
+   * \brief Removes epsilon transitions of an automaton type. This
+   * unspecialized version is used when the provided type does not have the
+   * template signature of an automaton
+   *
+   * \tparam AUTOMATON a type that is not an automaton
+   */
+  template< class AUTOMATON >
+    struct epsilon_free_automaton
+    {
+      static_assert( automaton_traits< AUTOMATON >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+    };
+
+  /**
+   * \brief Specialization used with a type looking like an automaton. The
+   * automaton is first converted into a Thompson automaton whose extra
+   * accepting state is reached from each final state by an epsilon
+   * transition, transition functions becoming edges carrying their group
+   * commands. Groups are indexed in the order of their first appearance in
+   * the group command sequence. Epsilon transitions are then removed, their
+   * commands being moved to the letter transitions following them, or to
+   * final commands.
+   *
+   * \tparam AUTOMATON template signature for an automaton
+   * \tparam STATE_SEQUENCE the type sequence template holding states
+   * \tparam STATES states of the automaton
+   * \tparam T_FUNCTION_SEQUENCE the type sequence template holding transition
+   * functions
+   * \tparam T_FUNCTIONS transition functions of the automaton
+   * \tparam G_COMMAND_SEQUENCE the type sequence template holding group
+   * commands
+   * \tparam G_COMMANDS group commands of the automaton
+   */
+  template
+    <
+      template< class, class, class > class AUTOMATON,
+      template< class... > class STATE_SEQUENCE, class... STATES,
+      template< class... > class T_FUNCTION_SEQUENCE, class... T_FUNCTIONS,
+      template< class... > class G_COMMAND_SEQUENCE, class... G_COMMANDS
+    >
+    struct epsilon_free_automaton
+    <
+      AUTOMATON
+        <
+          STATE_SEQUENCE< STATES... >,
+          T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+          G_COMMAND_SEQUENCE< G_COMMANDS... >
+        >
+    >
+    {
+      static_assert( automaton_traits
+                       <
+                         AUTOMATON
+                           <
+                             STATE_SEQUENCE< STATES... >,
+                             T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+                             G_COMMAND_SEQUENCE< G_COMMANDS... >
+                           >
+                       >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+
+    private :
+      /**
+       * \brief Indicates which states are final
+       */
+      static constexpr bool finals_[] =
+      { automaton_state_traits< STATES >::is_final... };
+
+      /**
+       * \brief The number of final states
+       */
+      static constexpr std::size_t final_count_ =
+        ( std::size_t { 0 } + ... +
+          ( automaton_state_traits< STATES >::is_final ? 1 : 0 ) );
+
+      /**
+       * \brief The type of the Thompson form of the automaton
+       */
+      using thompson_type =
+        thompson_nfa
+        <
+          sizeof...( STATES ) + 1,
+          sizeof...( T_FUNCTIONS ) + final_count_,
+          sizeof...( G_COMMANDS )
+        >;
+
+      /**
+       * \brief Builds the Thompson form of the automaton
+       *
+       * \return the automaton, with an extra accepting state
+       */
+      static constexpr thompson_type make_thompson()
+      {
+        constexpr bool initials[] =
+        { automaton_state_traits< STATES >::is_initial... };
+
+        constexpr std::size_t sources[] =
+        {
+          index_of_type
+            <
+              typename automaton_t_function_traits< T_FUNCTIONS >::
+                source_state_id,
+              typename automaton_state_traits< STATES >::identifier...
+            >()...
+        };
+
+        constexpr std::size_t targets[] =
+        {
+          index_of_type
+            <
+              typename automaton_t_function_traits< T_FUNCTIONS >::
+                target_state_id,
+              typename automaton_state_traits< STATES >::identifier...
+            >()...
+        };
+
+        constexpr bool epsilons[] =
+        {
+          automaton_t_function_traits< T_FUNCTIONS >::is_epsilon_transition...
+        };
+
+        constexpr letter_set letters[] =
+        {
+          t_function_letters
+            <
+              typename automaton_t_function_traits< T_FUNCTIONS >::
+                function_argument
+            >::value...
+        };
+
+        constexpr group_command_types command_types[] =
+        { automaton_g_command_traits< G_COMMANDS >::type... };
+
+        constexpr std::size_t command_groups[] =
+        {
+          index_of_type
+            <
+              typename automaton_g_command_traits< G_COMMANDS >::group_name,
+              typename automaton_g_command_traits< G_COMMANDS >::group_name...
+            >()...
+        };
+
+        constexpr std::size_t command_t_functions[] =
+        {
+          index_of_type
+            <
+              typename automaton_g_command_traits< G_COMMANDS >::
+                t_function_id,
+              typename automaton_t_function_traits< T_FUNCTIONS >::id...
+            >()...
+        };
+
+        thompson_type result;
+
+        for( std::size_t s = 0; s <= sizeof...( STATES ); ++s )
+          result.add_state();
+
+        result.accept = sizeof...( STATES );
+
+        for( std::size_t s = 0; s < sizeof...( STATES ); ++s )
+          if( initials[ s ] )
+            result.start = s;
+
+        // dense group indices, in order of first appearance
+        std::array< std::size_t, sizeof...( G_COMMANDS ) + 1 > groups {};
+
+        for( std::size_t c = 0; c < sizeof...( G_COMMANDS ); ++c )
+          if( command_groups[ c ] == c )
+            groups[ c ] = result.group_count++;
+          else
+            groups[ c ] = groups[ command_groups[ c ] ];
+
+        for( std::size_t t = 0; t < sizeof...( T_FUNCTIONS ); ++t )
+        {
+          result.add_edge
+            ( sources[ t ], targets[ t ], epsilons[ t ], letters[ t ] );
+
+          for( std::size_t c = 0; c < sizeof...( G_COMMANDS ); ++c )
+            if( command_t_functions[ c ] == t )
+              result.add_command( command_types[ c ], groups[ c ] );
+        }
+
+        for( std::size_t s = 0; s < sizeof...( STATES ); ++s )
+          if( finals_[ s ] )
+            result.add_edge( s, result.accept, true );
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The Thompson form of the automaton
+       */
+      static constexpr thompson_type thompson = make_thompson();
+
+      /**
+       * \brief Exact sizes of the epsilon free automaton
+       */
+      static constexpr epsilon_free_size size =
+        measure_epsilon_free( thompson );
+
+      /**
+       * \brief The type of the epsilon free automaton
+       */
+      using value_type =
+        epsilon_free_nfa
+        <
+          size.state_count,
+          size.edge_count,
+          3 * sizeof...( G_COMMANDS )
+        >;
+
+      /**
+       * \brief The epsilon free automaton
+       */
+      static constexpr value_type value =
+        eliminate_epsilons< value_type >( thompson );
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_EPSILON_ELIMINATION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the epsilon elimination pass, turning automata full of
+ * epsilon transitions into automata stepping only on letters
+ */
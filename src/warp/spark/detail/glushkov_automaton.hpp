@@ -0,0 +1,223 @@
+#ifndef _WARP_SPARK_DETAIL_GLUSHKOV_AUTOMATON_HPP_
+#define _WARP_SPARK_DETAIL_GLUSHKOV_AUTOMATON_HPP_
+
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "group_node_table.hpp"
+#include "letter_set.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Counts symbols of a group node table, that is, positions of its
+   * Glushkov automaton
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return the number of positions
+   */
+  template< class NODES >
+    constexpr std::size_t count_glushkov_positions( const NODES &nodes )
+    {
+      std::size_t result = 0;
+
+      for( std::size_t n = 0; n < nodes.node_count; ++n )
+        if( nodes.nodes[ n ].type == group_node_types::symbol )
+          ++result;
+
+      return result;
+    }
+
+  /**
+   * \brief The Glushkov (position) automaton of a grammar, in a form suited
+   * to a bit-parallel simulation. Each symbol occurrence of the grammar is a
+   * position, represented by a bit of a 64 bits word. A set of active
+   * positions is thus a single word, and a step of the simulation is :
+   * active = follow( active ) & masks[ letter ]
+   * where follow is computed a byte of the active word at a time, using
+   * precomputed tables.
+   *
+   * \tparam POSITION_COUNT the number of positions, up to 64
+   */
+  template< std::size_t POSITION_COUNT >
+    struct glushkov_automaton
+    {
+      static_assert( POSITION_COUNT <= 64,
+                     "Invalid grammar used. A bit-parallel automaton holds "
+                     "up to 64 positions." );
+
+      /**
+       * \brief Exposes the number of positions
+       */
+      static constexpr std::size_t position_count = POSITION_COUNT;
+
+      /**
+       * \brief The number of bytes of active words to look up while following
+       * positions
+       */
+      static constexpr std::size_t chunk_count =
+        POSITION_COUNT == 0 ? 1 : ( POSITION_COUNT + 7 ) / 8;
+
+      /**
+       * \brief Computes positions following a set of active positions
+       *
+       * \param active a set of active positions
+       *
+       * \return the set of positions that may follow active positions
+       */
+      constexpr std::uint64_t follow( std::uint64_t active ) const
+      {
+        std::uint64_t result = 0;
+
+        for( std::size_t c = 0; c < chunk_count; ++c )
+          result |= follow_tables[ c ][ ( active >> ( 8 * c ) ) & 0xff ];
+
+        return result;
+      }
+
+      /**
+       * \brief Indicates if the empty input is recognized
+       */
+      bool nullable = false;
+
+      /**
+       * \brief Positions that may start an input
+       */
+      std::uint64_t first = 0;
+
+      /**
+       * \brief Positions that may end an input
+       */
+      std::uint64_t last = 0;
+
+      /**
+       * \brief Positions that may follow each position
+       */
+      std::array< std::uint64_t, POSITION_COUNT > follows {};
+
+      /**
+       * \brief Positions accepting each letter
+       */
+      std::array< std::uint64_t, letter_set::letter_count > masks {};
+
+      /**
+       * \brief Union of follows of positions, for each byte of an active word
+       */
+      std::array< std::array< std::uint64_t, 256 >, chunk_count >
+        follow_tables {};
+    };
+
+  /**
+   * \brief Builds the Glushkov automaton of a group node table. Nodes are
+   * stored before the groups using them, thus, a single pass computes
+   * nullability, first and last positions of each node and follow sets.
+   *
+   * \tparam GLUSHKOV a Glushkov automaton type, sized using
+   * count_glushkov_positions
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return the Glushkov automaton
+   */
+  template< class GLUSHKOV, class NODES >
+    constexpr GLUSHKOV build_glushkov_automaton( const NODES &nodes )
+    {
+      GLUSHKOV result;
+
+      std::array< bool, NODES::node_capacity > nullable {};
+      std::array< std::uint64_t, NODES::node_capacity > first {};
+      std::array< std::uint64_t, NODES::node_capacity > last {};
+      std::size_t position = 0;
+
+      const auto link = [ & ]( std::uint64_t from, std::uint64_t to )
+      {
+        for( std::size_t p = 0; p < GLUSHKOV::position_count; ++p )
+          if( ( from >> p ) & 1 )
+            result.follows[ p ] |= to;
+      };
+
+      for( std::size_t n = 0; n < nodes.node_count; ++n )
+      {
+        const auto &node = nodes.nodes[ n ];
+
+        if( node.type == group_node_types::symbol )
+        {
+          const auto bit = std::uint64_t { 1 } << position++;
+
+          first[ n ] = last[ n ] = bit;
+
+          for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+            if( node.letters.contains( static_cast< unsigned char >( l ) ) )
+              result.masks[ l ] |= bit;
+
+          continue;
+        }
+
+        const auto a = node.first;
+
+        if( node.type == group_node_types::unary_group )
+        {
+          first[ n ] = first[ a ];
+          last[ n ] = last[ a ];
+          nullable[ n ] =
+            nullable[ a ] ||
+            node.unary_closure == group_unary_closures::zero_one ||
+            node.unary_closure == group_unary_closures::zero_many;
+
+          if( node.unary_closure == group_unary_closures::zero_many ||
+              node.unary_closure == group_unary_closures::one_many )
+            link( last[ a ], first[ a ] );
+
+          continue;
+        }
+
+        const auto b = node.second;
+
+        if( node.binary_closure == group_binary_closures::alternation )
+        {
+          nullable[ n ] = nullable[ a ] || nullable[ b ];
+          first[ n ] = first[ a ] | first[ b ];
+          last[ n ] = last[ a ] | last[ b ];
+
+          continue;
+        }
+
+        nullable[ n ] = nullable[ a ] && nullable[ b ];
+        first[ n ] = first[ a ] | ( nullable[ a ] ? first[ b ] : 0 );
+        last[ n ] = last[ b ] | ( nullable[ b ] ? last[ a ] : 0 );
+        link( last[ a ], first[ b ] );
+      }
+
+      result.nullable = nullable[ nodes.root ];
+      result.first = first[ nodes.root ];
+      result.last = last[ nodes.root ];
+
+      for( std::size_t c = 0; c < GLUSHKOV::chunk_count; ++c )
+        for( std::size_t byte = 0; byte < 256; ++byte )
+          for( std::size_t bit = 0; bit < 8; ++bit )
+          {
+            const auto p = 8 * c + bit;
+
+            if( ( ( byte >> bit ) & 1 ) && p < GLUSHKOV::position_count )
+              result.follow_tables[ c ][ byte ] |= result.follows[ p ];
+          }
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_GLUSHKOV_AUTOMATON_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the Glushkov automaton of a grammar, used by bit-parallel
+ * simulations
+ */
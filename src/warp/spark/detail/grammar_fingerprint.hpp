@@ -0,0 +1,114 @@
+#ifndef _WARP_SPARK_DETAIL_GRAMMAR_FINGERPRINT_HPP_
+#define _WARP_SPARK_DETAIL_GRAMMAR_FINGERPRINT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief The initial value of fingerprints, the 64 bits FNV offset basis
+   */
+  inline constexpr std::uint64_t fingerprint_basis = 0xcbf29ce484222325u;
+
+  /**
+   * \brief Mixes a value in a fingerprint, FNV-1a style. Only values are
+   * mixed, never addresses nor sizes of types, thus, fingerprints are the
+   * same in every translation unit and with every compiler
+   *
+   * \param fingerprint the fingerprint so far
+   * \param value the value to mix
+   *
+   * \return the updated fingerprint
+   */
+  constexpr std::uint64_t mix_fingerprint
+  ( std::uint64_t fingerprint, std::uint64_t value )
+  { return ( fingerprint ^ value ) * 0x100000001b3u; }
+
+  /**
+   * \brief Computes the fingerprint of a regular grammar definition
+   * sequence. This version deals with anything that is not an integral
+   * sequence, having no fingerprint
+   *
+   * \tparam SEQUENCE anything but an integral sequence
+   */
+  template< class SEQUENCE >
+    struct definition_fingerprint {};
+
+  /**
+   * \brief Specialization dealing with an integral sequence, mixing its
+   * length then each of its letters. Letters are mixed as unsigned values,
+   * the integral type of the sequence being left out
+   *
+   * \tparam S an integral sequence template
+   * \tparam T the integral type used in the sequence
+   * \tparam VS letters of the sequence
+   */
+  template< template< class C, C... > class S, class T, T... VS >
+    struct definition_fingerprint< S< T, VS... > >
+    {
+    private :
+      /**
+       * \brief Mixes letters of the sequence
+       *
+       * \return the fingerprint of the sequence
+       */
+      static constexpr std::uint64_t compute()
+      {
+        auto result = mix_fingerprint( fingerprint_basis, sizeof...( VS ) );
+
+        ( ( result =
+              mix_fingerprint
+                ( result,
+                  static_cast< std::make_unsigned_t< T > >( VS ) ) ), ... );
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The fingerprint of the sequence
+       */
+      static constexpr std::uint64_t value = compute();
+    };
+
+  /**
+   * \brief Computes the fingerprint of a group node table, from the hashes
+   * of its nodes. Names of groups and symbols are not part of nodes, thus,
+   * grammars differing only by their names share a fingerprint, as they
+   * share their automata
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the table
+   *
+   * \return the fingerprint of the table
+   */
+  template< class NODES >
+    constexpr std::uint64_t group_nodes_fingerprint( const NODES &nodes )
+    {
+      const std::uint64_t sizes[] =
+        { nodes.node_count, nodes.root, nodes.group_count };
+
+      auto result = fingerprint_basis;
+
+      for( const auto size : sizes )
+        result = mix_fingerprint( result, size );
+
+      for( std::size_t n = 0; n < nodes.node_count; ++n )
+        result = mix_fingerprint( result, nodes.nodes[ n ].hash() );
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_GRAMMAR_FINGERPRINT_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains stable fingerprints of regular grammar definitions and of
+ * group node tables
+ */
@@ -0,0 +1,841 @@
+#ifndef _WARP_SPARK_DETAIL_GROUP_NODE_TABLE_HPP_
+#define _WARP_SPARK_DETAIL_GROUP_NODE_TABLE_HPP_
+
+#include "../../core/types.hpp"
+#include "../../sequences/algorithm.hpp"
+#include "../../sequences/sequence_types.hpp"
+#include "../group_traits.hpp"
+#include "../symbol_traits.hpp"
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "automaton_table.hpp"
+#include "letter_set.hpp"
+#include "letter_classes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Enumerates all kinds of node a group node table may contain
+   */
+  enum class group_node_types
+  {
+    /**
+     * \brief A symbol, recognizing a set of letters
+     */
+    symbol,
+
+    /**
+     * \brief A group applying an unary closure on its operand
+     */
+    unary_group,
+
+    /**
+     * \brief A group applying a binary closure on its operands
+     */
+    binary_group
+  };
+
+  /**
+   * \brief Value representation of a symbol or a group of a regular grammar.
+   * Operands of a group are designated by their index in the node table
+   */
+  struct group_node
+  {
+    /**
+     * \brief The kind of this node
+     */
+    group_node_types type;
+
+    /**
+     * \brief Letters recognized by a symbol node
+     */
+    letter_set letters;
+
+    /**
+     * \brief The closure of an unary group node
+     */
+    group_unary_closures unary_closure;
+
+    /**
+     * \brief The closure of a binary group node
+     */
+    group_binary_closures binary_closure;
+
+    /**
+     * \brief The index of the group, groups sharing a name sharing an index
+     */
+    std::size_t group;
+
+    /**
+     * \brief Index of the first operand of a group node
+     */
+    std::size_t first;
+
+    /**
+     * \brief Index of the second operand of a binary group node
+     */
+    std::size_t second;
+
+    /**
+     * \brief Structural equality of two nodes. Operands being shared, equal
+     * operand indices mean equal operand subtrees
+     *
+     * \param other the node to compare with this one
+     *
+     * \return true if both nodes represent the same subtree
+     */
+    constexpr bool operator == ( const group_node &other ) const
+    {
+      return
+        type == other.type && letters == other.letters &&
+        unary_closure == other.unary_closure &&
+        binary_closure == other.binary_closure &&
+        group == other.group && first == other.first &&
+        second == other.second;
+    }
+
+    /**
+     * \brief Computes a hash of the node, equal nodes having equal hashes
+     *
+     * \return the hash of the node
+     */
+    constexpr std::uint64_t hash() const
+    {
+      const std::uint64_t fields[] =
+      {
+        static_cast< std::uint64_t >( type ),
+        static_cast< std::uint64_t >( unary_closure ),
+        static_cast< std::uint64_t >( binary_closure ),
+        group, first, second
+      };
+
+      auto result = letters.hash();
+
+      for( const auto field : fields )
+        result = ( result ^ field ) * 0x100000001b3u;
+
+      return result;
+    }
+  };
+
+  /**
+   * \brief Value representation of a group tree. Operands are always stored
+   * before the group using them, the root being the last node
+   *
+   * \tparam CAPACITY the maximum number of nodes the table can hold
+   */
+  template< std::size_t CAPACITY >
+    struct group_node_table
+    {
+      /**
+       * \brief Exposes the node capacity of this table
+       */
+      static constexpr std::size_t node_capacity = CAPACITY;
+
+      /**
+       * \brief Adds a node in the table
+       *
+       * \param node the node to add
+       *
+       * \return the index of the added node
+       */
+      constexpr std::size_t add( const group_node &node )
+      {
+        nodes[ node_count ] = node;
+
+        return node_count++;
+      }
+
+      /**
+       * \brief Computes the letter partition of all symbols of the table
+       *
+       * \return letter classes of the table
+       */
+      constexpr letter_classes classes() const
+      {
+        letter_classes result;
+
+        for( std::size_t n = 0; n < node_count; ++n )
+          if( nodes[ n ].type == group_node_types::symbol )
+            result.refine( nodes[ n ].letters );
+
+        return result;
+      }
+
+      /**
+       * \brief The number of nodes in the table
+       */
+      std::size_t node_count = 0;
+
+      /**
+       * \brief The index of the root node
+       */
+      std::size_t root = 0;
+
+      /**
+       * \brief The number of distinct groups
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief Nodes storage
+       */
+      std::array< group_node, CAPACITY > nodes {};
+    };
+
+  /**
+   * \brief Builds a group node table sharing structurally identical nodes.
+   * Each added node is looked up in an open addressing hash table first and
+   * reused if already present. Operands being added before their group, a
+   * group is shared as soon as its operands are, thus, the resulting table is
+   * a directed acyclic graph where each distinct subtree appears once.
+   *
+   * \tparam CAPACITY the maximum number of nodes the table can hold
+   */
+  template< std::size_t CAPACITY >
+    struct group_node_interner
+    {
+      /**
+       * \brief Exposes the node capacity of the built table
+       */
+      static constexpr std::size_t node_capacity = CAPACITY;
+
+      /**
+       * \brief The number of buckets, at least twice the capacity to keep
+       * probe sequences short
+       */
+      static constexpr std::size_t bucket_count = 2 * CAPACITY + 1;
+
+      /**
+       * \brief Adds a node in the table unless an identical node is present
+       *
+       * \param node the node to add
+       *
+       * \return the index of the added or the shared node
+       */
+      constexpr std::size_t add( const group_node &node )
+      {
+        auto bucket = node.hash() % bucket_count;
+
+        for( ; buckets[ bucket ] != 0; bucket = ( bucket + 1 ) % bucket_count )
+          if( table.nodes[ buckets[ bucket ] - 1 ] == node )
+            return buckets[ bucket ] - 1;
+
+        const auto result = table.add( node );
+
+        buckets[ bucket ] = result + 1;
+
+        return result;
+      }
+
+      /**
+       * \brief The built table
+       */
+      group_node_table< CAPACITY > table {};
+
+      /**
+       * \brief Node indices plus one, 0 marking an empty bucket
+       */
+      std::array< std::size_t, bucket_count > buckets {};
+    };
+
+  /**
+   * \brief Counts nodes of a group tree. This version works with a symbol and
+   * anything that is not a group
+   *
+   * \tparam T a symbol or undefined_type
+   */
+  template< class T, bool = group_traits< T >::is_group >
+    struct group_node_count
+    {
+      /**
+       * \brief A symbol is a single node, undefined_type is not a node
+       */
+      static constexpr std::size_t value =
+        symbol_traits< T >::is_symbol ? 1 : 0;
+    };
+
+  /**
+   * \brief Specialization dealing with a group, counting its operands
+   * recursively
+   *
+   * \tparam T a group type
+   */
+  template< class T >
+    struct group_node_count< T, true >
+    {
+      /**
+       * \brief The group itself and all nodes of its operands
+       */
+      static constexpr std::size_t value =
+        1 +
+        group_node_count
+          < typename group_traits< T >::first_operand >::value +
+        group_node_count
+          < typename group_traits< T >::second_operand >::value;
+    };
+
+  /**
+   * \brief Collects distinct symbol and group types of a tree, operands
+   * before the groups using them, each type appearing once. This version
+   * works with a symbol and anything that is not a group
+   *
+   * \tparam T a symbol or undefined_type
+   * \tparam TYPES a type sequence of already collected types
+   */
+  template< class T, class TYPES, bool = group_traits< T >::is_group >
+    struct group_node_types_of;
+
+  /**
+   * \brief Specialization dealing with a symbol or undefined_type, the
+   * latter not being a node
+   *
+   * \tparam T a symbol or undefined_type
+   * \tparam TYPES already collected types
+   */
+  template< class T, class... TYPES >
+    struct group_node_types_of< T, type_sequence< TYPES... >, false >
+    {
+      /**
+       * \brief Collected types, including the symbol if not already there
+       */
+      using type =
+        std::conditional_t
+        <
+          symbol_traits< T >::is_symbol &&
+            index_of_type< T, TYPES... >() == sizeof...( TYPES ),
+          type_sequence< TYPES..., T >,
+          type_sequence< TYPES... >
+        >;
+    };
+
+  /**
+   * \brief Collects types of operands of a group, then the group itself.
+   * This version works with an already collected group, whose operands are
+   * collected as well, thus, each distinct subtree is walked once
+   *
+   * \tparam T a group type
+   * \tparam TYPES already collected types
+   * \tparam IS_COLLECTED true if the group is already collected
+   */
+  template< class T, class TYPES, bool IS_COLLECTED >
+    struct group_operand_types_of
+    {
+      /**
+       * \brief No type to add
+       */
+      using type = TYPES;
+    };
+
+  /**
+   * \brief Specialization dealing with a group not collected yet
+   *
+   * \tparam T a group type
+   * \tparam TYPES already collected types
+   */
+  template< class T, class TYPES >
+    struct group_operand_types_of< T, TYPES, false >
+    {
+    private :
+      /**
+       * \brief Collected types, including types of the first operand
+       */
+      using first =
+        typename group_node_types_of
+          < typename group_traits< T >::first_operand, TYPES >::type;
+
+      /**
+       * \brief Collected types, including types of the second operand
+       */
+      using second =
+        typename group_node_types_of
+          < typename group_traits< T >::second_operand, first >::type;
+
+    public :
+      /**
+       * \brief Collected types, including the group
+       */
+      using type = typename push_back_on< second, T >::type;
+    };
+
+  /**
+   * \brief Specialization dealing with a group
+   *
+   * \tparam T a group type
+   * \tparam TYPES already collected types
+   */
+  template< class T, class... TYPES >
+    struct group_node_types_of< T, type_sequence< TYPES... >, true >
+    {
+      /**
+       * \brief Collected types, including types of the subtree of the group
+       */
+      using type =
+        typename group_operand_types_of
+          <
+            T, type_sequence< TYPES... >,
+            index_of_type< T, TYPES... >() < sizeof...( TYPES )
+          >::type;
+    };
+
+  /**
+   * \brief Convenient alias to get distinct symbol and group types of a tree
+   *
+   * \tparam GROUP the root of the tree, the last collected type
+   */
+  template< class GROUP >
+    using group_node_types_of_t =
+      typename group_node_types_of< GROUP, type_sequence<> >::type;
+
+  /**
+   * \brief Counts types collected by group_node_types_of
+   */
+  template< class TYPES >
+    struct group_node_type_count;
+
+  /**
+   * \brief Specialization extracting types of the sequence
+   *
+   * \tparam TYPES distinct symbol and group types of a tree
+   */
+  template< class... TYPES >
+    struct group_node_type_count< type_sequence< TYPES... > >
+    {
+      /**
+       * \brief The number of types, bounding the number of shared nodes
+       */
+      static constexpr std::size_t value = sizeof...( TYPES );
+    };
+
+  /**
+   * \brief Collects names of groups of a tree, in pre-order, each name
+   * appearing once. This version works with a symbol and anything that is
+   * not a group, leaving names as is
+   *
+   * \tparam T a symbol or undefined_type
+   * \tparam NAMES a type sequence of already collected names
+   */
+  template< class T, class NAMES, bool = group_traits< T >::is_group >
+    struct group_names_of
+    {
+      /**
+       * \brief No name to add
+       */
+      using type = NAMES;
+    };
+
+  /**
+   * \brief Specialization dealing with a group, collecting its name then
+   * names of its operands
+   *
+   * \tparam T a group type
+   * \tparam NAMES already collected names
+   */
+  template< class T, class... NAMES >
+    struct group_names_of< T, type_sequence< NAMES... >, true >
+    {
+    private :
+      /**
+       * \brief The name of the group
+       */
+      using name = typename group_traits< T >::group_name;
+
+      /**
+       * \brief Collected names, including the name of this group
+       */
+      using own =
+        std::conditional_t
+        <
+          index_of_type< name, NAMES... >() < sizeof...( NAMES ),
+          type_sequence< NAMES... >,
+          type_sequence< NAMES..., name >
+        >;
+
+      /**
+       * \brief Collected names, including names of the first operand
+       */
+      using first =
+        typename group_names_of
+          < typename group_traits< T >::first_operand, own >::type;
+
+    public :
+      /**
+       * \brief All collected names
+       */
+      using type =
+        typename group_names_of
+          < typename group_traits< T >::second_operand, first >::type;
+    };
+
+  /**
+   * \brief Convenient alias to get names of all groups of a tree
+   *
+   * \tparam GROUP the root of the tree
+   */
+  template< class GROUP >
+    using group_names_of_t =
+      typename group_names_of< GROUP, type_sequence<> >::type;
+
+  /**
+   * \brief Gives the index of a group name in a sequence of names
+   */
+  template< class NAME, class NAMES >
+    struct group_name_index;
+
+  /**
+   * \brief Specialization extracting names of the sequence
+   *
+   * \tparam NAME the group name to look for
+   * \tparam NAMES all group names
+   */
+  template< class NAME, class... NAMES >
+    struct group_name_index< NAME, type_sequence< NAMES... > >
+    {
+      /**
+       * \brief Index of the name, the size of the sequence if not found
+       */
+      static constexpr std::size_t value =
+        index_of_type< NAME, NAMES... >();
+    };
+
+  /**
+   * \brief Gives the index of a group in a grammar. Groups are indexed in the
+   * pre-order of the group tree, the root group having the index 0 and groups
+   * sharing a same name sharing an index
+   *
+   * \tparam GROUP the root of the group tree
+   * \tparam NAME the name of a group of the tree
+   */
+  template< class GROUP, class NAME >
+    struct group_index_of
+    {
+      static_assert( group_name_index
+                       < NAME, group_names_of_t< GROUP > >::value <
+                     group_node_count< GROUP >::value,
+                     "Invalid group name used. The name does not belong to "
+                     "the grammar." );
+
+      /**
+       * \brief The index of the group
+       */
+      static constexpr std::size_t value =
+        group_name_index< NAME, group_names_of_t< GROUP > >::value;
+    };
+
+  /**
+   * \brief Makes the node of a symbol or a group, given its operand nodes.
+   * This version works with a symbol
+   *
+   * \tparam T a symbol type
+   * \tparam NAMES names of all groups of the tree
+   */
+  template< class T, class NAMES, bool = group_traits< T >::is_group >
+    struct group_node_of
+    {
+      /**
+       * \brief Makes the node of the symbol
+       *
+       * \return the symbol node
+       */
+      static constexpr group_node make( std::size_t, std::size_t )
+      {
+        group_node node {};
+
+        node.type = group_node_types::symbol;
+        node.letters = letter_set_of< T >::value;
+
+        return node;
+      }
+    };
+
+  /**
+   * \brief Specialization dealing with a group
+   *
+   * \tparam T a group type
+   * \tparam NAMES names of all groups of the tree
+   */
+  template< class T, class... NAMES >
+    struct group_node_of< T, type_sequence< NAMES... >, true >
+    {
+      /**
+       * \brief Makes the node of the group
+       *
+       * \param first the index of the node of the first operand
+       * \param second the index of the node of the second operand, ignored
+       * by an unary group
+       *
+       * \return the group node
+       */
+      static constexpr group_node make( std::size_t first, std::size_t second )
+      {
+        using traits = group_traits< T >;
+
+        group_node node {};
+
+        node.group =
+          index_of_type< typename traits::group_name, NAMES... >();
+        node.first = first;
+
+        if constexpr( std::is_same< typename traits::closure_type,
+                                    group_binary_closures >::value )
+        {
+          node.type = group_node_types::binary_group;
+          node.binary_closure = traits::closure;
+          node.second = second;
+        }
+        else
+        {
+          node.type = group_node_types::unary_group;
+          node.unary_closure = traits::closure;
+        }
+
+        return node;
+      }
+    };
+
+  /**
+   * \brief Adds nodes of a tree in a table, a node per occurrence. This
+   * version works with a symbol
+   *
+   * \tparam T a symbol type
+   * \tparam NAMES names of all groups of the tree
+   */
+  template< class T, class NAMES, bool = group_traits< T >::is_group >
+    struct group_node_builder
+    {
+      /**
+       * \brief Adds the symbol in the table
+       *
+       * \tparam TABLE a group node table type
+       *
+       * \param table the table to fill
+       *
+       * \return the index of the added node
+       */
+      template< class TABLE >
+        static constexpr std::size_t build( TABLE &table )
+        { return table.add( group_node_of< T, NAMES >::make( 0, 0 ) ); }
+    };
+
+  /**
+   * \brief Specialization dealing with a group, adding operands first
+   *
+   * \tparam T a group type
+   * \tparam NAMES names of all groups of the tree
+   */
+  template< class T, class NAMES >
+    struct group_node_builder< T, NAMES, true >
+    {
+      /**
+       * \brief Adds operands, then the group in the table
+       *
+       * \tparam TABLE a group node table type
+       *
+       * \param table the table to fill
+       *
+       * \return the index of the added node
+       */
+      template< class TABLE >
+        static constexpr std::size_t build( TABLE &table )
+        {
+          using traits = group_traits< T >;
+
+          const auto first =
+            group_node_builder< typename traits::first_operand, NAMES >::
+              build( table );
+          std::size_t second = 0;
+
+          if constexpr( std::is_same< typename traits::closure_type,
+                                      group_binary_closures >::value )
+            second =
+              group_node_builder< typename traits::second_operand, NAMES >::
+                build( table );
+
+          return table.add( group_node_of< T, NAMES >::make( first, second ) );
+        }
+    };
+
+  /**
+   * \brief Flattens a group tree into a group node table
+   *
+   * \tparam GROUP the root of the group tree
+   */
+  template< class GROUP >
+    struct group_node_table_from
+    {
+      static_assert( group_traits< GROUP >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      /**
+       * \brief Names of all groups of the tree, in index order
+       */
+      using group_names = group_names_of_t< GROUP >;
+
+      /**
+       * \brief The table type, exactly sized
+       */
+      using table_type =
+        group_node_table< group_node_count< GROUP >::value >;
+
+    private :
+      /**
+       * \brief Builds the table
+       *
+       * \return the table representing the group tree
+       */
+      static constexpr table_type make()
+      {
+        table_type result;
+
+        result.root =
+          group_node_builder< GROUP, group_names >::build( result );
+        result.group_count =
+          group_name_index< undefined_type, group_names >::value;
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The table representing the group tree
+       */
+      static constexpr table_type value = make();
+    };
+
+  /**
+   * \brief Flattens a group tree into a group node table where structurally
+   * identical subgroups and symbols are stored once. Automaton construction
+   * and analyses walking the table from its root see the same tree, at a
+   * fraction of the storage when subtrees are repeated. Distinct symbol and
+   * group types are collected first, each subtree being walked once, then
+   * their nodes are added in order, operands before the groups using them,
+   * thus, the table is sized and filled in the number of distinct types
+   * instead of the number of occurrences. Algorithms needing a node per
+   * occurrence, such as position automata, use group_node_table_from
+   * instead.
+   *
+   * \tparam GROUP the root of the group tree
+   */
+  template< class GROUP >
+    struct group_dag_from
+    {
+      static_assert( group_traits< GROUP >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      /**
+       * \brief Names of all groups of the tree, in index order
+       */
+      using group_names = group_names_of_t< GROUP >;
+
+      /**
+       * \brief Distinct symbol and group types of the tree, operands first
+       */
+      using node_types = group_node_types_of_t< GROUP >;
+
+      /**
+       * \brief The table type, large enough to hold a node per distinct type
+       */
+      using table_type =
+        group_node_table< group_node_type_count< node_types >::value >;
+
+    private :
+      /**
+       * \brief Gives the node index of an operand
+       *
+       * \tparam OPERAND the operand type, undefined_type for none
+       * \tparam TYPES distinct types of the tree
+       *
+       * \param indices node indices of types already added
+       *
+       * \return the node index of the operand, 0 for none
+       */
+      template< class OPERAND, class... TYPES >
+        static constexpr std::size_t operand_index
+        ( const std::array< std::size_t, sizeof...( TYPES ) > &indices )
+        {
+          constexpr auto type = index_of_type< OPERAND, TYPES... >();
+
+          if constexpr( type < sizeof...( TYPES ) )
+            return indices[ type ];
+          else
+            return 0;
+        }
+
+      /**
+       * \brief Adds the node of each distinct type in a table
+       *
+       * \tparam TYPES distinct types of the tree, operands first
+       *
+       * \param result the interner filling the table
+       *
+       * \return the index of the root node
+       */
+      template< class... TYPES >
+        static constexpr std::size_t add_nodes
+        (
+          group_node_interner< table_type::node_capacity > &result,
+          type_sequence< TYPES... >
+        )
+        {
+          std::array< std::size_t, sizeof...( TYPES ) > indices {};
+
+          (
+            (
+              indices[ index_of_type< TYPES, TYPES... >() ] =
+                result.add
+                  ( group_node_of< TYPES, group_names >::make
+                    (
+                      operand_index
+                        <
+                          typename group_traits< TYPES >::first_operand,
+                          TYPES...
+                        >( indices ),
+                      operand_index
+                        <
+                          typename group_traits< TYPES >::second_operand,
+                          TYPES...
+                        >( indices )
+                    ) )
+            ), ...
+          );
+
+          return indices[ sizeof...( TYPES ) - 1 ];
+        }
+
+      /**
+       * \brief Builds the table
+       *
+       * \return the table representing the group tree, with shared nodes
+       */
+      static constexpr table_type make()
+      {
+        group_node_interner< table_type::node_capacity > result;
+
+        result.table.root = add_nodes( result, node_types {} );
+        result.table.group_count =
+          group_name_index< undefined_type, group_names >::value;
+
+        return result.table;
+      }
+
+    public :
+      /**
+       * \brief The table representing the group tree, with shared nodes
+       */
+      static constexpr table_type value = make();
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_GROUP_NODE_TABLE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the value representation of a group tree, used as the
+ * starting point of automaton construction algorithms
+ */
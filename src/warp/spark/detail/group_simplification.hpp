@@ -0,0 +1,179 @@
+#ifndef _WARP_SPARK_DETAIL_GROUP_SIMPLIFICATION_HPP_
+#define _WARP_SPARK_DETAIL_GROUP_SIMPLIFICATION_HPP_
+
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "group_node_table.hpp"
+
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Combines two nested repetition closures into a single closure
+   * recognizing the same language, such as (x*)* into x*, (x+)? into x* or
+   * (x?)? into x?
+   *
+   * \param outer the closure of the enclosing group
+   * \param inner the closure of the enclosed group, anything but one_one
+   *
+   * \return the combined closure
+   */
+  constexpr group_unary_closures combine_unary_closures
+  ( group_unary_closures outer, group_unary_closures inner )
+  {
+    if( outer == inner )
+      return outer;
+
+    return group_unary_closures::zero_many;
+  }
+
+  /**
+   * \brief Rewrites a node and its operands into an interner, bottom up.
+   * Rewritten operands are already simplified, thus, a single pass reaches
+   * the fixed point of rules :
+   * - groups applying the one_one closure are replaced by their operand,
+   *   flattening concatenation and alternation trees
+   * - nested repetition closures are combined into a single closure
+   * - alternations of symbols are merged into a single symbol
+   * - alternations of identical operands are replaced by the operand
+   * Group indices are dropped, the result recognizes the same language but
+   * does not report any group command.
+   *
+   * \tparam NODES a group node table type
+   * \tparam INTERNER a group node interner type
+   *
+   * \param nodes the source table
+   * \param node the index of the rewritten node in the source table
+   * \param result the interner receiving rewritten nodes
+   *
+   * \return the index of the rewritten node in the interner
+   */
+  template< class NODES, class INTERNER >
+    constexpr std::size_t simplify_group_node
+    ( const NODES &nodes, std::size_t node, INTERNER &result )
+    {
+      const auto &current = nodes.nodes[ node ];
+
+      group_node rewritten {};
+
+      rewritten.type = current.type;
+
+      if( current.type == group_node_types::symbol )
+      {
+        rewritten.letters = current.letters;
+
+        return result.add( rewritten );
+      }
+
+      const auto first = simplify_group_node( nodes, current.first, result );
+      const auto &operand = result.table.nodes[ first ];
+
+      if( current.type == group_node_types::unary_group )
+      {
+        if( current.unary_closure == group_unary_closures::one_one )
+          return first;
+
+        rewritten.unary_closure = current.unary_closure;
+        rewritten.first = first;
+
+        if( operand.type == group_node_types::unary_group )
+        {
+          rewritten.unary_closure =
+            combine_unary_closures
+              ( current.unary_closure, operand.unary_closure );
+          rewritten.first = operand.first;
+        }
+
+        return result.add( rewritten );
+      }
+
+      const auto second = simplify_group_node( nodes, current.second, result );
+      const auto &other = result.table.nodes[ second ];
+
+      if( current.binary_closure == group_binary_closures::alternation )
+      {
+        if( first == second )
+          return first;
+
+        if( operand.type == group_node_types::symbol &&
+            other.type == group_node_types::symbol )
+        {
+          rewritten.type = group_node_types::symbol;
+          rewritten.letters = operand.letters | other.letters;
+
+          return result.add( rewritten );
+        }
+      }
+
+      rewritten.binary_closure = current.binary_closure;
+      rewritten.first = first;
+      rewritten.second = second;
+
+      return result.add( rewritten );
+    }
+
+  /**
+   * \brief Copies a node and its operands into an interner, leaving out
+   * nodes that are not reachable from the copied node
+   *
+   * \tparam NODES a group node table type
+   * \tparam INTERNER a group node interner type
+   *
+   * \param nodes the source table
+   * \param node the index of the copied node in the source table
+   * \param result the interner receiving copied nodes
+   *
+   * \return the index of the copied node in the interner
+   */
+  template< class NODES, class INTERNER >
+    constexpr std::size_t copy_group_node
+    ( const NODES &nodes, std::size_t node, INTERNER &result )
+    {
+      auto copy = nodes.nodes[ node ];
+
+      if( copy.type != group_node_types::symbol )
+        copy.first = copy_group_node( nodes, copy.first, result );
+
+      if( copy.type == group_node_types::binary_group )
+        copy.second = copy_group_node( nodes, copy.second, result );
+
+      return result.add( copy );
+    }
+
+  /**
+   * \brief Simplifies a group node table, see simplify_group_node. Operands
+   * merged by the simplification are left out of the result. The result is
+   * meant to build automata used for recognition only, as groups are not
+   * preserved
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the table to simplify
+   *
+   * \return the simplified table, without any group, identical nodes being
+   * shared
+   */
+  template< class NODES >
+    constexpr NODES simplify_group_nodes( const NODES &nodes )
+    {
+      group_node_interner< NODES::node_capacity > simplified;
+      group_node_interner< NODES::node_capacity > result;
+
+      const auto root = simplify_group_node( nodes, nodes.root, simplified );
+
+      result.table.root =
+        copy_group_node( simplified.table, root, result );
+
+      return result.table;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_GROUP_SIMPLIFICATION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains algebraic simplification passes on group node tables,
+ * reducing the size of automata built for recognition
+ */
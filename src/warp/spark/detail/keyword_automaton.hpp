@@ -0,0 +1,711 @@
+#ifndef _WARP_SPARK_DETAIL_KEYWORD_AUTOMATON_HPP_
+#define _WARP_SPARK_DETAIL_KEYWORD_AUTOMATON_HPP_
+
+#include "../../core/numeric.hpp"
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "group_node_table.hpp"
+#include "letter_set.hpp"
+#include "literal_analysis.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Literals of a grammar made only of alternations of literals, in
+   * the order of their groups
+   *
+   * \tparam CAPACITY the maximum number of keywords
+   */
+  template< std::size_t CAPACITY >
+    struct keyword_set
+    {
+      /**
+       * \brief Indicates if the grammar is an alternation of literals
+       */
+      bool is_keyword_set = false;
+
+      /**
+       * \brief The number of keywords
+       */
+      std::size_t count = 0;
+
+      /**
+       * \brief The number of letters of all keywords
+       */
+      std::size_t letter_count = 0;
+
+      /**
+       * \brief The length of the longest keyword
+       */
+      std::size_t longest = 0;
+
+      /**
+       * \brief Keywords storage
+       */
+      std::array< literal, CAPACITY > keywords {};
+    };
+
+  /**
+   * \brief Collects keywords of a grammar, going down alternations and
+   * groups matching their operand once until exact literals are met. Any
+   * other construct makes the grammar something else than a keyword set.
+   *
+   * \tparam SET a keyword set type
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return the keyword set, is_keyword_set being false if the grammar is not
+   * an alternation of literals
+   */
+  template< class SET, class NODES >
+    constexpr SET collect_keywords( const NODES &nodes )
+    {
+      const auto infos = analyze_node_literals( nodes );
+
+      SET result;
+      std::array< std::size_t, NODES::node_capacity > pending {};
+      std::size_t top = 0;
+
+      pending[ top++ ] = nodes.root;
+
+      while( top != 0 )
+      {
+        const auto n = pending[ --top ];
+        const auto &node = nodes.nodes[ n ];
+        const auto &info = infos[ n ];
+
+        if( info.is_exact && info.prefix.size != 0 )
+        {
+          result.keywords[ result.count++ ] = info.prefix;
+          result.letter_count += info.prefix.size;
+
+          if( info.prefix.size > result.longest )
+            result.longest = info.prefix.size;
+
+          continue;
+        }
+
+        // right operands are pushed first to keep keywords in group order
+        if( node.type == group_node_types::binary_group &&
+            node.binary_closure == group_binary_closures::alternation )
+        {
+          pending[ top++ ] = node.second;
+          pending[ top++ ] = node.first;
+
+          continue;
+        }
+
+        if( node.type == group_node_types::unary_group &&
+            node.unary_closure == group_unary_closures::one_one )
+        {
+          pending[ top++ ] = node.first;
+
+          continue;
+        }
+
+        return SET {};
+      }
+
+      result.is_keyword_set = true;
+
+      return result;
+    }
+
+  /**
+   * \brief Prefix tree of a keyword set, each node being reached by a single
+   * letter from its parent. The root is the node 0. Letters are represented
+   * by dense codes, from 1 for the smallest letter used by keywords, the code
+   * 0 being given to all letters used by no keyword.
+   *
+   * \tparam CAPACITY the maximum number of nodes
+   */
+  template< std::size_t CAPACITY >
+    struct keyword_trie
+    {
+      /**
+       * \brief Exposes the node capacity
+       */
+      static constexpr std::size_t capacity = CAPACITY;
+
+      /**
+       * \brief The number of nodes
+       */
+      std::size_t node_count = 1;
+
+      /**
+       * \brief The number of letter codes, the code 0 included
+       */
+      std::size_t code_count = 1;
+
+      /**
+       * \brief The code of each letter
+       */
+      std::array< std::size_t, letter_set::letter_count > codes {};
+
+      /**
+       * \brief The parent of each node
+       */
+      std::array< std::size_t, CAPACITY > parents {};
+
+      /**
+       * \brief The code of the letter leading to each node from its parent
+       */
+      std::array< std::size_t, CAPACITY > letters {};
+
+      /**
+       * \brief The first child of each node, 0 if there is none
+       */
+      std::array< std::size_t, CAPACITY > first_children {};
+
+      /**
+       * \brief The next sibling of each node, 0 if there is none
+       */
+      std::array< std::size_t, CAPACITY > next_siblings {};
+
+      /**
+       * \brief The keyword ending at each node, plus 1, 0 if there is none
+       */
+      std::array< std::size_t, CAPACITY > keywords {};
+
+      /**
+       * \brief Nodes in breadth first order
+       */
+      std::array< std::size_t, CAPACITY > order {};
+    };
+
+  /**
+   * \brief Builds the prefix tree of a keyword set. A keyword found twice
+   * keeps its first index.
+   *
+   * \tparam TRIE a keyword trie type, able to hold a node per letter of the
+   * set, plus the root
+   * \tparam SET a keyword set type
+   *
+   * \param set the keyword set
+   *
+   * \return the prefix tree
+   */
+  template< class TRIE, class SET >
+    constexpr TRIE build_keyword_trie( const SET &set )
+    {
+      TRIE result;
+      letter_set used;
+
+      for( std::size_t k = 0; k < set.count; ++k )
+        for( std::size_t l = 0; l < set.keywords[ k ].size; ++l )
+          used.insert
+            ( static_cast< unsigned char >( set.keywords[ k ].letters[ l ] ) );
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        if( used.contains( static_cast< unsigned char >( l ) ) )
+          result.codes[ l ] = result.code_count++;
+
+      for( std::size_t k = 0; k < set.count; ++k )
+      {
+        const auto &keyword = set.keywords[ k ];
+        std::size_t node = 0;
+
+        for( std::size_t l = 0; l < keyword.size; ++l )
+        {
+          const auto letter =
+            result.codes
+              [ static_cast< unsigned char >( keyword.letters[ l ] ) ];
+          auto child = result.first_children[ node ];
+
+          while( child != 0 && result.letters[ child ] != letter )
+            child = result.next_siblings[ child ];
+
+          if( child == 0 )
+          {
+            child = result.node_count++;
+            result.parents[ child ] = node;
+            result.letters[ child ] = letter;
+            result.next_siblings[ child ] = result.first_children[ node ];
+            result.first_children[ node ] = child;
+          }
+
+          node = child;
+        }
+
+        if( result.keywords[ node ] == 0 )
+          result.keywords[ node ] = k + 1;
+      }
+
+      for( std::size_t head = 0, tail = 1; head < tail; ++head )
+        for( auto child = result.first_children[ result.order[ head ] ];
+             child != 0;
+             child = result.next_siblings[ child ] )
+          result.order[ tail++ ] = child;
+
+      return result;
+    }
+
+  /**
+   * \brief Placement of trie nodes in a double array. Children of a node
+   * stored in the cell s are stored in cells bases[ s ] + letter code.
+   *
+   * \tparam CAPACITY the node capacity of the trie
+   */
+  template< std::size_t CAPACITY >
+    struct double_array_layout
+    {
+      /**
+       * \brief Indicates if all nodes have been placed
+       */
+      bool is_complete = true;
+
+      /**
+       * \brief The number of cells used, that is, the last used cell plus 1
+       */
+      std::size_t size = 1;
+
+      /**
+       * \brief The cell of each node
+       */
+      std::array< std::size_t, CAPACITY > cells {};
+
+      /**
+       * \brief The base of each node
+       */
+      std::array< std::size_t, CAPACITY > bases {};
+    };
+
+  /**
+   * \brief Places trie nodes in a double array, breadth first, choosing for
+   * each node the smallest base whose cells are free for all its children.
+   * The root lies in the cell 0 and leaves use the base 0.
+   *
+   * \tparam TRIE a keyword trie type
+   *
+   * \param trie the trie to place
+   *
+   * \return the placement, incomplete if more cells than twice the number of
+   * nodes plus two alphabets are needed
+   */
+  template< class TRIE >
+    constexpr double_array_layout< TRIE::capacity >
+    place_double_array( const TRIE &trie )
+    {
+      constexpr auto work_size =
+        2 * TRIE::capacity + 2 * letter_set::letter_count;
+
+      double_array_layout< TRIE::capacity > result;
+      std::array< bool, work_size > used {};
+
+      used[ 0 ] = true;
+
+      for( std::size_t i = 0; i < trie.node_count; ++i )
+      {
+        const auto node = trie.order[ i ];
+
+        if( trie.first_children[ node ] == 0 )
+          continue;
+
+        std::size_t base = 1;
+
+        for( bool fits = false; ! fits; )
+        {
+          if( base + trie.code_count > work_size )
+          {
+            result.is_complete = false;
+
+            return result;
+          }
+
+          fits = true;
+
+          for( auto child = trie.first_children[ node ];
+               child != 0 && fits;
+               child = trie.next_siblings[ child ] )
+            fits = ! used[ base + trie.letters[ child ] ];
+
+          if( ! fits )
+            ++base;
+        }
+
+        result.bases[ node ] = base;
+
+        for( auto child = trie.first_children[ node ];
+             child != 0;
+             child = trie.next_siblings[ child ] )
+        {
+          const auto cell = base + trie.letters[ child ];
+
+          used[ cell ] = true;
+          result.cells[ child ] = cell;
+
+          if( cell + 1 > result.size )
+            result.size = cell + 1;
+        }
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Aho-Corasick automaton of a keyword set, stored as a double array.
+   * Letters are first mapped to dense codes, then the transition of the
+   * state s on a code leads to the cell base[ s ] + code if
+   * check[ that cell ] is s ; otherwise, the failure
+   * link of s is followed. Each state knows the keyword ending on it, if
+   * any, and the next state of its failure chain ending a keyword, thus,
+   * all matches are reported without walking failure chains.
+   *
+   * \tparam SIZE the number of cells of the double array
+   * \tparam KEYWORD_COUNT the number of keywords
+   * \tparam CODE_COUNT the number of letter codes
+   */
+  template
+    <
+      std::size_t SIZE,
+      std::size_t KEYWORD_COUNT,
+      std::size_t CODE_COUNT
+    >
+    struct keyword_automaton
+    {
+      /**
+       * \brief The smallest type able to hold a cell index
+       */
+      using cell_type = unsigned_auto_constant_t< SIZE >;
+
+      /**
+       * \brief The smallest type able to hold a keyword index plus 1
+       */
+      using keyword_type = unsigned_auto_constant_t< KEYWORD_COUNT >;
+
+      /**
+       * \brief The smallest type able to hold a letter code
+       */
+      using code_type = unsigned_auto_constant_t< CODE_COUNT - 1 >;
+
+      /**
+       * \brief Exposes the number of cells
+       */
+      static constexpr std::size_t size = SIZE;
+
+      /**
+       * \brief Exposes the number of keywords
+       */
+      static constexpr std::size_t keyword_count = KEYWORD_COUNT;
+
+      /**
+       * \brief The root state
+       */
+      static constexpr std::size_t root = 0;
+
+      /**
+       * \brief Marks the absence of a state
+       */
+      static constexpr std::size_t no_state = SIZE;
+
+      /**
+       * \brief Builds an automaton without any transition
+       */
+      constexpr keyword_automaton()
+      {
+        for( std::size_t c = 0; c < checks.size(); ++c )
+          checks[ c ] = static_cast< cell_type >( no_state );
+
+        for( std::size_t c = 0; c < SIZE; ++c )
+          next_outputs[ c ] = static_cast< cell_type >( no_state );
+      }
+
+      /**
+       * \brief Follows the trie edge leaving a state on a letter code
+       *
+       * \param state the source state
+       * \param code the letter code
+       *
+       * \return the target state, no_state if there is no such edge
+       */
+      constexpr std::size_t child( std::size_t state, std::size_t code ) const
+      {
+        const std::size_t target = bases[ state ] + code;
+
+        return checks[ target ] == state ? target : no_state;
+      }
+
+      /**
+       * \brief Computes the state reached from a state on a letter, following
+       * failure links as needed
+       *
+       * \param state the source state
+       * \param letter the letter
+       *
+       * \return the target state
+       */
+      constexpr std::size_t step( std::size_t state, unsigned char letter )
+      const
+      {
+        const std::size_t code = codes[ letter ];
+
+        for( ;; )
+        {
+          const auto target = child( state, code );
+
+          if( target != no_state )
+            return target;
+
+          if( state == root )
+            return root;
+
+          state = failures[ state ];
+        }
+      }
+
+      /**
+       * \brief Gives the first state of the failure chain of a state ending a
+       * keyword, the state itself included
+       *
+       * \param state a state
+       *
+       * \return the first state ending a keyword, no_state if there is none
+       */
+      constexpr std::size_t first_output( std::size_t state ) const
+      { return outputs[ state ] != 0 ? state : next_outputs[ state ]; }
+
+      /**
+       * \brief The length of the longest keyword
+       */
+      std::size_t longest = 0;
+
+      /**
+       * \brief The code of each letter
+       */
+      std::array< code_type, letter_set::letter_count > codes {};
+
+      /**
+       * \brief Base of each state
+       */
+      std::array< cell_type, SIZE > bases {};
+
+      /**
+       * \brief Owner of each cell, padded by a cell per letter code to avoid
+       * bound checking
+       */
+      std::array< cell_type, SIZE + CODE_COUNT > checks {};
+
+      /**
+       * \brief Failure link of each state
+       */
+      std::array< cell_type, SIZE > failures {};
+
+      /**
+       * \brief The keyword ending on each state, plus 1, 0 if there is none
+       */
+      std::array< keyword_type, SIZE > outputs {};
+
+      /**
+       * \brief The next state of the failure chain of each state ending a
+       * keyword
+       */
+      std::array< cell_type, SIZE > next_outputs {};
+
+      /**
+       * \brief The length of each keyword
+       */
+      std::array< std::size_t, KEYWORD_COUNT > lengths {};
+    };
+
+  /**
+   * \brief Builds the Aho-Corasick automaton of a keyword set from its
+   * placed trie. Failure links are computed breadth first, each one relying
+   * on links of shallower states.
+   *
+   * \tparam AUTOMATON a keyword automaton type, sized using the layout
+   * \tparam SET a keyword set type
+   * \tparam TRIE a keyword trie type
+   * \tparam LAYOUT a double array layout type
+   *
+   * \param set the keyword set
+   * \param trie the prefix tree of the set
+   * \param layout the placement of the trie
+   *
+   * \return the automaton
+   */
+  template< class AUTOMATON, class SET, class TRIE, class LAYOUT >
+    constexpr AUTOMATON build_keyword_automaton
+    ( const SET &set, const TRIE &trie, const LAYOUT &layout )
+    {
+      using cell_type = typename AUTOMATON::cell_type;
+      using keyword_type = typename AUTOMATON::keyword_type;
+
+      using code_type = typename AUTOMATON::code_type;
+
+      AUTOMATON result;
+
+      result.longest = set.longest;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        result.codes[ l ] = static_cast< code_type >( trie.codes[ l ] );
+
+      for( std::size_t k = 0; k < AUTOMATON::keyword_count; ++k )
+        result.lengths[ k ] = set.keywords[ k ].size;
+
+      for( std::size_t n = 0; n < trie.node_count; ++n )
+      {
+        const auto cell = layout.cells[ n ];
+
+        result.bases[ cell ] = static_cast< cell_type >( layout.bases[ n ] );
+        result.outputs[ cell ] =
+          static_cast< keyword_type >( trie.keywords[ n ] );
+
+        if( n != 0 )
+          result.checks[ cell ] =
+            static_cast< cell_type >( layout.cells[ trie.parents[ n ] ] );
+      }
+
+      for( std::size_t i = 1; i < trie.node_count; ++i )
+      {
+        const auto node = trie.order[ i ];
+        const auto cell = layout.cells[ node ];
+        const auto parent = layout.cells[ trie.parents[ node ] ];
+        const auto code = trie.letters[ node ];
+
+        std::size_t failure = AUTOMATON::root;
+
+        if( parent != AUTOMATON::root )
+          for( std::size_t state = result.failures[ parent ]; ; )
+          {
+            const auto target = result.child( state, code );
+
+            if( target != AUTOMATON::no_state )
+            {
+              failure = target;
+
+              break;
+            }
+
+            if( state == AUTOMATON::root )
+              break;
+
+            state = result.failures[ state ];
+          }
+
+        result.failures[ cell ] = static_cast< cell_type >( failure );
+        result.next_outputs[ cell ] =
+          static_cast< cell_type >( result.first_output( failure ) );
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Reports all keyword occurrences of an input, overlapping ones
+   * included, in the order of their end
+   *
+   * \tparam AUTOMATON a keyword automaton type
+   * \tparam FUNCTION a callable type, taking the keyword index, the offset of
+   * its first letter and the offset after its last letter, returning false to
+   * stop the scan
+   *
+   * \param automaton the automaton
+   * \param input the input to scan
+   * \param function the function called for each occurrence
+   */
+  template< class AUTOMATON, class FUNCTION >
+    constexpr void scan_keywords
+    ( const AUTOMATON &automaton, std::string_view input, FUNCTION &&function )
+    {
+      std::size_t state = AUTOMATON::root;
+
+      for( std::size_t o = 0; o < input.size(); ++o )
+      {
+        state =
+          automaton.step( state, static_cast< unsigned char >( input[ o ] ) );
+
+        for( auto output = automaton.first_output( state );
+             output != AUTOMATON::no_state;
+             output = automaton.next_outputs[ output ] )
+        {
+          const std::size_t keyword = automaton.outputs[ output ] - 1;
+
+          if( ! function
+                  ( keyword, o + 1 - automaton.lengths[ keyword ], o + 1 ) )
+            return;
+        }
+      }
+    }
+
+  /**
+   * \brief Compiles a grammar made of alternations of literals into an
+   * Aho-Corasick automaton. Other grammars give an empty keyword set and
+   * is_keyword_grammar is false.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct keyword_grammar
+    {
+      /**
+       * \brief The flattened group tree, identical subtrees being shared
+       */
+      static constexpr auto &nodes = group_dag_from< GRAMMAR >::value;
+
+      /**
+       * \brief The type of the keyword set, able to hold a keyword per node
+       */
+      using keyword_set_type =
+        keyword_set
+          < group_dag_from< GRAMMAR >::table_type::node_capacity >;
+
+      /**
+       * \brief Keywords of the grammar
+       */
+      static constexpr keyword_set_type keywords =
+        collect_keywords< keyword_set_type >( nodes );
+
+      /**
+       * \brief Indicates if the grammar is an alternation of literals
+       */
+      static constexpr bool is_keyword_grammar = keywords.is_keyword_set;
+
+      /**
+       * \brief The type of the prefix tree
+       */
+      using trie_type = keyword_trie< keywords.letter_count + 1 >;
+
+      /**
+       * \brief The prefix tree of keywords
+       */
+      static constexpr trie_type trie =
+        build_keyword_trie< trie_type >( keywords );
+
+      /**
+       * \brief The placement of the prefix tree in a double array
+       */
+      static constexpr double_array_layout< trie_type::capacity > layout =
+        place_double_array( trie );
+
+      static_assert( layout.is_complete,
+                     "Invalid grammar used. Keywords are too sparse to be "
+                     "placed in a double array." );
+
+      /**
+       * \brief The type of the automaton, with exact sizes
+       */
+      using automaton_type =
+        keyword_automaton
+          < layout.size, keywords.count, trie.code_count >;
+
+      /**
+       * \brief The Aho-Corasick automaton of keywords
+       */
+      static constexpr automaton_type automaton =
+        build_keyword_automaton< automaton_type >( keywords, trie, layout );
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_KEYWORD_AUTOMATON_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compile-time Aho-Corasick automaton of grammars made
+ * of alternations of literals, stored as a double array
+ */
@@ -0,0 +1,229 @@
+#ifndef _WARP_SPARK_DETAIL_LETTER_CLASSES_HPP_
+#define _WARP_SPARK_DETAIL_LETTER_CLASSES_HPP_
+
+#include "letter_set.hpp"
+#include "automaton_traits.hpp"
+#include "automaton_t_function_traits.hpp"
+#include "automaton_t_function_args.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Partition of letters into equivalence classes. Two letters are in
+   * the same class if every letter set used to build the partition contains
+   * both or none of them. Thus, an automaton built upon these letter sets
+   * behaves identically for all letters of a class and its table may use a
+   * column per class instead of a column per letter. Classes are numbered in
+   * the order of their smallest letter
+   */
+  struct letter_classes
+  {
+    /**
+     * \brief Builds the trivial partition, made of a single class
+     */
+    constexpr letter_classes() : class_of {}, class_count { 1 } {}
+
+    /**
+     * \brief Splits existing classes so that the specified set is an union of
+     * classes
+     *
+     * \param set the set of letters refining the partition
+     */
+    constexpr void refine( const letter_set &set )
+    {
+      std::array< bool, letter_set::letter_count > inside {};
+      std::array< bool, letter_set::letter_count > outside {};
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        if( set.contains( static_cast< unsigned char >( l ) ) )
+          inside[ class_of[ l ] ] = true;
+        else
+          outside[ class_of[ l ] ] = true;
+
+      std::array< std::size_t, letter_set::letter_count > split {};
+
+      for( std::size_t c = 0; c < class_count; ++c )
+        split[ c ] = inside[ c ] && outside[ c ] ? class_count + c : c;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        if( set.contains( static_cast< unsigned char >( l ) ) )
+          class_of[ l ] = split[ class_of[ l ] ];
+
+      normalize();
+    }
+
+    /**
+     * \brief Gives the set of letters belonging to a class
+     *
+     * \param klass a class index
+     *
+     * \return all letters of the class
+     */
+    constexpr letter_set letters_of( std::size_t klass ) const
+    {
+      letter_set result;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        if( class_of[ l ] == klass )
+          result.insert( static_cast< unsigned char >( l ) );
+
+      return result;
+    }
+
+    /**
+     * \brief The class of each letter
+     */
+    std::array< std::size_t, letter_set::letter_count > class_of;
+
+    /**
+     * \brief The number of classes in the partition
+     */
+    std::size_t class_count;
+
+  private :
+    /**
+     * \brief Renumbers classes in the order of their smallest letter, making
+     * the partition independent of the refinement order
+     */
+    constexpr void normalize()
+    {
+      std::array< std::size_t, 2 * letter_set::letter_count > renumbered {};
+      std::array< bool, 2 * letter_set::letter_count > known {};
+      std::size_t count = 0;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+      {
+        if( ! known[ class_of[ l ] ] )
+        {
+          known[ class_of[ l ] ] = true;
+          renumbered[ class_of[ l ] ] = count++;
+        }
+
+        class_of[ l ] = renumbered[ class_of[ l ] ];
+      }
+
+      class_count = count;
+    }
+  };
+
+  /**
+   * \brief Gives the set of letters a transition function argument deals with.
+   * The argument is assumed to be a valid symbol
+   *
+   * \tparam FN_ARG the argument of a transition function
+   */
+  template< class FN_ARG >
+    struct t_function_letters
+    {
+      /**
+       * \brief Letters recognized by the symbol
+       */
+      static constexpr letter_set value = letter_set_of< FN_ARG >::value;
+    };
+
+  /**
+   * \brief Specialization for an epsilon transition, that does not consume
+   * any letter
+   */
+  template<>
+    struct t_function_letters< epsilon_transition >
+    {
+      /**
+       * \brief No letter at all
+       */
+      static constexpr letter_set value {};
+    };
+
+  /**
+   * \brief Computes letter classes of an automaton, refining the partition
+   * with letters of each symbol used by transition functions. This
+   * unspecialized version is used when the provided type does not have the
+   * template signature of an automaton
+   *
+   * \tparam AUTOMATON a type that is not an automaton
+   */
+  template< class AUTOMATON >
+    struct letter_classes_from
+    {
+      static_assert( automaton_traits< AUTOMATON >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+    };
+
+  /**
+   * \brief Specialization used with a type looking like an automaton
+   *
+   * \tparam AUTOMATON template signature for an automaton
+   * \tparam STATES the state sequence of the automaton
+   * \tparam T_FUNCTION_SEQUENCE the type sequence template holding transition
+   * functions
+   * \tparam T_FUNCTIONS transition functions of the automaton
+   * \tparam G_COMMANDS the group command sequence of the automaton
+   */
+  template
+    <
+      template< class, class, class > class AUTOMATON,
+      class STATES,
+      template< class... > class T_FUNCTION_SEQUENCE, class... T_FUNCTIONS,
+      class G_COMMANDS
+    >
+    struct letter_classes_from
+    <
+      AUTOMATON< STATES, T_FUNCTION_SEQUENCE< T_FUNCTIONS... >, G_COMMANDS >
+    >
+    {
+      static_assert( automaton_traits
+                       <
+                         AUTOMATON
+                           <
+                             STATES,
+                             T_FUNCTION_SEQUENCE< T_FUNCTIONS... >,
+                             G_COMMANDS
+                           >
+                       >::is_automaton,
+                     "Invalid type used. Only automaton types are allowed." );
+
+    private :
+      /**
+       * \brief Refines the partition with each transition function letters
+       *
+       * \return the resulting partition
+       */
+      static constexpr letter_classes make()
+      {
+        constexpr letter_set sets[] =
+        {
+          t_function_letters
+            <
+              typename automaton_t_function_traits< T_FUNCTIONS >::
+                function_argument
+            >::value...
+        };
+
+        letter_classes result;
+
+        for( const auto &set : sets )
+          result.refine( set );
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The letter partition of the automaton
+       */
+      static constexpr letter_classes value = make();
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_LETTER_CLASSES_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the computation of letter equivalence classes, used to
+ * compress automaton tables
+ */
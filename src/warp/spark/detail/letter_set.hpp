@@ -0,0 +1,263 @@
+#ifndef _WARP_SPARK_DETAIL_LETTER_SET_HPP_
+#define _WARP_SPARK_DETAIL_LETTER_SET_HPP_
+
+#include "../symbol_traits.hpp"
+#include "../regular_grammar_type_system_enumerations.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief A compile-time usable set of letters. A letter is a byte, thus, the
+   * set holds 256 bits stored in 4 words. It is the value representation of
+   * what a symbol recognizes, used by automaton tables to describe transitions
+   */
+  class letter_set
+  {
+  public :
+    /**
+     * \brief The number of distinct letters a set can contain
+     */
+    static constexpr std::size_t letter_count = 256;
+
+    /**
+     * \brief Builds an empty set
+     */
+    constexpr letter_set() : words_ {} {}
+
+    /**
+     * \brief Builds a set containing all possible letters
+     *
+     * \return a set containing all letters
+     */
+    static constexpr letter_set all()
+    { return letter_set {}.complement(); }
+
+    /**
+     * \brief Adds a letter in the set
+     *
+     * \param letter the letter to add
+     */
+    constexpr void insert( unsigned char letter )
+    { words_[ letter / 64 ] |= std::uint64_t { 1 } << ( letter % 64 ); }
+
+    /**
+     * \brief Indicates if a letter is part of this set
+     *
+     * \param letter the letter to look for
+     *
+     * \return true if the letter is in the set, false otherwise
+     */
+    constexpr bool contains( unsigned char letter ) const
+    { return ( words_[ letter / 64 ] >> ( letter % 64 ) ) & 1; }
+
+    /**
+     * \brief Indicates if the set does not contain any letter
+     *
+     * \return true if the set is empty, false otherwise
+     */
+    constexpr bool empty() const
+    { return ( words_[ 0 ] | words_[ 1 ] | words_[ 2 ] | words_[ 3 ] ) == 0; }
+
+    /**
+     * \brief Computes the set containing all letters that are not in this one
+     *
+     * \return the complement of this set
+     */
+    constexpr letter_set complement() const
+    {
+      letter_set result;
+
+      for( std::size_t i = 0; i < 4; ++i )
+        result.words_[ i ] = ~words_[ i ];
+
+      return result;
+    }
+
+    /**
+     * \brief Union of two sets
+     *
+     * \param other the set to merge with this one
+     *
+     * \return a set containing letters of both sets
+     */
+    constexpr letter_set operator | ( const letter_set &other ) const
+    {
+      letter_set result;
+
+      for( std::size_t i = 0; i < 4; ++i )
+        result.words_[ i ] = words_[ i ] | other.words_[ i ];
+
+      return result;
+    }
+
+    /**
+     * \brief Intersection of two sets
+     *
+     * \param other the set to intersect with this one
+     *
+     * \return a set containing letters shared by both sets
+     */
+    constexpr letter_set operator & ( const letter_set &other ) const
+    {
+      letter_set result;
+
+      for( std::size_t i = 0; i < 4; ++i )
+        result.words_[ i ] = words_[ i ] & other.words_[ i ];
+
+      return result;
+    }
+
+    /**
+     * \brief Equality of two sets
+     *
+     * \param other the set to compare with this one
+     *
+     * \return true if both sets contain exactly the same letters
+     */
+    constexpr bool operator == ( const letter_set &other ) const
+    {
+      for( std::size_t i = 0; i < 4; ++i )
+        if( words_[ i ] != other.words_[ i ] )
+          return false;
+
+      return true;
+    }
+
+    /**
+     * \brief Inequality of two sets
+     *
+     * \param other the set to compare with this one
+     *
+     * \return true if sets differ by at least one letter
+     */
+    constexpr bool operator != ( const letter_set &other ) const
+    { return ! ( *this == other ); }
+
+    /**
+     * \brief Computes a hash of the set, equal sets having equal hashes
+     *
+     * \return the hash of the set
+     */
+    constexpr std::uint64_t hash() const
+    {
+      std::uint64_t result = 0;
+
+      for( std::size_t i = 0; i < 4; ++i )
+        result = ( result ^ words_[ i ] ) * 0x100000001b3u;
+
+      return result;
+    }
+
+  private :
+    /**
+     * \brief Storage of the set, one bit per letter
+     */
+    std::array< std::uint64_t, 4 > words_;
+  };
+
+  /**
+   * \brief Builds a letter set containing all letters of an integral
+   * sequence. Unspecialized version, used for anything but an integral
+   * sequence, leading to an empty set
+   */
+  template< class >
+    struct letter_set_from_sequence
+    {
+      /**
+       * \brief Nothing to put inside the set
+       */
+      static constexpr letter_set value {};
+    };
+
+  /**
+   * \brief Specialization dealing with an integral sequence. Each value must
+   * be representable as a byte
+   *
+   * \tparam S the integral sequence template
+   * \tparam T the integral type used in the sequence
+   * \tparam VS the letters of the sequence
+   */
+  template< template< class U, U... > class S, class T, T... VS >
+    struct letter_set_from_sequence< S< T, VS... > >
+    {
+      static_assert( sizeof( T ) == 1,
+                     "Invalid type used. Only letter sequences made of byte "
+                     "sized integral values are allowed." );
+
+    private :
+      /**
+       * \brief Fills a set with letters of the sequence
+       *
+       * \return the filled set
+       */
+      static constexpr letter_set make()
+      {
+        letter_set result;
+
+        ( void )std::initializer_list< int >
+          { ( result.insert( static_cast< unsigned char >( VS ) ), 0 )..., 0 };
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The set containing all letters of the sequence
+       */
+      static constexpr letter_set value = make();
+    };
+
+  /**
+   * \brief Computes the set of letters a symbol recognizes. Relies on the
+   * symbol traits to know the symbol type
+   *
+   * \tparam SYMBOL a valid symbol type
+   */
+  template< class SYMBOL >
+    struct letter_set_of
+    {
+      static_assert( symbol_traits< SYMBOL >::is_symbol,
+                     "Invalid type used. Only symbol types are allowed." );
+
+    private :
+      /**
+       * \brief Letters explicitely specified in the symbol, if any
+       */
+      static constexpr auto letters =
+        letter_set_from_sequence
+          < typename symbol_traits< SYMBOL >::symbol_letter_sequence >::value;
+
+      /**
+       * \brief Symbol type, driving the computation of the resulting set
+       */
+      static constexpr auto type = symbol_traits< SYMBOL >::symbol_type;
+
+    public :
+      /**
+       * \brief The resulting set. An inclusive symbol recognizes its only
+       * letter, an exclusive one recognizes all but specified letters and an
+       * any symbol recognizes everything
+       */
+      static constexpr letter_set value =
+        type == symbol_types::inclusive ?
+          letters :
+          type == symbol_types::exclusive ?
+            letters.complement() :
+            letter_set::all();
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_LETTER_SET_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains a value representation of a set of letters, as well as a way
+ * to obtain such a set from a spark symbol type
+ */
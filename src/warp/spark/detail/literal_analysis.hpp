@@ -0,0 +1,332 @@
+#ifndef _WARP_SPARK_DETAIL_LITERAL_ANALYSIS_HPP_
+#define _WARP_SPARK_DETAIL_LITERAL_ANALYSIS_HPP_
+
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "group_node_table.hpp"
+#include "letter_set.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief A short string of letters, usable at compile time. Letters beyond
+   * the capacity are dropped by operations building literals, keeping each
+   * literal meaningful : a truncated prefix is still a prefix, and so on.
+   */
+  struct literal
+  {
+    /**
+     * \brief The maximum number of letters of a literal
+     */
+    static constexpr std::size_t capacity = 32;
+
+    /**
+     * \brief Builds a literal made of a single letter
+     *
+     * \param letter the letter
+     *
+     * \return the literal
+     */
+    static constexpr literal of( unsigned char letter )
+    {
+      literal result;
+
+      result.letters[ 0 ] = static_cast< char >( letter );
+      result.size = 1;
+
+      return result;
+    }
+
+    /**
+     * \brief Concatenates two literals, keeping the first letters if the
+     * capacity is exceeded
+     *
+     * \param other the literal to append
+     *
+     * \return the concatenation of both literals
+     */
+    constexpr literal append( const literal &other ) const
+    {
+      literal result = *this;
+
+      for( std::size_t l = 0; l < other.size && result.size < capacity; ++l )
+        result.letters[ result.size++ ] = other.letters[ l ];
+
+      return result;
+    }
+
+    /**
+     * \brief Concatenates two literals, keeping the last letters if the
+     * capacity is exceeded
+     *
+     * \param other the literal to append
+     *
+     * \return the concatenation of both literals
+     */
+    constexpr literal append_tail( const literal &other ) const
+    {
+      const auto total = size + other.size;
+      const auto skipped = total > capacity ? total - capacity : 0;
+
+      literal result;
+
+      for( std::size_t l = skipped; l < total; ++l )
+        result.letters[ result.size++ ] =
+          l < size ? letters[ l ] : other.letters[ l - size ];
+
+      return result;
+    }
+
+    /**
+     * \brief Computes the longest common prefix of two literals
+     *
+     * \param other the other literal
+     *
+     * \return the common prefix
+     */
+    constexpr literal common_prefix( const literal &other ) const
+    {
+      literal result;
+
+      while( result.size < size && result.size < other.size &&
+             letters[ result.size ] == other.letters[ result.size ] )
+      {
+        result.letters[ result.size ] = letters[ result.size ];
+        ++result.size;
+      }
+
+      return result;
+    }
+
+    /**
+     * \brief Computes the longest common suffix of two literals
+     *
+     * \param other the other literal
+     *
+     * \return the common suffix
+     */
+    constexpr literal common_suffix( const literal &other ) const
+    {
+      std::size_t common = 0;
+
+      while( common < size && common < other.size &&
+             letters[ size - common - 1 ] ==
+               other.letters[ other.size - common - 1 ] )
+        ++common;
+
+      literal result;
+
+      for( std::size_t l = size - common; l < size; ++l )
+        result.letters[ result.size++ ] = letters[ l ];
+
+      return result;
+    }
+
+    /**
+     * \brief Equality of two literals
+     *
+     * \param other the literal to compare with this one
+     *
+     * \return true if both literals have the same letters
+     */
+    constexpr bool operator == ( const literal &other ) const
+    {
+      if( size != other.size )
+        return false;
+
+      for( std::size_t l = 0; l < size; ++l )
+        if( letters[ l ] != other.letters[ l ] )
+          return false;
+
+      return true;
+    }
+
+    /**
+     * \brief Letters of the literal
+     */
+    std::array< char, capacity > letters {};
+
+    /**
+     * \brief The number of letters
+     */
+    std::size_t size = 0;
+  };
+
+  /**
+   * \brief Literals every input recognized by a grammar, or a part of it,
+   * has to contain
+   */
+  struct required_literals
+  {
+    /**
+     * \brief Indicates if the recognized language is exactly the literal
+     * stored in prefix, the only case where literals may be concatenated
+     */
+    bool is_exact = false;
+
+    /**
+     * \brief A literal starting every recognized input
+     */
+    literal prefix {};
+
+    /**
+     * \brief A literal ending every recognized input
+     */
+    literal suffix {};
+
+    /**
+     * \brief A literal contained in every recognized input, the longest one
+     * found by the analysis
+     */
+    literal factor {};
+  };
+
+  /**
+   * \brief Gives the longest of two literals
+   *
+   * \param left a literal
+   * \param right another literal
+   *
+   * \return the longest literal, left if both have the same size
+   */
+  constexpr literal longest_literal( const literal &left, const literal &right )
+  { return right.size > left.size ? right : left; }
+
+  /**
+   * \brief Analyzes a group node table to extract literals required by each
+   * node. Nodes are stored before the groups using them, thus, a single pass
+   * is enough. Symbols made of a single letter are literals, closures
+   * allowing zero occurrence require nothing, concatenations join literals
+   * and alternations keep what both operands share.
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return literals required by each node, in node order
+   */
+  template< class NODES >
+    constexpr std::array< required_literals, NODES::node_capacity >
+    analyze_node_literals( const NODES &nodes )
+    {
+      std::array< required_literals, NODES::node_capacity > infos {};
+
+      for( std::size_t n = 0; n < nodes.node_count; ++n )
+      {
+        const auto &node = nodes.nodes[ n ];
+        auto &info = infos[ n ];
+
+        if( node.type == group_node_types::symbol )
+        {
+          std::size_t count = 0;
+          std::size_t single = 0;
+
+          for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+            if( node.letters.contains( static_cast< unsigned char >( l ) ) )
+              ++count, single = l;
+
+          if( count == 1 )
+          {
+            info.is_exact = true;
+            info.prefix = info.suffix = info.factor =
+              literal::of( static_cast< unsigned char >( single ) );
+          }
+
+          continue;
+        }
+
+        const auto &a = infos[ node.first ];
+
+        if( node.type == group_node_types::unary_group )
+        {
+          switch( node.unary_closure )
+          {
+            case group_unary_closures::one_one :
+              info = a;
+              break;
+
+            case group_unary_closures::one_many :
+              info = a;
+              info.is_exact = false;
+              break;
+
+            default :
+              break;
+          }
+
+          continue;
+        }
+
+        const auto &b = infos[ node.second ];
+
+        if( node.binary_closure == group_binary_closures::alternation )
+        {
+          info.is_exact = a.is_exact && b.is_exact && a.prefix == b.prefix;
+          info.prefix = a.prefix.common_prefix( b.prefix );
+          info.suffix = a.suffix.common_suffix( b.suffix );
+          info.factor =
+            a.factor == b.factor ?
+              a.factor :
+              longest_literal( info.prefix, info.suffix );
+
+          continue;
+        }
+
+        info.is_exact =
+          a.is_exact && b.is_exact &&
+          a.prefix.size + b.prefix.size <= literal::capacity;
+        info.prefix = a.is_exact ? a.prefix.append( b.prefix ) : a.prefix;
+        info.suffix = b.is_exact ? a.suffix.append_tail( b.suffix ) : b.suffix;
+        info.factor =
+          longest_literal
+          (
+            longest_literal( a.factor, b.factor ),
+            longest_literal( a.suffix.append( b.prefix ),
+                             a.suffix.append_tail( b.prefix ) )
+          );
+      }
+
+      return infos;
+    }
+
+  /**
+   * \brief Analyzes a group node table to extract literals required by the
+   * grammar
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return literals required by the root of the table
+   */
+  template< class NODES >
+    constexpr required_literals analyze_literals( const NODES &nodes )
+    { return analyze_node_literals( nodes )[ nodes.root ]; }
+
+  /**
+   * \brief Literals required by a grammar, computed at compile time
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    struct required_literals_of
+    {
+      /**
+       * \brief Literals required by the grammar
+       */
+      static constexpr required_literals value =
+        analyze_literals( group_dag_from< GRAMMAR >::value );
+    };
+}
+
+#endif // _WARP_SPARK_DETAIL_LITERAL_ANALYSIS_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compile-time extraction of literals required by a
+ * grammar, used to prefilter inputs
+ */
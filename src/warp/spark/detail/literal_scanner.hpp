@@ -0,0 +1,134 @@
+#ifndef _WARP_SPARK_DETAIL_LITERAL_SCANNER_HPP_
+#define _WARP_SPARK_DETAIL_LITERAL_SCANNER_HPP_
+
+#include <cstddef>
+#include <cstring>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Looks for the first occurrence of a literal in a buffer. Candidate
+   * positions are found by comparing, a whole vector at a time, the first
+   * and the last letter of the literal with the buffer, then each candidate
+   * is verified. AVX2 vectors are used if available, SSE2 vectors otherwise,
+   * falling back to memchr on other targets.
+   *
+   * \param first the beginning of the buffer
+   * \param last the end of the buffer
+   * \param literal the first letter of the literal
+   * \param size the number of letters of the literal, at least 1
+   *
+   * \return a pointer to the first occurrence, last if there is none
+   */
+  inline const char *find_literal
+  ( const char *first, const char *last, const char *literal, std::size_t size )
+  {
+    if( static_cast< std::size_t >( last - first ) < size )
+      return last;
+
+    // the last position a literal may start at
+    const char *const end = last - size + 1;
+
+    // literals are short and candidates already match their first letter,
+    // a letter loop also spares compilers from misjudging the bounds of
+    // literals computed at compile time, as memcmp is prone to
+    const auto is_occurrence = [ & ]( const char *candidate )
+    {
+      for( std::size_t l = 1; l < size; ++l )
+        if( candidate[ l ] != literal[ l ] )
+          return false;
+
+      return true;
+    };
+
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+#if defined( __AVX2__ )
+    using vector = __m256i;
+    constexpr std::size_t width = 32;
+
+    const auto head = _mm256_set1_epi8( literal[ 0 ] );
+    const auto tail = _mm256_set1_epi8( literal[ size - 1 ] );
+
+    const auto candidates = [ & ]( const char *position )
+    {
+      const auto heads =
+        _mm256_cmpeq_epi8
+          ( head, _mm256_loadu_si256
+                    ( reinterpret_cast< const vector * >( position ) ) );
+      const auto tails =
+        _mm256_cmpeq_epi8
+          ( tail, _mm256_loadu_si256
+                    ( reinterpret_cast< const vector * >
+                        ( position + size - 1 ) ) );
+
+      return static_cast< unsigned >
+        ( _mm256_movemask_epi8( _mm256_and_si256( heads, tails ) ) );
+    };
+#else
+    using vector = __m128i;
+    constexpr std::size_t width = 16;
+
+    const auto head = _mm_set1_epi8( literal[ 0 ] );
+    const auto tail = _mm_set1_epi8( literal[ size - 1 ] );
+
+    const auto candidates = [ & ]( const char *position )
+    {
+      const auto heads =
+        _mm_cmpeq_epi8
+          ( head, _mm_loadu_si128
+                    ( reinterpret_cast< const vector * >( position ) ) );
+      const auto tails =
+        _mm_cmpeq_epi8
+          ( tail, _mm_loadu_si128
+                    ( reinterpret_cast< const vector * >
+                        ( position + size - 1 ) ) );
+
+      return static_cast< unsigned >
+        ( _mm_movemask_epi8( _mm_and_si128( heads, tails ) ) );
+    };
+#endif
+
+    for( ; static_cast< std::size_t >( end - first ) >= width; first += width )
+      for( auto mask = candidates( first ); mask != 0; mask &= mask - 1 )
+      {
+        const auto candidate = first + __builtin_ctz( mask );
+
+        if( is_occurrence( candidate ) )
+          return candidate;
+      }
+#endif
+
+    while( first < end )
+    {
+      const auto candidate =
+        static_cast< const char * >
+          ( std::memchr( first, literal[ 0 ], end - first ) );
+
+      if( candidate == nullptr )
+        return last;
+
+      if( is_occurrence( candidate ) )
+        return candidate;
+
+      first = candidate + 1;
+    }
+
+    return last;
+  }
+}
+
+#endif // _WARP_SPARK_DETAIL_LITERAL_SCANNER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the vectorized literal scanner used to skip input parts
+ * that cannot match a grammar
+ */
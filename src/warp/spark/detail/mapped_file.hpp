@@ -0,0 +1,137 @@
+#ifndef _WARP_SPARK_DETAIL_MAPPED_FILE_HPP_
+#define _WARP_SPARK_DETAIL_MAPPED_FILE_HPP_
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief A file mapped read-only in memory, for the lifetime of the object.
+   * The kernel is told the mapping is read sequentially, letting it read
+   * ahead aggressively and drop pages already read. Empty files are not
+   * mapped and give an empty buffer.
+   */
+  class mapped_file
+  {
+  public :
+    /**
+     * \brief Maps a file
+     *
+     * \param path the path of the file
+     *
+     * \throw std::system_error if the file cannot be opened or mapped
+     */
+    explicit mapped_file( const std::filesystem::path &path ) :
+      data_ { nullptr }, size_ { 0 }
+    {
+      const auto descriptor = ::open( path.c_str(), O_RDONLY );
+
+      if( descriptor == -1 )
+        throw std::system_error
+          ( errno, std::generic_category(), "Cannot open " + path.string() );
+
+      struct ::stat status {};
+
+      if( ::fstat( descriptor, &status ) == -1 )
+        fail( descriptor, "Cannot stat " + path.string() );
+
+      size_ = static_cast< std::size_t >( status.st_size );
+
+      if( size_ != 0 )
+      {
+        auto mapping =
+          ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+
+        if( mapping == MAP_FAILED )
+          fail( descriptor, "Cannot map " + path.string() );
+
+        // a hint only, a failure is harmless
+        ::madvise( mapping, size_, MADV_SEQUENTIAL );
+
+        data_ = static_cast< const char * >( mapping );
+      }
+
+      // the mapping stays valid once the descriptor is closed
+      ::close( descriptor );
+    }
+
+    /**
+     * \brief Mappings cannot be copied
+     */
+    mapped_file( const mapped_file & ) = delete;
+
+    /**
+     * \brief Mappings cannot be copied
+     */
+    mapped_file &operator = ( const mapped_file & ) = delete;
+
+    /**
+     * \brief Unmaps the file
+     */
+    ~mapped_file()
+    {
+      if( data_ != nullptr )
+        ::munmap( const_cast< char * >( data_ ), size_ );
+    }
+
+    /**
+     * \brief Gives the beginning of the mapping
+     *
+     * \return the first letter of the file, nullptr for an empty file
+     */
+    const char *data() const { return data_; }
+
+    /**
+     * \brief Gives the size of the mapping
+     *
+     * \return the number of letters of the file
+     */
+    std::size_t size() const { return size_; }
+
+  private :
+    /**
+     * \brief Closes the descriptor and reports the last error
+     *
+     * \param descriptor the descriptor to close
+     * \param what the description of the failed operation
+     *
+     * \throw std::system_error always
+     */
+    [[ noreturn ]] static void fail( int descriptor, const std::string &what )
+    {
+      const auto error = errno;
+
+      ::close( descriptor );
+
+      throw std::system_error( error, std::generic_category(), what );
+    }
+
+    /**
+     * \brief The beginning of the mapping
+     */
+    const char *data_;
+
+    /**
+     * \brief The size of the mapping
+     */
+    std::size_t size_;
+  };
+}
+
+#endif // _WARP_SPARK_DETAIL_MAPPED_FILE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the read-only memory mapping of files, for POSIX systems
+ */
@@ -0,0 +1,1520 @@
+#ifndef _WARP_SPARK_DETAIL_RUNTIME_COMPILED_GRAMMAR_HPP_
+#define _WARP_SPARK_DETAIL_RUNTIME_COMPILED_GRAMMAR_HPP_
+
+#include "../grammar_definition.hpp"
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "automaton_g_command_types.hpp"
+#include "automaton_minimization.hpp"
+#include "automaton_state_enumeration.hpp"
+#include "automaton_table.hpp"
+#include "bit_set.hpp"
+#include "group_node_table.hpp"
+#include "group_simplification.hpp"
+#include "letter_classes.hpp"
+#include "letter_set.hpp"
+#include "subset_construction.hpp"
+#include "thompson_nfa.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Run-time counterpart of group_node_table, nodes being stored in a
+   * growing storage
+   */
+  struct runtime_group_node_table
+  {
+    /**
+     * \brief Builds an empty table
+     *
+     * \param resource the memory resource of the storage
+     */
+    explicit runtime_group_node_table
+    ( std::pmr::memory_resource *resource =
+        std::pmr::get_default_resource() ) :
+      nodes( resource ) {}
+
+    /**
+     * \brief Adds a node in the table
+     *
+     * \param node the node to add
+     *
+     * \return the index of the added node
+     */
+    std::size_t add( const group_node &node )
+    {
+      nodes.push_back( node );
+
+      return node_count++;
+    }
+
+    /**
+     * \brief Computes the letter partition of all symbols of the table
+     *
+     * \return letter classes of the table
+     */
+    letter_classes classes() const
+    {
+      letter_classes result;
+
+      for( const auto &node : nodes )
+        if( node.type == group_node_types::symbol )
+          result.refine( node.letters );
+
+      return result;
+    }
+
+    /**
+     * \brief The number of nodes in the table
+     */
+    std::size_t node_count = 0;
+
+    /**
+     * \brief The index of the root node
+     */
+    std::size_t root = 0;
+
+    /**
+     * \brief The number of distinct groups
+     */
+    std::size_t group_count = 0;
+
+    /**
+     * \brief Nodes storage
+     */
+    std::pmr::vector< group_node > nodes;
+  };
+
+  /**
+   * \brief Run-time counterpart of group_node_interner. The storage of nodes
+   * is reserved once and never grows, thus, references on nodes stay valid
+   * while nodes are added, as rewriting algorithms expect
+   */
+  struct runtime_group_node_interner
+  {
+    /**
+     * \brief Builds an empty interner
+     *
+     * \param capacity the maximum number of nodes the table can hold
+     * \param resource the memory resource of the interner
+     */
+    runtime_group_node_interner
+    ( std::size_t capacity, std::pmr::memory_resource *resource ) :
+      table( resource ), buckets( resource )
+    { table.nodes.reserve( capacity ); }
+
+    /**
+     * \brief Adds a node in the table unless an identical node is present
+     *
+     * \param node the node to add
+     *
+     * \return the index of the added or the shared node
+     *
+     * \throw std::length_error if the table is full
+     */
+    std::size_t add( const group_node &node )
+    {
+      const auto hash = node.hash();
+      const auto range = buckets.equal_range( hash );
+
+      for( auto bucket = range.first; bucket != range.second; ++bucket )
+        if( table.nodes[ bucket->second ] == node )
+          return bucket->second;
+
+      if( table.nodes.size() == table.nodes.capacity() )
+        throw std::length_error { "Group node interner capacity exceeded" };
+
+      const auto result = table.add( node );
+
+      buckets.emplace( hash, result );
+
+      return result;
+    }
+
+    /**
+     * \brief The built table
+     */
+    runtime_group_node_table table;
+
+    /**
+     * \brief Node indices by node hash
+     */
+    std::pmr::unordered_multimap< std::uint64_t, std::size_t > buckets;
+  };
+
+  /**
+   * \brief Indexes groups of a definition in the pre-order of its tree, as
+   * group_names_of does for group types. A group already indexed is skipped
+   * with its operands, all of them being indexed already
+   *
+   * \param definition the definition
+   * \param group the index of the group to visit
+   * \param indices receives the index of each visited group
+   * \param group_count the number of indexed groups
+   */
+  inline void index_runtime_groups
+  (
+    const grammar_definition &definition, std::size_t group,
+    std::pmr::vector< std::size_t > &indices, std::size_t &group_count
+  )
+  {
+    if( indices[ group ] != std::numeric_limits< std::size_t >::max() )
+      return;
+
+    const auto &current = definition.groups[ group ];
+
+    indices[ group ] = group_count++;
+
+    if( ! current.is_first_symbol )
+      index_runtime_groups( definition, current.first, indices, group_count );
+
+    if( current.is_binary )
+      index_runtime_groups
+        ( definition, current.second, indices, group_count );
+  }
+
+  /**
+   * \brief Adds nodes of a group and its operands in an interner, in the
+   * order group_node_builder adds nodes of group types. A group always
+   * giving the same node, nodes of a group are only built once
+   *
+   * \param definition the definition
+   * \param group the index of the group to add
+   * \param indices the index of each group
+   * \param built the node of each already built group
+   * \param result the interner receiving nodes
+   *
+   * \return the index of the node of the group
+   */
+  inline std::size_t add_runtime_group_nodes
+  (
+    const grammar_definition &definition, std::size_t group,
+    const std::pmr::vector< std::size_t > &indices,
+    std::pmr::vector< std::size_t > &built,
+    runtime_group_node_interner &result
+  )
+  {
+    if( built[ group ] != std::numeric_limits< std::size_t >::max() )
+      return built[ group ];
+
+    const auto &current = definition.groups[ group ];
+
+    group_node node {};
+
+    node.group = indices[ group ];
+
+    if( current.is_first_symbol )
+    {
+      group_node symbol {};
+
+      symbol.type = group_node_types::symbol;
+      symbol.letters = definition.symbols[ current.first ].letters;
+      node.first = result.add( symbol );
+    }
+    else
+      node.first =
+        add_runtime_group_nodes
+          ( definition, current.first, indices, built, result );
+
+    if( current.is_binary )
+    {
+      node.type = group_node_types::binary_group;
+      node.binary_closure = current.binary_closure;
+      node.second =
+        add_runtime_group_nodes
+          ( definition, current.second, indices, built, result );
+    }
+    else
+    {
+      node.type = group_node_types::unary_group;
+      node.unary_closure = current.unary_closure;
+    }
+
+    return built[ group ] = result.add( node );
+  }
+
+  /**
+   * \brief Flattens a definition into a group node table sharing identical
+   * subtrees, the run-time counterpart of group_dag_from. The table is the
+   * one built from group types describing the same tree
+   *
+   * \param definition the definition, having at least a group
+   * \param resource the memory resource of the table
+   *
+   * \return the table, whose root is the last group of the definition
+   */
+  inline runtime_group_node_table runtime_group_dag_from
+  (
+    const grammar_definition &definition,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    constexpr auto unknown = std::numeric_limits< std::size_t >::max();
+
+    const auto group_count = definition.groups.size();
+    const auto root = group_count - 1;
+
+    std::pmr::vector< std::size_t > indices( group_count, unknown, resource );
+    std::pmr::vector< std::size_t > built( group_count, unknown, resource );
+    runtime_group_node_interner result
+      { group_count + definition.symbols.size(), resource };
+
+    index_runtime_groups( definition, root, indices, result.table.group_count );
+
+    result.table.root =
+      add_runtime_group_nodes( definition, root, indices, built, result );
+
+    return std::move( result.table );
+  }
+
+  /**
+   * \brief Simplifies a run-time group node table, see simplify_group_nodes
+   *
+   * \param nodes the table to simplify
+   * \param resource the memory resource of the simplified table
+   *
+   * \return the simplified table, without any group
+   */
+  inline runtime_group_node_table simplify_runtime_group_nodes
+  (
+    const runtime_group_node_table &nodes,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    // a rewritten node never gives more than one node
+    runtime_group_node_interner simplified { nodes.node_count, resource };
+    runtime_group_node_interner result { nodes.node_count, resource };
+
+    const auto root = simplify_group_node( nodes, nodes.root, simplified );
+
+    result.table.root = copy_group_node( simplified.table, root, result );
+
+    return std::move( result.table );
+  }
+
+  /**
+   * \brief Run-time counterpart of thompson_nfa, edges and commands being
+   * stored in growing storages. Thompson construction algorithms work with
+   * both
+   */
+  struct runtime_thompson_nfa
+  {
+    /**
+     * \brief Builds an empty automaton
+     *
+     * \param resource the memory resource of the storages
+     */
+    explicit runtime_thompson_nfa
+    ( std::pmr::memory_resource *resource =
+        std::pmr::get_default_resource() ) :
+      edges( resource ), commands( resource ) {}
+
+    /**
+     * \brief Adds a state
+     *
+     * \return the index of the added state
+     */
+    std::size_t add_state() { return state_count++; }
+
+    /**
+     * \brief Adds an edge, without any command
+     *
+     * \param from the source state
+     * \param to the target state
+     * \param is_epsilon true for an epsilon transition
+     * \param letters letters recognized by a letter transition
+     *
+     * \return the index of the added edge
+     */
+    std::size_t add_edge
+    (
+      std::size_t from, std::size_t to,
+      bool is_epsilon, const letter_set &letters = letter_set {}
+    )
+    {
+      edges.push_back
+        ( nfa_edge
+          { from, to, is_epsilon, letters, command_count, command_count } );
+
+      return edge_count++;
+    }
+
+    /**
+     * \brief Attaches a command to the last added edge
+     *
+     * \param type the type of the command
+     * \param group the index of the group
+     */
+    void add_command( group_command_types type, std::size_t group )
+    {
+      commands.push_back( command_entry { type, group } );
+      edges[ edge_count - 1 ].command_end = ++command_count;
+    }
+
+    /**
+     * \brief The number of states
+     */
+    std::size_t state_count = 0;
+
+    /**
+     * \brief The number of edges
+     */
+    std::size_t edge_count = 0;
+
+    /**
+     * \brief The number of commands
+     */
+    std::size_t command_count = 0;
+
+    /**
+     * \brief The start state
+     */
+    std::size_t start = 0;
+
+    /**
+     * \brief The accept state
+     */
+    std::size_t accept = 0;
+
+    /**
+     * \brief The number of distinct groups
+     */
+    std::size_t group_count = 0;
+
+    /**
+     * \brief Edges storage
+     */
+    std::pmr::vector< nfa_edge > edges;
+
+    /**
+     * \brief Commands storage
+     */
+    std::pmr::vector< command_entry > commands;
+  };
+
+  /**
+   * \brief Builds the Thompson automaton of a run-time group node table
+   *
+   * \param nodes the table
+   * \param resource the memory resource of the automaton
+   *
+   * \return the Thompson automaton
+   */
+  inline runtime_thompson_nfa build_runtime_thompson_nfa
+  (
+    const runtime_group_node_table &nodes,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    runtime_thompson_nfa result { resource };
+
+    // a path from the root never meets a node twice
+    std::pmr::vector< std::size_t > ancestors( nodes.node_count, resource );
+
+    const auto fragment =
+      build_thompson_fragment( result, nodes, nodes.root, ancestors, 0 );
+
+    result.start = fragment.start;
+    result.accept = fragment.end;
+    result.group_count = nodes.group_count;
+
+    return result;
+  }
+
+  /**
+   * \brief Run-time counterpart of thompson_grammar and
+   * simplified_thompson_grammar
+   */
+  struct runtime_thompson_grammar
+  {
+    /**
+     * \brief Builds an empty grammar
+     *
+     * \param resource the memory resource of the grammar
+     */
+    explicit runtime_thompson_grammar
+    ( std::pmr::memory_resource *resource =
+        std::pmr::get_default_resource() ) :
+      nodes( resource ), nfa( resource ) {}
+
+    /**
+     * \brief The flattened group tree
+     */
+    runtime_group_node_table nodes;
+
+    /**
+     * \brief The Thompson automaton of the grammar
+     */
+    runtime_thompson_nfa nfa;
+
+    /**
+     * \brief The letter partition of the grammar
+     */
+    letter_classes classes;
+  };
+
+  /**
+   * \brief Builds the non deterministic form of a definition used by
+   * transcription algorithms, see thompson_grammar
+   *
+   * \param definition the definition
+   * \param resource the memory resource of the grammar
+   *
+   * \return the non deterministic form of the definition
+   */
+  inline runtime_thompson_grammar runtime_thompson_grammar_from
+  (
+    const grammar_definition &definition,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    runtime_thompson_grammar result { resource };
+
+    result.nodes = runtime_group_dag_from( definition, resource );
+    result.nfa = build_runtime_thompson_nfa( result.nodes, resource );
+    result.classes = result.nodes.classes();
+
+    return result;
+  }
+
+  /**
+   * \brief Builds the non deterministic form of a definition used for
+   * recognition only, see simplified_thompson_grammar
+   *
+   * \param definition the definition
+   * \param resource the memory resource of the grammar
+   *
+   * \return the simplified non deterministic form of the definition
+   */
+  inline runtime_thompson_grammar simplified_runtime_thompson_grammar_from
+  (
+    const grammar_definition &definition,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    runtime_thompson_grammar result { resource };
+
+    result.nodes =
+      simplify_runtime_group_nodes
+        ( runtime_group_dag_from( definition, resource ), resource );
+    result.nfa =
+      strip_thompson_commands
+        ( build_runtime_thompson_nfa( result.nodes, resource ),
+          runtime_thompson_nfa( resource ) );
+    result.classes = result.nodes.classes();
+
+    return result;
+  }
+
+  /**
+   * \brief Run-time counterpart of subset_automaton
+   */
+  struct runtime_subset_automaton
+  {
+    /**
+     * \brief Marks a missing transition
+     */
+    static constexpr std::size_t no_state =
+      std::numeric_limits< std::size_t >::max();
+
+    /**
+     * \brief Builds an automaton without any state
+     *
+     * \param resource the memory resource of the automaton
+     */
+    explicit runtime_subset_automaton
+    ( std::pmr::memory_resource *resource ) :
+      kernels( resource ), final_states( resource ),
+      final_actions( resource ), targets( resource ),
+      actions( resource ) {}
+
+    /**
+     * \brief The number of letter classes
+     */
+    std::size_t class_count = 0;
+
+    /**
+     * \brief The number of deterministic states
+     */
+    std::size_t state_count = 0;
+
+    /**
+     * \brief The number of distinct groups
+     */
+    std::size_t group_count = 0;
+
+    /**
+     * \brief Non deterministic states of each deterministic state
+     */
+    std::pmr::vector< dynamic_bit_set > kernels;
+
+    /**
+     * \brief Tells for each state if it is final
+     */
+    std::pmr::vector< bool > final_states;
+
+    /**
+     * \brief Commands met reaching the accept state, for each state
+     */
+    std::pmr::vector< dynamic_bit_set > final_actions;
+
+    /**
+     * \brief Targets of transitions, a row of classes per state
+     */
+    std::pmr::vector< std::size_t > targets;
+
+    /**
+     * \brief Commands of transitions, a row of classes per state
+     */
+    std::pmr::vector< dynamic_bit_set > actions;
+  };
+
+  /**
+   * \brief Run-time counterpart of nfa_closure
+   */
+  struct runtime_nfa_closure
+  {
+    /**
+     * \brief Tells for each state if it is reached
+     */
+    std::pmr::vector< bool > reached;
+
+    /**
+     * \brief Commands met reaching each state
+     */
+    std::pmr::vector< dynamic_bit_set > commands;
+  };
+
+  /**
+   * \brief Computes the epsilon closure of a kernel, see close_kernel
+   *
+   * \param nfa the Thompson automaton
+   * \param edge_commands the command set of each edge
+   * \param kernel the kernel to close
+   * \param bit_count the number of command bits
+   * \param resource the memory resource of the closure
+   *
+   * \return the closure of the kernel
+   */
+  inline runtime_nfa_closure close_runtime_kernel
+  (
+    const runtime_thompson_nfa &nfa,
+    const std::pmr::vector< dynamic_bit_set > &edge_commands,
+    const dynamic_bit_set &kernel, std::size_t bit_count,
+    std::pmr::memory_resource *resource
+  )
+  {
+    runtime_nfa_closure result
+    {
+      std::pmr::vector< bool >( nfa.state_count, false, resource ),
+      std::pmr::vector< dynamic_bit_set >
+        ( nfa.state_count, dynamic_bit_set { bit_count, resource },
+          resource )
+    };
+
+    for( std::size_t n = 0; n < nfa.state_count; ++n )
+      result.reached[ n ] = kernel.contains( n );
+
+    for( bool changed = true; changed; )
+    {
+      changed = false;
+
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+      {
+        const auto &edge = nfa.edges[ e ];
+
+        if( ! edge.is_epsilon || ! result.reached[ edge.from ] )
+          continue;
+
+        // commands met are merged in place, sparing a temporary set
+        auto &met = result.commands[ edge.to ];
+
+        if( result.reached[ edge.to ] &&
+            met.includes( result.commands[ edge.from ] ) &&
+            met.includes( edge_commands[ e ] ) )
+          continue;
+
+        result.reached[ edge.to ] = true;
+        met |= result.commands[ edge.from ];
+        met |= edge_commands[ e ];
+        changed = true;
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * \brief Determinizes a Thompson automaton, see determinize. Kernels are
+   * looked up by hash, giving states the numbering of the linear lookup of
+   * the compile-time construction
+   *
+   * \param nfa the Thompson automaton
+   * \param classes the letter partition of the automaton
+   * \param state_budget the maximum number of deterministic states
+   * \param resource the memory resource of the automaton
+   *
+   * \return the deterministic automaton
+   *
+   * \throw std::length_error if the state budget is exceeded
+   */
+  inline runtime_subset_automaton determinize_runtime
+  (
+    const runtime_thompson_nfa &nfa, const letter_classes &classes,
+    std::size_t state_budget,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    const auto bit_count = 3 * nfa.group_count;
+    const auto class_count = classes.class_count;
+
+    runtime_subset_automaton result { resource };
+
+    result.class_count = class_count;
+    result.group_count = nfa.group_count;
+
+    std::pmr::vector< dynamic_bit_set > edge_commands { resource };
+
+    for( std::size_t e = 0; e < nfa.edge_count; ++e )
+    {
+      auto &commands = edge_commands.emplace_back( bit_count );
+
+      for( auto c = nfa.edges[ e ].command_begin;
+           c < nfa.edges[ e ].command_end;
+           ++c )
+        commands.insert( command_bit( nfa.commands[ c ].type,
+                                      nfa.commands[ c ].group,
+                                      nfa.group_count ) );
+    }
+
+    std::pmr::vector< letter_set > class_letters { resource };
+
+    for( std::size_t c = 0; c < class_count; ++c )
+      class_letters.push_back( classes.letters_of( c ) );
+
+    std::pmr::unordered_multimap< std::uint64_t, std::size_t > known
+      { resource };
+
+    const auto add_state = [ & ]( dynamic_bit_set &&kernel )
+    {
+      known.emplace( kernel.hash(), result.state_count );
+      result.kernels.push_back( std::move( kernel ) );
+      result.final_states.push_back( false );
+      result.final_actions.emplace_back( bit_count );
+      result.targets.resize
+        ( result.targets.size() + class_count, result.no_state );
+      result.actions.resize
+        ( result.actions.size() + class_count,
+          dynamic_bit_set { bit_count, resource } );
+
+      return result.state_count++;
+    };
+
+    dynamic_bit_set initial { nfa.state_count, resource };
+
+    initial.insert( nfa.start );
+    add_state( std::move( initial ) );
+
+    for( std::size_t s = 0; s < result.state_count; ++s )
+    {
+      const auto closure =
+        close_runtime_kernel
+          ( nfa, edge_commands, result.kernels[ s ], bit_count, resource );
+
+      result.final_states[ s ] = closure.reached[ nfa.accept ];
+      result.final_actions[ s ] = closure.commands[ nfa.accept ];
+
+      for( std::size_t c = 0; c < class_count; ++c )
+      {
+        dynamic_bit_set kernel { nfa.state_count, resource };
+        dynamic_bit_set action { bit_count, resource };
+
+        for( std::size_t e = 0; e < nfa.edge_count; ++e )
+        {
+          const auto &edge = nfa.edges[ e ];
+
+          if( edge.is_epsilon || ! closure.reached[ edge.from ] ||
+              ( edge.letters & class_letters[ c ] ).empty() )
+            continue;
+
+          kernel.insert( edge.to );
+          action |= closure.commands[ edge.from ];
+          action |= edge_commands[ e ];
+        }
+
+        if( kernel.empty() )
+          continue;
+
+        auto target = result.no_state;
+        const auto range = known.equal_range( kernel.hash() );
+
+        for( auto k = range.first; k != range.second; ++k )
+          if( result.kernels[ k->second ] == kernel )
+            target = k->second;
+
+        if( target == result.no_state )
+        {
+          if( result.state_count == state_budget )
+            throw std::length_error
+              { "Invalid grammar used. The deterministic automaton of the "
+                "grammar exceeds the state budget." };
+
+          target = add_state( std::move( kernel ) );
+        }
+
+        result.targets[ s * class_count + c ] = target;
+        result.actions[ s * class_count + c ] = std::move( action );
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * \brief Run-time counterpart of automaton_table, the row of a state
+   * being exactly as large as the number of letter classes
+   */
+  struct runtime_automaton_table
+  {
+    /**
+     * \brief Marks a missing transition
+     */
+    static constexpr std::size_t no_state =
+      std::numeric_limits< std::size_t >::max();
+
+    /**
+     * \brief Marks a transition without command
+     */
+    static constexpr std::size_t no_action = 0;
+
+    /**
+     * \brief Builds a table without any state, only the empty action being
+     * registered
+     *
+     * \param resource the memory resource of the table
+     */
+    explicit runtime_automaton_table
+    ( std::pmr::memory_resource *resource ) :
+      final_states( resource ), final_actions( resource ),
+      targets( resource ), actions( resource ),
+      action_offsets( { 0, 0 }, resource ), commands( resource ) {}
+
+    /**
+     * \brief Gives the target of a transition
+     *
+     * \param state the source state
+     * \param klass the letter class read
+     *
+     * \return the target state or no_state if there is no transition
+     */
+    std::size_t class_target( std::size_t state, std::size_t klass ) const
+    { return targets[ state * classes.class_count + klass ]; }
+
+    /**
+     * \brief Gives the action of a transition
+     *
+     * \param state the source state
+     * \param klass the letter class read
+     *
+     * \return the action of the transition
+     */
+    std::size_t class_action( std::size_t state, std::size_t klass ) const
+    { return actions[ state * classes.class_count + klass ]; }
+
+    /**
+     * \brief Counts transitions of the table
+     *
+     * \return the number of existing transitions
+     */
+    std::size_t transition_count() const
+    {
+      std::size_t count = 0;
+
+      for( const auto target : targets )
+        if( target != no_state )
+          ++count;
+
+      return count;
+    }
+
+    /**
+     * \brief The number of states
+     */
+    std::size_t state_count = 0;
+
+    /**
+     * \brief The initial state
+     */
+    std::size_t initial_state = 0;
+
+    /**
+     * \brief The number of actions, the empty action included
+     */
+    std::size_t action_count = 1;
+
+    /**
+     * \brief The number of commands
+     */
+    std::size_t command_count = 0;
+
+    /**
+     * \brief The number of distinct groups
+     */
+    std::size_t group_count = 0;
+
+    /**
+     * \brief The letter partition of the automaton
+     */
+    letter_classes classes {};
+
+    /**
+     * \brief Tells for each state if it is final
+     */
+    std::pmr::vector< bool > final_states;
+
+    /**
+     * \brief The action of each state when the input ends there
+     */
+    std::pmr::vector< std::size_t > final_actions;
+
+    /**
+     * \brief Targets of transitions, a row of classes per state
+     */
+    std::pmr::vector< std::size_t > targets;
+
+    /**
+     * \brief Actions of transitions, a row of classes per state
+     */
+    std::pmr::vector< std::size_t > actions;
+
+    /**
+     * \brief Offsets of the commands of each action, plus the end offset
+     */
+    std::pmr::vector< std::size_t > action_offsets;
+
+    /**
+     * \brief Commands of all actions
+     */
+    std::pmr::vector< command_entry > commands;
+  };
+
+  /**
+   * \brief Converts a run-time subset automaton into an automaton table,
+   * see subset_to_automaton_table. Actions are looked up by hash, giving
+   * them the numbering of the linear lookup of the compile-time conversion
+   *
+   * \param subset the subset automaton
+   * \param classes the letter partition of the automaton
+   * \param resource the memory resource of the table
+   *
+   * \return the automaton table
+   */
+  inline runtime_automaton_table runtime_subset_to_automaton_table
+  (
+    const runtime_subset_automaton &subset, const letter_classes &classes,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    const auto class_count = subset.class_count;
+
+    runtime_automaton_table result { resource };
+
+    result.state_count = subset.state_count;
+    result.group_count = subset.group_count;
+    result.classes = classes;
+    result.final_states = subset.final_states;
+    result.final_actions.resize( subset.state_count );
+    result.targets.resize( subset.state_count * class_count, result.no_state );
+    result.actions.resize( subset.state_count * class_count );
+
+    std::pmr::unordered_multimap< std::uint64_t, std::size_t > known
+      { resource };
+    std::pmr::vector< command_entry > commands { resource };
+
+    const auto add_action = [ & ]( const dynamic_bit_set &action )
+    {
+      commands.clear();
+
+      for_each_ordered_command
+        ( action, result.group_count,
+          [ & ]( const command_entry &command )
+          { commands.push_back( command ); } );
+
+      if( commands.empty() )
+        return result.no_action;
+
+      std::uint64_t hash = commands.size();
+
+      for( const auto &command : commands )
+      {
+        hash = ( hash ^ static_cast< std::uint64_t >( command.type ) ) *
+               0x100000001b3u;
+        hash = ( hash ^ command.group ) * 0x100000001b3u;
+      }
+
+      const auto range = known.equal_range( hash );
+
+      for( auto a = range.first; a != range.second; ++a )
+      {
+        const auto begin = result.action_offsets[ a->second ];
+        const auto end = result.action_offsets[ a->second + 1 ];
+
+        if( end - begin != commands.size() )
+          continue;
+
+        bool same = true;
+
+        for( std::size_t c = 0; same && c < commands.size(); ++c )
+          same = result.commands[ begin + c ] == commands[ c ];
+
+        if( same )
+          return a->second;
+      }
+
+      result.commands.insert
+        ( result.commands.end(), commands.begin(), commands.end() );
+      result.command_count = result.commands.size();
+      result.action_offsets.push_back( result.command_count );
+      known.emplace( hash, result.action_count );
+
+      return result.action_count++;
+    };
+
+    for( std::size_t s = 0; s < subset.state_count; ++s )
+    {
+      result.final_actions[ s ] = add_action( subset.final_actions[ s ] );
+
+      for( std::size_t c = 0; c < class_count; ++c )
+      {
+        const auto cell = s * class_count + c;
+
+        if( subset.targets[ cell ] == subset.no_state )
+          continue;
+
+        result.targets[ cell ] = subset.targets[ cell ];
+        result.actions[ cell ] = add_action( subset.actions[ cell ] );
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * \brief Hashes signatures of states during minimization
+   */
+  struct runtime_signature_hash
+  {
+    /**
+     * \brief Computes the hash of a signature
+     *
+     * \param signature the signature
+     *
+     * \return the hash of the signature
+     */
+    std::size_t operator ()
+    ( const std::pmr::vector< std::size_t > &signature ) const
+    {
+      std::uint64_t result = 0;
+
+      for( const auto value : signature )
+        result = ( result ^ value ) * 0x100000001b3u;
+
+      return static_cast< std::size_t >( result );
+    }
+  };
+
+  /**
+   * \brief Minimizes a run-time automaton table, see
+   * minimize_automaton_table. States are split by signatures, that is, their
+   * block and the action and target block of each transition, looked up by
+   * hash. Blocks are numbered by their first state in breadth first order,
+   * thus, the result is the one of the compile-time minimization
+   *
+   * \param table the table to minimize
+   * \param resource the memory resource of the minimal table
+   *
+   * \return the minimal table
+   */
+  inline runtime_automaton_table minimize_runtime_automaton_table
+  (
+    const runtime_automaton_table &table,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+  )
+  {
+    constexpr auto no_state = runtime_automaton_table::no_state;
+    const auto class_count = table.classes.class_count;
+
+    // breadth first exploration, discarding unreachable states
+    std::pmr::vector< std::size_t > order { resource };
+    std::pmr::vector< bool > reached( table.state_count, false, resource );
+
+    order.push_back( table.initial_state );
+    reached[ table.initial_state ] = true;
+
+    for( std::size_t o = 0; o < order.size(); ++o )
+      for( std::size_t c = 0; c < class_count; ++c )
+      {
+        const auto target = table.class_target( order[ o ], c );
+
+        if( target != no_state && ! reached[ target ] )
+        {
+          reached[ target ] = true;
+          order.push_back( target );
+        }
+      }
+
+    using signature_type = std::pmr::vector< std::size_t >;
+    using signatures =
+      std::pmr::unordered_map
+        < signature_type, std::size_t, runtime_signature_hash >;
+
+    // initial partition : final flag and final action
+    std::pmr::vector< std::size_t > blocks( table.state_count, resource );
+    std::size_t block_count = 0;
+
+    {
+      signatures known { resource };
+
+      for( const auto state : order )
+      {
+        const auto inserted =
+          known.emplace
+            ( signature_type
+                {
+                  {
+                    table.final_states[ state ],
+                    table.final_actions[ state ]
+                  },
+                  resource
+                },
+              block_count );
+
+        blocks[ state ] = inserted.first->second;
+        block_count += inserted.second;
+      }
+    }
+
+    // refinement until stability
+    for( bool stable = false; ! stable; )
+    {
+      signatures known { resource };
+      std::pmr::vector< std::size_t > refined( table.state_count, resource );
+      std::size_t refined_count = 0;
+
+      for( const auto state : order )
+      {
+        signature_type signature { { blocks[ state ] }, resource };
+
+        for( std::size_t c = 0; c < class_count; ++c )
+        {
+          const auto target = table.class_target( state, c );
+
+          signature.push_back( table.class_action( state, c ) );
+          signature.push_back
+            ( target == no_state ? no_state : blocks[ target ] );
+        }
+
+        const auto inserted =
+          known.emplace( std::move( signature ), refined_count );
+
+        refined[ state ] = inserted.first->second;
+        refined_count += inserted.second;
+      }
+
+      stable = refined_count == block_count;
+      block_count = refined_count;
+      blocks = std::move( refined );
+    }
+
+    // building the quotient table
+    runtime_automaton_table result { resource };
+
+    result.state_count = block_count;
+    result.initial_state = blocks[ table.initial_state ];
+    result.action_count = table.action_count;
+    result.command_count = table.command_count;
+    result.group_count = table.group_count;
+    result.classes = table.classes;
+    result.action_offsets = table.action_offsets;
+    result.commands = table.commands;
+    result.final_states.resize( block_count );
+    result.final_actions.resize( block_count );
+    result.targets.resize( block_count * class_count, no_state );
+    result.actions.resize( block_count * class_count );
+
+    for( const auto state : order )
+    {
+      const auto block = blocks[ state ];
+
+      result.final_states[ block ] = table.final_states[ state ];
+      result.final_actions[ block ] = table.final_actions[ state ];
+
+      for( std::size_t c = 0; c < class_count; ++c )
+      {
+        const auto target = table.class_target( state, c );
+        const auto cell = block * class_count + c;
+
+        result.targets[ cell ] =
+          target == no_state ? no_state : blocks[ target ];
+        result.actions[ cell ] = table.class_action( state, c );
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * \brief Run-time counterpart of compact_automaton_table, holding the same
+   * values in growing storages. Sizes are members instead of template
+   * parameters, and no_state, the number of states, is a member too, thus,
+   * algorithms reading tables through their members work with both.
+   */
+  struct runtime_compact_table
+  {
+    /**
+     * \brief Marks a transition without command
+     */
+    static constexpr std::size_t no_action = 0;
+
+    /**
+     * \brief Builds a table without any state
+     *
+     * \param resource the memory resource of the table
+     */
+    explicit runtime_compact_table
+    ( std::pmr::memory_resource *resource =
+        std::pmr::get_default_resource() ) :
+      final_states( resource ), final_actions( resource ),
+      types( resource ), targets( resource ), actions( resource ),
+      action_offsets( resource ), commands( resource ) {}
+
+    /**
+     * \brief Gives the target of a transition
+     *
+     * \param state the source state
+     * \param klass the letter class read
+     *
+     * \return the target state or no_state if there is no transition
+     */
+    std::size_t class_target( std::size_t state, std::size_t klass ) const
+    { return targets[ state * class_count + klass ]; }
+
+    /**
+     * \brief Gives the action of a transition
+     *
+     * \param state the source state
+     * \param klass the letter class read
+     *
+     * \return the action of the transition
+     */
+    std::size_t class_action( std::size_t state, std::size_t klass ) const
+    { return actions[ state * class_count + klass ]; }
+
+    /**
+     * \brief Gives the target of a transition on a letter
+     *
+     * \param state the source state
+     * \param letter the letter read
+     *
+     * \return the target state or no_state if there is no transition
+     */
+    std::size_t target( std::size_t state, unsigned char letter ) const
+    { return class_target( state, classes[ letter ] ); }
+
+    /**
+     * \brief Gives the action of a transition on a letter
+     *
+     * \param state the source state
+     * \param letter the letter read
+     *
+     * \return the action of the transition
+     */
+    std::size_t action( std::size_t state, unsigned char letter ) const
+    { return class_action( state, classes[ letter ] ); }
+
+    /**
+     * \brief Gives the offset of the first command of an action
+     *
+     * \param action the action
+     *
+     * \return the offset of the first command
+     */
+    std::size_t action_begin( std::size_t action ) const
+    { return action_offsets[ action ]; }
+
+    /**
+     * \brief Gives the offset after the last command of an action
+     *
+     * \param action the action
+     *
+     * \return the offset after the last command
+     */
+    std::size_t action_end( std::size_t action ) const
+    { return action_offsets[ action + 1 ]; }
+
+    /**
+     * \brief The number of states
+     */
+    std::size_t state_count = 0;
+
+    /**
+     * \brief The number of letter classes
+     */
+    std::size_t class_count = 0;
+
+    /**
+     * \brief The number of actions, the empty action included
+     */
+    std::size_t action_count = 0;
+
+    /**
+     * \brief The number of commands
+     */
+    std::size_t command_count = 0;
+
+    /**
+     * \brief Marks a missing transition, the number of states
+     */
+    std::size_t no_state = 0;
+
+    /**
+     * \brief The initial state
+     */
+    std::size_t initial_state = 0;
+
+    /**
+     * \brief The number of distinct groups
+     */
+    std::size_t group_count = 0;
+
+    /**
+     * \brief The letter class of each letter
+     */
+    std::array< std::size_t, letter_set::letter_count > classes {};
+
+    /**
+     * \brief Tells for each state if it is final
+     */
+    std::pmr::vector< bool > final_states;
+
+    /**
+     * \brief The action of each state when the input ends there
+     */
+    std::pmr::vector< std::size_t > final_actions;
+
+    /**
+     * \brief The type of each state
+     */
+    std::pmr::vector< state_types > types;
+
+    /**
+     * \brief Targets of transitions, a row of classes per state
+     */
+    std::pmr::vector< std::size_t > targets;
+
+    /**
+     * \brief Actions of transitions, a row of classes per state
+     */
+    std::pmr::vector< std::size_t > actions;
+
+    /**
+     * \brief Offsets of the commands of each action, plus the end offset
+     */
+    std::pmr::vector< std::size_t > action_offsets;
+
+    /**
+     * \brief Commands of all actions
+     */
+    std::pmr::vector< command_entry > commands;
+  };
+
+  /**
+   * \brief Computes the type of each state of a run-time compact table, see
+   * classify_states
+   *
+   * \param table the table, whose transitions are filled
+   * \param resource the memory resource of temporary sets
+   */
+  inline void classify_runtime_states
+  ( runtime_compact_table &table, std::pmr::memory_resource *resource )
+  {
+    const auto state_count = table.state_count;
+    const auto class_count = table.class_count;
+
+    // growing the set of states leading to a final state
+    std::pmr::vector< bool > live( table.final_states, resource );
+
+    for( bool is_changed = true; is_changed; )
+    {
+      is_changed = false;
+
+      for( std::size_t s = 0; s < state_count; ++s )
+        for( std::size_t c = 0; c < class_count && ! live[ s ]; ++c )
+        {
+          const auto target = table.class_target( s, c );
+
+          if( target != table.no_state && live[ target ] )
+            is_changed = live[ s ] = true;
+        }
+    }
+
+    // shrinking the set of final states staying final whatever is read
+    std::pmr::vector< bool > always( table.final_states, resource );
+
+    for( bool is_changed = true; is_changed; )
+    {
+      is_changed = false;
+
+      for( std::size_t s = 0; s < state_count; ++s )
+        for( std::size_t c = 0; c < class_count && always[ s ]; ++c )
+        {
+          const auto target = table.class_target( s, c );
+
+          if( target == table.no_state || ! always[ target ] )
+          {
+            always[ s ] = false;
+            is_changed = true;
+          }
+        }
+    }
+
+    table.types.resize( state_count );
+
+    for( std::size_t s = 0; s < state_count; ++s )
+    {
+      const auto is_initial = s == table.initial_state;
+      const bool is_final = table.final_states[ s ];
+
+      table.types[ s ] =
+        ! live[ s ] ? state_types::dead :
+        always[ s ] ? state_types::always_final :
+        is_initial && is_final ? state_types::initial_and_final :
+        is_initial ? state_types::initial :
+        is_final ? state_types::final :
+        state_types::intermediate;
+    }
+  }
+
+  /**
+   * \brief Compresses a run-time automaton table, see
+   * compress_automaton_table
+   *
+   * \param table the minimal table
+   * \param resource the memory resource of the compact table
+   * \param arena the memory resource of temporary sets
+   *
+   * \return the compact table
+   */
+  inline runtime_compact_table compress_runtime_automaton_table
+  (
+    const runtime_automaton_table &table,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+    std::pmr::memory_resource *arena = std::pmr::get_default_resource()
+  )
+  {
+    runtime_compact_table result { resource };
+
+    result.state_count = table.state_count;
+    result.class_count = table.classes.class_count;
+    result.action_count = table.action_count;
+    result.command_count = table.command_count;
+    result.no_state = table.state_count;
+    result.initial_state = table.initial_state;
+    result.group_count = table.group_count;
+
+    for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+      result.classes[ l ] = table.classes.class_of[ l ];
+
+    result.final_states = table.final_states;
+    result.final_actions = table.final_actions;
+    result.actions = table.actions;
+    result.action_offsets = table.action_offsets;
+    result.commands = table.commands;
+    result.targets.reserve( table.targets.size() );
+
+    for( const auto target : table.targets )
+      result.targets.push_back
+        ( target == table.no_state ? result.no_state : target );
+
+    classify_runtime_states( result, arena );
+
+    return result;
+  }
+
+  /**
+   * \brief A grammar compiled at run time
+   */
+  struct runtime_compiled_grammar
+  {
+    /**
+     * \brief The compact table of the grammar
+     */
+    runtime_compact_table table;
+
+    /**
+     * \brief State and transition counts before and after minimization
+     */
+    automaton_statistics statistics;
+  };
+
+  /**
+   * \brief Compiles the non deterministic form of a grammar into a compact
+   * table, see basic_compiled_grammar. Each step gives the values of its
+   * compile-time counterpart, thus, the table holds the values of the table
+   * compiled from group types describing the same tree. Intermediate
+   * automata are allocated from an arena, meant to be a monotonic resource,
+   * whereas the compact table is allocated from the default resource, thus,
+   * it outlives the arena
+   *
+   * \param thompson the non deterministic form of the grammar
+   * \param state_budget the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \param arena the memory resource of intermediate automata
+   *
+   * \return the compiled grammar
+   *
+   * \throw std::length_error if the state budget is exceeded
+   */
+  inline runtime_compiled_grammar compile_runtime_grammar
+  (
+    const runtime_thompson_grammar &thompson, std::size_t state_budget,
+    std::pmr::memory_resource *arena = std::pmr::get_default_resource()
+  )
+  {
+    const auto subset =
+      determinize_runtime
+        ( thompson.nfa, thompson.classes, state_budget, arena );
+    const auto dfa =
+      runtime_subset_to_automaton_table( subset, thompson.classes, arena );
+    const auto minimal = minimize_runtime_automaton_table( dfa, arena );
+
+    return runtime_compiled_grammar
+    {
+      compress_runtime_automaton_table
+        ( minimal, std::pmr::get_default_resource(), arena ),
+      automaton_statistics
+      {
+        dfa.state_count, minimal.state_count,
+        dfa.transition_count(), minimal.transition_count()
+      }
+    };
+  }
+}
+
+#endif // _WARP_SPARK_DETAIL_RUNTIME_COMPILED_GRAMMAR_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the run-time counterpart of the compile-time pipeline
+ * turning a grammar into a compact automaton table, giving the same tables
+ */
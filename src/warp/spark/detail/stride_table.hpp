@@ -0,0 +1,160 @@
+#ifndef _WARP_SPARK_DETAIL_STRIDE_TABLE_HPP_
+#define _WARP_SPARK_DETAIL_STRIDE_TABLE_HPP_
+
+#include "../../core/numeric.hpp"
+#include "letter_set.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Two letters per lookup form of a deterministic automaton. A pair
+   * of letters is mapped to a pair of letter classes, then a
+   * [states][classes * classes] table gives the state reached after reading
+   * both letters. Transition actions are not kept : such a table only
+   * serves recognition.
+   *
+   * \tparam STATE_COUNT the number of states of the automaton
+   * \tparam CLASS_COUNT the number of letter classes
+   */
+  template< std::size_t STATE_COUNT, std::size_t CLASS_COUNT >
+    struct stride_table
+    {
+      /**
+       * \brief The smallest type able to hold a state, no_state included
+       */
+      using state_type = unsigned_auto_constant_t< STATE_COUNT >;
+
+      /**
+       * \brief The smallest type able to hold an offset in a row
+       */
+      using offset_type =
+        unsigned_auto_constant_t< CLASS_COUNT * CLASS_COUNT - 1 >;
+
+      /**
+       * \brief Exposes the number of states
+       */
+      static constexpr std::size_t state_count = STATE_COUNT;
+
+      /**
+       * \brief The number of cells of a row, a cell per pair of classes
+       */
+      static constexpr std::size_t row_size = CLASS_COUNT * CLASS_COUNT;
+
+      /**
+       * \brief Marks a cell without any transition
+       */
+      static constexpr std::size_t no_state = STATE_COUNT;
+
+      /**
+       * \brief Gets the state reached after reading two letters
+       *
+       * \param state the source state
+       * \param first the first letter read
+       * \param second the second letter read
+       *
+       * \return the target state or no_state if there is no transition
+       */
+      constexpr std::size_t target
+      ( std::size_t state, unsigned char first, unsigned char second ) const
+      {
+        return
+          targets[ state * row_size + first_offsets[ first ] +
+                   second_offsets[ second ] ];
+      }
+
+      /**
+       * \brief Offset in a row of each letter read first, that is, its class
+       * multiplied by the number of classes
+       */
+      std::array< offset_type, letter_set::letter_count > first_offsets {};
+
+      /**
+       * \brief Offset in a row of each letter read second, that is, its class
+       */
+      std::array< offset_type, letter_set::letter_count > second_offsets {};
+
+      /**
+       * \brief Target state of each cell
+       */
+      std::array< state_type, STATE_COUNT * CLASS_COUNT * CLASS_COUNT >
+        targets {};
+    };
+
+  /**
+   * \brief Computes the size of the stride table of an automaton table
+   * without instantiating it
+   *
+   * \tparam TABLE a compact automaton table type
+   */
+  template< class TABLE >
+    constexpr std::size_t stride_table_size()
+    {
+      return
+        TABLE::state_count * TABLE::class_count * TABLE::class_count *
+          sizeof( unsigned_auto_constant_t< TABLE::state_count > ) +
+        2 * letter_set::letter_count *
+          sizeof
+            ( unsigned_auto_constant_t
+                < TABLE::class_count * TABLE::class_count - 1 > );
+    }
+
+  /**
+   * \brief Builds the stride table of a compact automaton table, composing
+   * transitions on each pair of letter classes
+   *
+   * \tparam STRIDE a stride table type, sized after the source table
+   * \tparam TABLE a compact automaton table type
+   *
+   * \param table the source table
+   *
+   * \return the stride table
+   */
+  template< class STRIDE, class TABLE >
+    constexpr STRIDE build_stride_table( const TABLE &table )
+    {
+      using state_type = typename STRIDE::state_type;
+      using offset_type = typename STRIDE::offset_type;
+
+      constexpr auto class_count = TABLE::class_count;
+
+      STRIDE result;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+      {
+        result.first_offsets[ l ] =
+          static_cast< offset_type >( table.classes[ l ] * class_count );
+        result.second_offsets[ l ] =
+          static_cast< offset_type >( table.classes[ l ] );
+      }
+
+      for( std::size_t s = 0; s < TABLE::state_count; ++s )
+        for( std::size_t first = 0; first < class_count; ++first )
+        {
+          const auto middle = table.class_target( s, first );
+
+          for( std::size_t second = 0; second < class_count; ++second )
+            result.targets
+              [ s * STRIDE::row_size + first * class_count + second ] =
+                static_cast< state_type >
+                  (
+                    middle == TABLE::no_state ?
+                      STRIDE::no_state :
+                      table.class_target( middle, second )
+                  );
+        }
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_STRIDE_TABLE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the two letters per lookup form of automaton tables
+ */
@@ -0,0 +1,531 @@
+#ifndef _WARP_SPARK_DETAIL_SUBSET_CONSTRUCTION_HPP_
+#define _WARP_SPARK_DETAIL_SUBSET_CONSTRUCTION_HPP_
+
+#include "automaton_g_command_types.hpp"
+#include "automaton_table.hpp"
+#include "bit_set.hpp"
+#include "letter_classes.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Deterministic automaton produced by the subset construction. Each
+   * state is identified by its kernel, the set of non deterministic states
+   * reached before following epsilon transitions. Actions are still
+   * represented as sets of commands, a command being encoded as the bit
+   * rank * group_count + group, where rank is 0 for finishing, 1 for
+   * resetting and 2 for capturing.
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states
+   * \tparam CLASS_COUNT the number of letter classes
+   * \tparam NFA_STATE_COUNT the number of non deterministic states
+   * \tparam COMMAND_BIT_COUNT the number of distinct commands
+   */
+  template
+    <
+      std::size_t STATE_BUDGET,
+      std::size_t CLASS_COUNT,
+      std::size_t NFA_STATE_COUNT,
+      std::size_t COMMAND_BIT_COUNT
+    >
+    struct subset_automaton
+    {
+      /**
+       * \brief Type of a set of non deterministic states
+       */
+      using kernel_type = bit_set< NFA_STATE_COUNT >;
+
+      /**
+       * \brief Type of a set of commands
+       */
+      using command_set_type = bit_set< COMMAND_BIT_COUNT >;
+
+      /**
+       * \brief Exposes the state budget
+       */
+      static constexpr std::size_t state_budget = STATE_BUDGET;
+
+      /**
+       * \brief Exposes the number of letter classes
+       */
+      static constexpr std::size_t class_count = CLASS_COUNT;
+
+      /**
+       * \brief Marks a cell without any transition
+       */
+      static constexpr std::size_t no_state = STATE_BUDGET;
+
+      /**
+       * \brief Builds an automaton without any state
+       */
+      constexpr subset_automaton()
+      {
+        for( std::size_t i = 0; i < targets.size(); ++i )
+          targets[ i ] = no_state;
+      }
+
+      /**
+       * \brief The number of built states
+       */
+      std::size_t state_count = 0;
+
+      /**
+       * \brief The number of groups commands are working on
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief Indicates if all states fitted in the state budget
+       */
+      bool is_complete = true;
+
+      /**
+       * \brief Kernel of each state
+       */
+      std::array< kernel_type, STATE_BUDGET > kernels {};
+
+      /**
+       * \brief Indicates, for each state, if it is final
+       */
+      std::array< bool, STATE_BUDGET > final_states {};
+
+      /**
+       * \brief Commands applied when the input ends in a final state
+       */
+      std::array< command_set_type, STATE_BUDGET > final_actions {};
+
+      /**
+       * \brief Target state of each cell
+       */
+      std::array< std::size_t, STATE_BUDGET * CLASS_COUNT > targets {};
+
+      /**
+       * \brief Commands of each cell
+       */
+      std::array< command_set_type, STATE_BUDGET * CLASS_COUNT > actions {};
+    };
+
+  /**
+   * \brief Gives the command bit of a command
+   *
+   * \param type the type of the command
+   * \param group the group the command is working on
+   * \param group_count the number of groups
+   *
+   * \return the bit representing the command in a command set
+   */
+  constexpr std::size_t command_bit
+  ( group_command_types type, std::size_t group, std::size_t group_count )
+  {
+    const std::size_t rank =
+      type == group_command_types::finishing ? 0 :
+      type == group_command_types::resetting ? 1 : 2;
+
+    return rank * group_count + group;
+  }
+
+  /**
+   * \brief Converts commands of an edge into a command set
+   *
+   * \tparam COMMAND_SET a bit set type
+   * \tparam NFA a Thompson automaton type
+   *
+   * \param nfa the automaton owning the edge
+   * \param edge the edge index
+   *
+   * \return the command set of the edge
+   */
+  template< class COMMAND_SET, class NFA >
+    constexpr COMMAND_SET edge_command_set
+    ( const NFA &nfa, std::size_t edge )
+    {
+      COMMAND_SET result;
+
+      for( auto c = nfa.edges[ edge ].command_begin;
+           c < nfa.edges[ edge ].command_end;
+           ++c )
+        result.insert( command_bit( nfa.commands[ c ].type,
+                                    nfa.commands[ c ].group,
+                                    nfa.group_count ) );
+
+      return result;
+    }
+
+  /**
+   * \brief Epsilon closure of a set of non deterministic states, with commands
+   * met along epsilon paths
+   *
+   * \tparam STATE_CAPACITY the state capacity of the automaton
+   * \tparam COMMAND_SET a bit set type
+   */
+  template< std::size_t STATE_CAPACITY, class COMMAND_SET >
+    struct nfa_closure
+    {
+      /**
+       * \brief Indicates, for each state, if it is part of the closure
+       */
+      std::array< bool, STATE_CAPACITY > reached {};
+
+      /**
+       * \brief Commands met on the way to each state of the closure
+       */
+      std::array< COMMAND_SET, STATE_CAPACITY > commands {};
+    };
+
+  /**
+   * \brief Computes the epsilon closure of a kernel. Commands met on distinct
+   * paths leading to a same state are merged, regardless of the priority of
+   * paths, thus, deterministic actions are a superset of the commands of any
+   * single parse. The capture engine keeps parses apart instead.
+   *
+   * \tparam COMMAND_SET a bit set type
+   * \tparam NFA a Thompson automaton type
+   * \tparam KERNEL a bit set type
+   *
+   * \param nfa the automaton
+   * \param kernel states to start from
+   *
+   * \return the closure of the kernel
+   */
+  template< class COMMAND_SET, class NFA, class KERNEL >
+    constexpr nfa_closure< NFA::state_capacity, COMMAND_SET > close_kernel
+    ( const NFA &nfa, const KERNEL &kernel )
+    {
+      nfa_closure< NFA::state_capacity, COMMAND_SET > result;
+
+      for( std::size_t n = 0; n < nfa.state_count; ++n )
+        result.reached[ n ] = kernel.contains( n );
+
+      for( bool changed = true; changed; )
+      {
+        changed = false;
+
+        for( std::size_t e = 0; e < nfa.edge_count; ++e )
+        {
+          const auto &edge = nfa.edges[ e ];
+
+          if( ! edge.is_epsilon || ! result.reached[ edge.from ] )
+            continue;
+
+          const auto met =
+            result.commands[ edge.from ] |
+            edge_command_set< COMMAND_SET >( nfa, e );
+
+          if( result.reached[ edge.to ] &&
+              result.commands[ edge.to ].includes( met ) )
+            continue;
+
+          result.reached[ edge.to ] = true;
+          result.commands[ edge.to ] |= met;
+          changed = true;
+        }
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Follows letter edges leaving a closure, for a set of letters
+   * sharing a same behavior
+   *
+   * \tparam NFA a Thompson automaton type
+   * \tparam CLOSURE a closure type
+   * \tparam KERNEL a bit set type
+   * \tparam COMMAND_SET a bit set type
+   *
+   * \param nfa the automaton
+   * \param closure the closure to leave
+   * \param letters letters of a letter class
+   * \param kernel receives target states
+   * \param action receives commands of the transition
+   */
+  template< class NFA, class CLOSURE, class KERNEL, class COMMAND_SET >
+    constexpr void step_closure
+    (
+      const NFA &nfa, const CLOSURE &closure, const letter_set &letters,
+      KERNEL &kernel, COMMAND_SET &action
+    )
+    {
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+      {
+        const auto &edge = nfa.edges[ e ];
+
+        if( edge.is_epsilon || ! closure.reached[ edge.from ] ||
+            ( edge.letters & letters ).empty() )
+          continue;
+
+        kernel.insert( edge.to );
+        action |= closure.commands[ edge.from ];
+        action |= edge_command_set< COMMAND_SET >( nfa, e );
+      }
+    }
+
+  /**
+   * \brief Determinizes a Thompson automaton using the subset construction.
+   * Commands met along epsilon paths are merged with commands of the letter
+   * transition following them. When the state budget is exhausted, the
+   * construction stops and the result is marked incomplete.
+   *
+   * \tparam SUBSET a subset automaton type
+   * \tparam NFA a Thompson automaton type
+   *
+   * \param nfa the automaton to determinize
+   * \param classes the letter partition of the automaton
+   *
+   * \return the deterministic automaton
+   */
+  template< class SUBSET, class NFA >
+    constexpr SUBSET determinize
+    ( const NFA &nfa, const letter_classes &classes )
+    {
+      using kernel_type = typename SUBSET::kernel_type;
+      using command_set_type = typename SUBSET::command_set_type;
+
+      SUBSET result;
+
+      result.group_count = nfa.group_count;
+      result.kernels[ 0 ].insert( nfa.start );
+      result.state_count = 1;
+
+      std::array< letter_set, SUBSET::class_count > class_letters {};
+
+      for( std::size_t c = 0; c < SUBSET::class_count; ++c )
+        class_letters[ c ] = classes.letters_of( c );
+
+      for( std::size_t s = 0; s < result.state_count; ++s )
+      {
+        const auto closure =
+          close_kernel< command_set_type >( nfa, result.kernels[ s ] );
+
+        result.final_states[ s ] = closure.reached[ nfa.accept ];
+        result.final_actions[ s ] = closure.commands[ nfa.accept ];
+
+        // letter transitions, a class at a time
+        for( std::size_t c = 0; c < SUBSET::class_count; ++c )
+        {
+          kernel_type kernel;
+          command_set_type action;
+
+          step_closure( nfa, closure, class_letters[ c ], kernel, action );
+
+          if( kernel.empty() )
+            continue;
+
+          std::size_t target = 0;
+
+          while( target < result.state_count &&
+                 result.kernels[ target ] != kernel )
+            ++target;
+
+          if( target == result.state_count )
+          {
+            if( result.state_count == SUBSET::state_budget )
+            {
+              result.is_complete = false;
+
+              return result;
+            }
+
+            result.kernels[ result.state_count++ ] = kernel;
+          }
+
+          result.targets[ s * SUBSET::class_count + c ] = target;
+          result.actions[ s * SUBSET::class_count + c ] = action;
+        }
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Sizes of the action storage needed by a subset automaton
+   */
+  struct subset_action_size
+  {
+    /**
+     * \brief The number of distinct actions, the empty one included
+     */
+    std::size_t action_count;
+
+    /**
+     * \brief The number of commands of all distinct actions
+     */
+    std::size_t command_count;
+  };
+
+  /**
+   * \brief Computes sizes of the action storage needed by a subset automaton
+   *
+   * \tparam SUBSET a subset automaton type
+   *
+   * \param subset the subset automaton
+   *
+   * \return exact sizes of the action storage
+   */
+  template< class SUBSET >
+    constexpr subset_action_size measure_subset_actions( const SUBSET &subset )
+    {
+      using command_set_type = typename SUBSET::command_set_type;
+
+      constexpr auto cell_capacity = SUBSET::state_budget * SUBSET::class_count;
+
+      std::array< command_set_type, cell_capacity + SUBSET::state_budget >
+        distinct {};
+      subset_action_size result { 1, 0 };
+      std::size_t distinct_count = 0;
+
+      const auto add = [ & ]( const command_set_type &action )
+      {
+        if( action.empty() )
+          return;
+
+        for( std::size_t d = 0; d < distinct_count; ++d )
+          if( distinct[ d ] == action )
+            return;
+
+        distinct[ distinct_count++ ] = action;
+        result.action_count += 1;
+        result.command_count += action.size();
+      };
+
+      for( std::size_t s = 0; s < subset.state_count; ++s )
+      {
+        add( subset.final_actions[ s ] );
+
+        for( std::size_t c = 0; c < SUBSET::class_count; ++c )
+          add( subset.actions[ s * SUBSET::class_count + c ] );
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Enumerates commands of a command set in the order they must be
+   * applied. Inner groups are finished before outer ones, then outer groups
+   * are reset before inner ones and finally captures are applied. A group
+   * both reset and finished without capturing anything is empty : it is
+   * finished after being reset.
+   *
+   * \tparam COMMAND_SET a bit set type
+   * \tparam FUNCTION a callable type, accepting a command entry
+   *
+   * \param action the command set
+   * \param group_count the number of groups
+   * \param function called for each command
+   */
+  template< class COMMAND_SET, class FUNCTION >
+    constexpr void for_each_ordered_command
+    (
+      const COMMAND_SET &action, std::size_t group_count,
+      FUNCTION &&function
+    )
+    {
+      const auto is_empty = [ & ]( std::size_t g )
+      {
+        return action.contains( group_count + g ) &&
+               ! action.contains( 2 * group_count + g );
+      };
+
+      for( auto g = group_count; g-- > 0; )
+        if( action.contains( g ) && ! is_empty( g ) )
+          function( command_entry { group_command_types::finishing, g } );
+
+      for( std::size_t g = 0; g < group_count; ++g )
+        if( action.contains( group_count + g ) )
+          function( command_entry { group_command_types::resetting, g } );
+
+      for( auto g = group_count; g-- > 0; )
+        if( action.contains( g ) && is_empty( g ) )
+          function( command_entry { group_command_types::finishing, g } );
+
+      for( std::size_t g = 0; g < group_count; ++g )
+        if( action.contains( 2 * group_count + g ) )
+          function( command_entry { group_command_types::capturing, g } );
+    }
+
+  /**
+   * \brief Registers a command set as an action of an automaton table, using
+   * the order of for_each_ordered_command
+   *
+   * \tparam TABLE an automaton table type
+   * \tparam COMMAND_SET a bit set type
+   *
+   * \param table the table receiving the action
+   * \param action the command set
+   *
+   * \return the identifier of the action
+   */
+  template< class TABLE, class COMMAND_SET >
+    constexpr std::size_t add_command_set
+    ( TABLE &table, const COMMAND_SET &action )
+    {
+      std::array< command_entry, COMMAND_SET::capacity + 1 > commands {};
+      std::size_t count = 0;
+
+      for_each_ordered_command
+        ( action, table.group_count,
+          [ & ]( const command_entry &command )
+          { commands[ count++ ] = command; } );
+
+      return table.add_action( commands.data(), count );
+    }
+
+  /**
+   * \brief Converts a subset automaton into an automaton table
+   *
+   * \tparam TABLE an automaton table type, sized using the state count of the
+   * subset automaton and measure_subset_actions
+   * \tparam SUBSET a subset automaton type
+   *
+   * \param subset the subset automaton
+   * \param classes the letter partition used to build the subset automaton
+   *
+   * \return the automaton table
+   */
+  template< class TABLE, class SUBSET >
+    constexpr TABLE subset_to_automaton_table
+    ( const SUBSET &subset, const letter_classes &classes )
+    {
+      TABLE result;
+
+      result.state_count = subset.state_count;
+      result.initial_state = 0;
+      result.group_count = subset.group_count;
+      result.classes = classes;
+
+      for( std::size_t s = 0; s < subset.state_count; ++s )
+      {
+        result.final_states[ s ] = subset.final_states[ s ];
+        result.final_actions[ s ] =
+          add_command_set( result, subset.final_actions[ s ] );
+
+        for( std::size_t c = 0; c < SUBSET::class_count; ++c )
+        {
+          const auto cell = s * SUBSET::class_count + c;
+          const auto target = subset.targets[ cell ];
+
+          if( target == SUBSET::no_state )
+            continue;
+
+          result.targets[ s * TABLE::class_capacity + c ] = target;
+          result.actions[ s * TABLE::class_capacity + c ] =
+            add_command_set( result, subset.actions[ cell ] );
+        }
+      }
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_SUBSET_CONSTRUCTION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the subset construction, turning a Thompson automaton into
+ * a deterministic automaton table
+ */
@@ -0,0 +1,537 @@
+#ifndef _WARP_SPARK_DETAIL_THOMPSON_NFA_HPP_
+#define _WARP_SPARK_DETAIL_THOMPSON_NFA_HPP_
+
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "automaton_g_command_types.hpp"
+#include "automaton_table.hpp"
+#include "group_node_table.hpp"
+#include "letter_set.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief An edge of a non deterministic automaton. An edge either consumes
+   * a letter of its letter set or is an epsilon transition. Group commands
+   * attached to the edge are stored in the command storage of the automaton
+   */
+  struct nfa_edge
+  {
+    /**
+     * \brief The source state
+     */
+    std::size_t from;
+
+    /**
+     * \brief The target state
+     */
+    std::size_t to;
+
+    /**
+     * \brief Indicates if the edge is an epsilon transition
+     */
+    bool is_epsilon;
+
+    /**
+     * \brief Letters consumed by the edge, if it is not an epsilon transition
+     */
+    letter_set letters;
+
+    /**
+     * \brief Index of the first command attached to the edge
+     */
+    std::size_t command_begin;
+
+    /**
+     * \brief Index after the last command attached to the edge
+     */
+    std::size_t command_end;
+  };
+
+  /**
+   * \brief Sizes of a Thompson automaton, computed before its construction to
+   * allocate an exactly sized automaton
+   */
+  struct thompson_nfa_size
+  {
+    /**
+     * \brief The number of states
+     */
+    std::size_t state_count;
+
+    /**
+     * \brief The number of edges
+     */
+    std::size_t edge_count;
+
+    /**
+     * \brief The number of commands attached to edges
+     */
+    std::size_t command_count;
+  };
+
+  /**
+   * \brief A non deterministic automaton built with the Thompson construction
+   * from a group node table. The automaton has a single start state and a
+   * single accepting state. Group commands are attached to edges :
+   * - resetting when a group is entered
+   * - capturing, for the group and all enclosing groups, when a letter is
+   *   consumed
+   * - finishing when a group is left
+   *
+   * \tparam STATE_CAPACITY the maximum number of states
+   * \tparam EDGE_CAPACITY the maximum number of edges
+   * \tparam COMMAND_CAPACITY the maximum number of commands attached to edges
+   */
+  template
+    <
+      std::size_t STATE_CAPACITY,
+      std::size_t EDGE_CAPACITY,
+      std::size_t COMMAND_CAPACITY
+    >
+    struct thompson_nfa
+    {
+      /**
+       * \brief Exposes the state capacity
+       */
+      static constexpr std::size_t state_capacity = STATE_CAPACITY;
+
+      /**
+       * \brief Exposes the edge capacity
+       */
+      static constexpr std::size_t edge_capacity = EDGE_CAPACITY;
+
+      /**
+       * \brief Exposes the command capacity
+       */
+      static constexpr std::size_t command_capacity = COMMAND_CAPACITY;
+
+      /**
+       * \brief Adds a new state
+       *
+       * \return the index of the new state
+       */
+      constexpr std::size_t add_state() { return state_count++; }
+
+      /**
+       * \brief Adds an edge without any command
+       *
+       * \param from the source state
+       * \param to the target state
+       * \param is_epsilon indicates if the edge is an epsilon transition
+       * \param letters letters consumed by a non epsilon edge
+       *
+       * \return the index of the new edge
+       */
+      constexpr std::size_t add_edge
+      (
+        std::size_t from, std::size_t to,
+        bool is_epsilon, const letter_set &letters = letter_set {}
+      )
+      {
+        edges[ edge_count ] =
+          nfa_edge
+          { from, to, is_epsilon, letters, command_count, command_count };
+
+        return edge_count++;
+      }
+
+      /**
+       * \brief Attaches a command to the last added edge
+       *
+       * \param type the type of the command
+       * \param group the group the command is working on
+       */
+      constexpr void add_command( group_command_types type, std::size_t group )
+      {
+        commands[ command_count++ ] = command_entry { type, group };
+        edges[ edge_count - 1 ].command_end = command_count;
+      }
+
+      /**
+       * \brief The number of states
+       */
+      std::size_t state_count = 0;
+
+      /**
+       * \brief The number of edges
+       */
+      std::size_t edge_count = 0;
+
+      /**
+       * \brief The number of commands
+       */
+      std::size_t command_count = 0;
+
+      /**
+       * \brief The start state
+       */
+      std::size_t start = 0;
+
+      /**
+       * \brief The accepting state
+       */
+      std::size_t accept = 0;
+
+      /**
+       * \brief The number of groups commands are working on
+       */
+      std::size_t group_count = 0;
+
+      /**
+       * \brief Edges storage
+       */
+      std::array< nfa_edge, EDGE_CAPACITY > edges {};
+
+      /**
+       * \brief Commands storage
+       */
+      std::array< command_entry, COMMAND_CAPACITY > commands {};
+    };
+
+  /**
+   * \brief Computes sizes of the Thompson automaton of a group node table.
+   * Nodes are stored before the groups using them, thus, sizes of each
+   * distinct node are computed once, in a single pass, instead of once per
+   * occurrence. A symbol edge carrying a capturing command per enclosing
+   * group, each node also counts the symbol occurrences of its subtree, each
+   * enclosing group adding as many commands.
+   *
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return sizes of the automaton
+   */
+  template< class NODES >
+    constexpr thompson_nfa_size measure_thompson_nfa( const NODES &nodes )
+    {
+      std::array< thompson_nfa_size, NODES::node_capacity > sizes {};
+      std::array< std::size_t, NODES::node_capacity > symbol_counts {};
+
+      for( std::size_t n = 0; n < nodes.node_count; ++n )
+      {
+        const auto &current = nodes.nodes[ n ];
+        auto &size = sizes[ n ];
+
+        size.state_count = 2;
+
+        if( current.type == group_node_types::symbol )
+        {
+          size.edge_count = 1;
+          symbol_counts[ n ] = 1;
+
+          continue;
+        }
+
+        // operands are enclosed by this group too
+        const auto add_operand = [ & ]( std::size_t operand )
+        {
+          size.state_count += sizes[ operand ].state_count;
+          size.edge_count += sizes[ operand ].edge_count;
+          size.command_count +=
+            sizes[ operand ].command_count + symbol_counts[ operand ];
+          symbol_counts[ n ] += symbol_counts[ operand ];
+        };
+
+        add_operand( current.first );
+
+        if( current.type == group_node_types::binary_group )
+        {
+          add_operand( current.second );
+
+          const auto alternation =
+            current.binary_closure == group_binary_closures::alternation;
+
+          size.edge_count += alternation ? 4 : 3;
+          size.command_count += alternation ? 4 : 2;
+
+          continue;
+        }
+
+        switch( current.unary_closure )
+        {
+          case group_unary_closures::one_one :
+            size.edge_count += 2;
+            size.command_count += 2;
+            break;
+
+          case group_unary_closures::zero_one :
+            size.edge_count += 3;
+            size.command_count += 4;
+            break;
+
+          case group_unary_closures::zero_many :
+            size.state_count += 1;
+            size.edge_count += 4;
+            size.command_count += 2;
+            break;
+
+          case group_unary_closures::one_many :
+            size.edge_count += 3;
+            size.command_count += 2;
+            break;
+        }
+      }
+
+      return sizes[ nodes.root ];
+    }
+
+  /**
+   * \brief Start and end states of the automaton built for a node
+   */
+  struct thompson_fragment
+  {
+    /**
+     * \brief The entry state of the fragment
+     */
+    std::size_t start;
+
+    /**
+     * \brief The exit state of the fragment
+     */
+    std::size_t end;
+  };
+
+  /**
+   * \brief Builds the Thompson automaton of a node and its operands
+   *
+   * \tparam NFA a Thompson automaton type
+   * \tparam NODES a group node table type
+   * \tparam ANCESTORS an array type able to hold all enclosing groups
+   *
+   * \param nfa the automaton to fill
+   * \param nodes the group node table
+   * \param node the index of the built node
+   * \param ancestors groups enclosing the node, the innermost being the last
+   * \param depth the number of groups enclosing the node
+   *
+   * \return the fragment of the node
+   */
+  template< class NFA, class NODES, class ANCESTORS >
+    constexpr thompson_fragment build_thompson_fragment
+    (
+      NFA &nfa, const NODES &nodes, std::size_t node,
+      ANCESTORS &ancestors, std::size_t depth
+    )
+    {
+      const auto &current = nodes.nodes[ node ];
+      const thompson_fragment result { nfa.add_state(), nfa.add_state() };
+
+      if( current.type == group_node_types::symbol )
+      {
+        nfa.add_edge( result.start, result.end, false, current.letters );
+
+        for( std::size_t a = 0; a < depth; ++a )
+          nfa.add_command( group_command_types::capturing, ancestors[ a ] );
+
+        return result;
+      }
+
+      const auto group = current.group;
+      constexpr auto resetting = group_command_types::resetting;
+      constexpr auto finishing = group_command_types::finishing;
+
+      ancestors[ depth ] = group;
+
+      const auto first =
+        build_thompson_fragment
+          ( nfa, nodes, current.first, ancestors, depth + 1 );
+
+      if( current.type == group_node_types::binary_group )
+      {
+        const auto second =
+          build_thompson_fragment
+            ( nfa, nodes, current.second, ancestors, depth + 1 );
+
+        nfa.add_edge( result.start, first.start, true );
+        nfa.add_command( resetting, group );
+
+        if( current.binary_closure == group_binary_closures::concatenation )
+        {
+          nfa.add_edge( first.end, second.start, true );
+        }
+        else
+        {
+          nfa.add_edge( result.start, second.start, true );
+          nfa.add_command( resetting, group );
+          nfa.add_edge( first.end, result.end, true );
+          nfa.add_command( finishing, group );
+        }
+
+        nfa.add_edge( second.end, result.end, true );
+        nfa.add_command( finishing, group );
+
+        return result;
+      }
+
+      switch( current.unary_closure )
+      {
+        case group_unary_closures::one_one :
+          nfa.add_edge( result.start, first.start, true );
+          nfa.add_command( resetting, group );
+          nfa.add_edge( first.end, result.end, true );
+          nfa.add_command( finishing, group );
+          break;
+
+        case group_unary_closures::zero_one :
+          nfa.add_edge( result.start, first.start, true );
+          nfa.add_command( resetting, group );
+          nfa.add_edge( first.end, result.end, true );
+          nfa.add_command( finishing, group );
+          nfa.add_edge( result.start, result.end, true );
+          nfa.add_command( resetting, group );
+          nfa.add_command( finishing, group );
+          break;
+
+        case group_unary_closures::zero_many :
+        {
+          const auto loop = nfa.add_state();
+
+          nfa.add_edge( result.start, loop, true );
+          nfa.add_command( resetting, group );
+          nfa.add_edge( loop, first.start, true );
+          nfa.add_edge( first.end, loop, true );
+          nfa.add_edge( loop, result.end, true );
+          nfa.add_command( finishing, group );
+          break;
+        }
+
+        case group_unary_closures::one_many :
+          nfa.add_edge( result.start, first.start, true );
+          nfa.add_command( resetting, group );
+          nfa.add_edge( first.end, first.start, true );
+          nfa.add_edge( first.end, result.end, true );
+          nfa.add_command( finishing, group );
+          break;
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Builds the Thompson automaton of a group node table. Each
+   * occurrence of a shared node needs its own states, thus, unlike measuring,
+   * building walks the table once per occurrence
+   *
+   * \tparam NFA a Thompson automaton type, sized using measure_thompson_nfa
+   * \tparam NODES a group node table type
+   *
+   * \param nodes the group node table
+   *
+   * \return the automaton
+   */
+  template< class NFA, class NODES >
+    constexpr NFA build_thompson_nfa( const NODES &nodes )
+    {
+      NFA result;
+      std::array< std::size_t, NODES::node_capacity > ancestors {};
+
+      const auto fragment =
+        build_thompson_fragment( result, nodes, nodes.root, ancestors, 0 );
+
+      result.start = fragment.start;
+      result.accept = fragment.end;
+      result.group_count = nodes.group_count;
+
+      return result;
+    }
+
+  /**
+   * \brief Copies a Thompson automaton without its commands, for automata
+   * used for recognition only
+   *
+   * \tparam RESULT a Thompson automaton type without command capacity
+   * \tparam NFA the source Thompson automaton type
+   *
+   * \param nfa the source automaton
+   * \param result an empty automaton receiving the copy, letting run-time
+   * automata choose their memory resource
+   *
+   * \return the automaton without any command nor group
+   */
+  template< class RESULT, class NFA >
+    constexpr RESULT strip_thompson_commands
+    ( const NFA &nfa, RESULT result = RESULT {} )
+    {
+      result.state_count = nfa.state_count;
+      result.start = nfa.start;
+      result.accept = nfa.accept;
+
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+      {
+        const auto &edge = nfa.edges[ e ];
+
+        result.add_edge( edge.from, edge.to, edge.is_epsilon, edge.letters );
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Copies a Thompson automaton without its commands, looping on its
+   * start state on any letter. The copy recognizes every input ending with a
+   * part recognized by the source, thus, its accepting state is reached as
+   * soon as a match ends, wherever it begins
+   *
+   * \tparam RESULT a Thompson automaton type without command capacity, with
+   * room for one more edge than the source
+   * \tparam NFA the source Thompson automaton type
+   *
+   * \param nfa the source automaton
+   *
+   * \return the unanchored automaton without any command nor group
+   */
+  template< class RESULT, class NFA >
+    constexpr RESULT unanchor_thompson_nfa( const NFA &nfa )
+    {
+      auto result = strip_thompson_commands< RESULT >( nfa );
+
+      result.add_edge( result.start, result.start, false, letter_set::all() );
+
+      return result;
+    }
+
+  /**
+   * \brief Copies a Thompson automaton without its commands, each edge being
+   * reversed and the start and accepting states being swapped. The copy
+   * recognizes mirrored inputs of the source, reading them backward
+   *
+   * \tparam RESULT a Thompson automaton type without command capacity
+   * \tparam NFA the source Thompson automaton type
+   *
+   * \param nfa the source automaton
+   *
+   * \return the reversed automaton without any command nor group
+   */
+  template< class RESULT, class NFA >
+    constexpr RESULT reverse_thompson_nfa( const NFA &nfa )
+    {
+      RESULT result {};
+
+      result.state_count = nfa.state_count;
+      result.start = nfa.accept;
+      result.accept = nfa.start;
+
+      for( std::size_t e = 0; e < nfa.edge_count; ++e )
+      {
+        const auto &edge = nfa.edges[ e ];
+
+        result.add_edge( edge.to, edge.from, edge.is_epsilon, edge.letters );
+      }
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_THOMPSON_NFA_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the Thompson construction of a non deterministic automaton
+ * from a group node table
+ */
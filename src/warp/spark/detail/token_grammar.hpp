@@ -0,0 +1,392 @@
+#ifndef _WARP_SPARK_DETAIL_TOKEN_GRAMMAR_HPP_
+#define _WARP_SPARK_DETAIL_TOKEN_GRAMMAR_HPP_
+
+#include "../../sequences/sequence_types.hpp"
+#include "../group_traits.hpp"
+#include "../regular_grammar_type_system_enumerations.hpp"
+#include "automaton_state_enumeration.hpp"
+#include "union_grammar.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Collects token kinds of a grammar, that is, operands of its top
+   * level alternations, from left to right. This version works with anything
+   * that is not an alternation, adding it as a kind
+   *
+   * \tparam T a group or a symbol type
+   * \tparam KINDS a type sequence of already collected kinds
+   */
+  template
+    <
+      class T,
+      class KINDS,
+      bool =
+        std::is_same
+        <
+          typename group_traits< T >::closure_type,
+          group_binary_closures
+        >::value &&
+        static_cast< int >( group_traits< T >::closure ) ==
+          static_cast< int >( group_binary_closures::alternation )
+    >
+    struct token_kinds_of;
+
+  /**
+   * \brief Specialization dealing with a kind
+   *
+   * \tparam T a group or a symbol type
+   * \tparam KINDS already collected kinds
+   */
+  template< class T, class... KINDS >
+    struct token_kinds_of< T, type_sequence< KINDS... >, false >
+    {
+      /**
+       * \brief Collected kinds, including this one
+       */
+      using type = type_sequence< KINDS..., T >;
+    };
+
+  /**
+   * \brief Specialization dealing with an alternation, collecting kinds of
+   * its first operand, then kinds of its second operand
+   *
+   * \tparam T an alternation group type
+   * \tparam KINDS already collected kinds
+   */
+  template< class T, class KINDS >
+    struct token_kinds_of< T, KINDS, true >
+    {
+      /**
+       * \brief All collected kinds
+       */
+      using type =
+        typename token_kinds_of
+        <
+          typename group_traits< T >::second_operand,
+          typename token_kinds_of
+            < typename group_traits< T >::first_operand, KINDS >::type
+        >::type;
+    };
+
+  /**
+   * \brief Convenient alias to get token kinds of a grammar
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    using token_kinds_of_t =
+      typename token_kinds_of< GRAMMAR, type_sequence<> >::type;
+
+  /**
+   * \brief Marks a lookback that cannot be bounded
+   */
+  inline constexpr std::size_t unbounded_lookback =
+    std::numeric_limits< std::size_t >::max();
+
+  /**
+   * \brief Computes the longest run of non final states a deterministic
+   * automaton may go through after having left a final state, before either
+   * reaching a final state again or failing. A tokenizer reads at most that
+   * many letters beyond the end of a token, plus the letter ending its run.
+   *
+   * \tparam TABLE a compact automaton table type, whose types are computed
+   *
+   * \param table the table
+   *
+   * \return the lookback, or unbounded_lookback if some run of non final
+   * states may loop
+   */
+  template< class TABLE >
+    constexpr std::size_t measure_lookback( const TABLE &table )
+    {
+      constexpr auto state_count = TABLE::state_count;
+
+      const auto is_pending = [ & ]( std::size_t state )
+      {
+        return
+          state != TABLE::no_state &&
+          ! table.final_states[ state ] &&
+          table.types[ state ] != state_types::dead;
+      };
+
+      // depths only grow, exceeding the state count means a loop
+      std::array< std::size_t, state_count > depths {};
+
+      for( bool is_changed = true; is_changed; )
+      {
+        is_changed = false;
+
+        for( std::size_t s = 0; s < state_count; ++s )
+        {
+          if( ! is_pending( s ) )
+            continue;
+
+          std::size_t depth = 1;
+
+          for( std::size_t c = 0; c < TABLE::class_count; ++c )
+          {
+            const auto target = table.class_target( s, c );
+
+            if( is_pending( target ) && depths[ target ] + 1 > depth )
+              depth = depths[ target ] + 1;
+          }
+
+          if( depth > state_count )
+            return unbounded_lookback;
+
+          if( depth != depths[ s ] )
+          {
+            depths[ s ] = depth;
+            is_changed = true;
+          }
+        }
+      }
+
+      std::size_t result = 0;
+
+      for( std::size_t s = 0; s < state_count; ++s )
+        if( table.final_states[ s ] )
+          for( std::size_t c = 0; c < TABLE::class_count; ++c )
+          {
+            const auto target = table.class_target( s, c );
+
+            if( is_pending( target ) && depths[ target ] > result )
+              result = depths[ target ];
+          }
+
+      return result;
+    }
+
+  /**
+   * \brief Remembers nothing about runs of a tokenizer, for token kinds with
+   * a bounded lookback : each run already reads a bounded number of letters
+   * beyond its token
+   */
+  struct no_token_failures
+  {
+    /**
+     * \brief Builds an empty memory
+     */
+    constexpr no_token_failures( std::size_t, std::size_t ) {}
+
+    /**
+     * \brief Indicates if a run reaching a state at an offset is known to
+     * find no longer token
+     *
+     * \return false, nothing being remembered
+     */
+    constexpr bool is_failing( std::size_t, std::size_t ) const
+    { return false; }
+
+    /**
+     * \brief Records a state reached at an offset, beyond the last token
+     * found by the current run
+     */
+    constexpr void visit( std::size_t, std::size_t ) {}
+
+    /**
+     * \brief Tells the current run found a token
+     */
+    constexpr void accept() {}
+
+    /**
+     * \brief Tells the current run ended
+     */
+    constexpr void fail() {}
+  };
+
+  /**
+   * \brief Remembers pairs of state and offset from which a tokenizer run
+   * reaches no final state, for token kinds with an unbounded lookback. The
+   * automaton being deterministic, a later run reaching such a pair can stop
+   * at once, thus, each pair is read beyond a token at most once and the
+   * whole input is split in linear time (Reps' maximal munch). The memory
+   * costs a bit per state and offset.
+   */
+  class token_failure_table
+  {
+  public :
+    /**
+     * \brief Builds an empty memory
+     *
+     * \param state_count the number of states of the automaton
+     * \param size the size of the input
+     */
+    token_failure_table( std::size_t state_count, std::size_t size ) :
+      state_count_ { state_count },
+      failures_( state_count * ( size + 1 ) ),
+      pending_ {}
+    {}
+
+    /**
+     * \brief Indicates if a run reaching a state at an offset is known to
+     * find no longer token
+     *
+     * \param state the reached state
+     * \param offset the offset of the next letter
+     *
+     * \return true if the pair is known to reach no final state
+     */
+    bool is_failing( std::size_t state, std::size_t offset ) const
+    { return failures_[ offset * state_count_ + state ]; }
+
+    /**
+     * \brief Records a state reached at an offset, beyond the last token
+     * found by the current run
+     *
+     * \param state the reached state
+     * \param offset the offset of the next letter
+     */
+    void visit( std::size_t state, std::size_t offset )
+    { pending_.push_back( offset * state_count_ + state ); }
+
+    /**
+     * \brief Tells the current run found a token, pairs visited so far
+     * leading to it
+     */
+    void accept() { pending_.clear(); }
+
+    /**
+     * \brief Tells the current run ended, pairs visited since its last
+     * token leading to no final state
+     */
+    void fail()
+    {
+      for( const auto pair : pending_ )
+        failures_[ pair ] = true;
+
+      pending_.clear();
+    }
+
+  private :
+    /**
+     * \brief The number of states of the automaton
+     */
+    std::size_t state_count_;
+
+    /**
+     * \brief A bit per state and offset, set for failing pairs
+     */
+    std::vector< bool > failures_;
+
+    /**
+     * \brief Pairs visited since the last token of the current run
+     */
+    std::vector< std::size_t > pending_;
+  };
+
+  /**
+   * \brief Compiles token kinds of a grammar into a single anchored
+   * deterministic automaton, each final state knowing the kind of the token
+   * it ends. This version deals with the sequence of kinds
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \tparam KINDS a type sequence of token kinds
+   */
+  template< std::size_t STATE_BUDGET, class KINDS >
+    struct token_kinds_grammar;
+
+  /**
+   * \brief Specialization extracting token kinds
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \tparam KINDS token kinds, in priority order
+   */
+  template< std::size_t STATE_BUDGET, class... KINDS >
+    struct token_kinds_grammar< STATE_BUDGET, type_sequence< KINDS... > >
+    {
+    private :
+      /**
+       * \brief The anchored union of kinds
+       */
+      using union_ = basic_union_grammar< STATE_BUDGET, true, KINDS... >;
+
+    public :
+      /**
+       * \brief The number of token kinds
+       */
+      static constexpr std::size_t kind_count = sizeof...( KINDS );
+
+      /**
+       * \brief Marks a state ending no token
+       */
+      static constexpr std::size_t no_kind = kind_count;
+
+      /**
+       * \brief The type of the compact table
+       */
+      using table_type = typename union_::table_type;
+
+      /**
+       * \brief The compact table of the union of kinds
+       */
+      static constexpr const table_type &table = union_::table;
+
+    private :
+      /**
+       * \brief Resolves the kind of each final state, the first kind in
+       * group order winning when several kinds end there
+       *
+       * \return the kind of each state, no_kind for non final states
+       */
+      static constexpr auto make_kinds()
+      {
+        std::array< std::size_t, table_type::state_count > result {};
+
+        for( std::size_t s = 0; s < table_type::state_count; ++s )
+        {
+          const auto &accepted = union_::accepted[ table.final_actions[ s ] ];
+
+          result[ s ] = no_kind;
+
+          for( std::size_t k = kind_count; k-- != 0; )
+            if( table.final_states[ s ] && accepted.contains( k ) )
+              result[ s ] = k;
+        }
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief The kind of the token ending in each state
+       */
+      static constexpr std::array< std::size_t, table_type::state_count >
+        kinds = make_kinds();
+
+      /**
+       * \brief The number of letters that may be read beyond a token
+       */
+      static constexpr std::size_t lookback = measure_lookback( table );
+    };
+
+  /**
+   * \brief Compiles a grammar whose top level alternations list token kinds
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET >
+    using token_grammar =
+      token_kinds_grammar< STATE_BUDGET, token_kinds_of_t< GRAMMAR > >;
+}
+
+#endif // _WARP_SPARK_DETAIL_TOKEN_GRAMMAR_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compile-time pipeline turning a grammar listing token
+ * kinds into an anchored automaton resolving token kinds by group order
+ */
@@ -0,0 +1,125 @@
+#ifndef _WARP_SPARK_DETAIL_TOTAL_AUTOMATON_TABLE_HPP_
+#define _WARP_SPARK_DETAIL_TOTAL_AUTOMATON_TABLE_HPP_
+
+#include "../../core/numeric.hpp"
+#include "letter_set.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Total form of a deterministic automaton : missing transitions lead
+   * to a sink state, looping on every letter class and never final. Thus, a
+   * run never has to check for a rejection, keeping its loop free of any
+   * branch. Transition actions are not kept : such a table only serves
+   * recognition.
+   *
+   * \tparam STATE_COUNT the number of states of the automaton, the sink
+   * excluded
+   * \tparam CLASS_COUNT the number of letter classes
+   */
+  template< std::size_t STATE_COUNT, std::size_t CLASS_COUNT >
+    struct total_automaton_table
+    {
+      /**
+       * \brief The smallest type able to hold a state, the sink included
+       */
+      using state_type = unsigned_auto_constant_t< STATE_COUNT >;
+
+      /**
+       * \brief The smallest type able to hold a letter class
+       */
+      using class_type = unsigned_auto_constant_t< CLASS_COUNT - 1 >;
+
+      /**
+       * \brief Exposes the number of letter classes
+       */
+      static constexpr std::size_t class_count = CLASS_COUNT;
+
+      /**
+       * \brief The sink state
+       */
+      static constexpr std::size_t sink = STATE_COUNT;
+
+      /**
+       * \brief Gets the target state of a transition
+       *
+       * \param state the source state
+       * \param letter the letter read in the source state
+       *
+       * \return the target state, the sink if there is no transition
+       */
+      constexpr std::size_t target
+      ( std::size_t state, unsigned char letter ) const
+      { return targets[ state * CLASS_COUNT + classes[ letter ] ]; }
+
+      /**
+       * \brief Index of the initial state
+       */
+      std::size_t initial_state = 0;
+
+      /**
+       * \brief The class of each letter
+       */
+      std::array< class_type, letter_set::letter_count > classes {};
+
+      /**
+       * \brief Indicates, for each state, if it is final
+       */
+      std::array< bool, STATE_COUNT + 1 > final_states {};
+
+      /**
+       * \brief Target state of each cell, the sink row included
+       */
+      std::array< state_type, ( STATE_COUNT + 1 ) * CLASS_COUNT > targets {};
+    };
+
+  /**
+   * \brief Builds the total form of a compact automaton table
+   *
+   * \tparam TOTAL a total automaton table type, sized after the source table
+   * \tparam TABLE a compact automaton table type
+   *
+   * \param table the source table
+   *
+   * \return the total table
+   */
+  template< class TOTAL, class TABLE >
+    constexpr TOTAL build_total_automaton_table( const TABLE &table )
+    {
+      using state_type = typename TOTAL::state_type;
+      using class_type = typename TOTAL::class_type;
+
+      TOTAL result;
+
+      result.initial_state = table.initial_state;
+
+      for( std::size_t l = 0; l < letter_set::letter_count; ++l )
+        result.classes[ l ] = static_cast< class_type >( table.classes[ l ] );
+
+      for( std::size_t s = 0; s <= TABLE::state_count; ++s )
+      {
+        result.final_states[ s ] =
+          s != TOTAL::sink && table.final_states[ s ];
+
+        for( std::size_t c = 0; c < TABLE::class_count; ++c )
+          result.targets[ s * TABLE::class_count + c ] =
+            static_cast< state_type >
+              ( s == TOTAL::sink ? TOTAL::sink : table.class_target( s, c ) );
+      }
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_TOTAL_AUTOMATON_TABLE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the total form of automaton tables, whose missing
+ * transitions lead to a sink state
+ */
@@ -0,0 +1,358 @@
+#ifndef _WARP_SPARK_DETAIL_TRANSCRIPTION_ENGINE_HPP_
+#define _WARP_SPARK_DETAIL_TRANSCRIPTION_ENGINE_HPP_
+
+#include "../../core/types.hpp"
+#include "automaton_g_command_types.hpp"
+#include "automaton_table.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Indicates if a transducer exposes a callback for a command type.
+   * This non specialized version is used when the transducer does not expose
+   * any callback for the command type
+   *
+   * \tparam TYPE the command type
+   * \tparam TRANSDUCER the transducer type
+   * \tparam ITERATOR the iterator type given to callbacks
+   */
+  template
+    <
+      group_command_types TYPE, class TRANSDUCER, class ITERATOR,
+      class = sfinae_type_t<>
+    >
+    struct has_transducer_callback
+    {
+      /**
+       * \brief The callback does not exist
+       */
+      static constexpr bool value = false;
+    };
+
+  /**
+   * \brief Specialization detecting a capturing callback, called with the
+   * group index and an iterator on the captured letter
+   *
+   * \tparam TRANSDUCER the transducer type
+   * \tparam ITERATOR the iterator type given to callbacks
+   */
+  template< class TRANSDUCER, class ITERATOR >
+    struct has_transducer_callback
+    <
+      group_command_types::capturing, TRANSDUCER, ITERATOR,
+      sfinae_type_t
+      <
+        decltype( std::declval< TRANSDUCER & >().
+                    capturing( std::size_t {}, std::declval< ITERATOR >() ) )
+      >
+    >
+    {
+      /**
+       * \brief The callback exists
+       */
+      static constexpr bool value = true;
+    };
+
+  /**
+   * \brief Specialization detecting a finishing callback, called with the
+   * group index and an iterator after the last letter of the group
+   *
+   * \tparam TRANSDUCER the transducer type
+   * \tparam ITERATOR the iterator type given to callbacks
+   */
+  template< class TRANSDUCER, class ITERATOR >
+    struct has_transducer_callback
+    <
+      group_command_types::finishing, TRANSDUCER, ITERATOR,
+      sfinae_type_t
+      <
+        decltype( std::declval< TRANSDUCER & >().
+                    finishing( std::size_t {}, std::declval< ITERATOR >() ) )
+      >
+    >
+    {
+      /**
+       * \brief The callback exists
+       */
+      static constexpr bool value = true;
+    };
+
+  /**
+   * \brief Specialization detecting a resetting callback, called with the
+   * group index and an iterator on the first letter the group may capture
+   *
+   * \tparam TRANSDUCER the transducer type
+   * \tparam ITERATOR the iterator type given to callbacks
+   */
+  template< class TRANSDUCER, class ITERATOR >
+    struct has_transducer_callback
+    <
+      group_command_types::resetting, TRANSDUCER, ITERATOR,
+      sfinae_type_t
+      <
+        decltype( std::declval< TRANSDUCER & >().
+                    resetting( std::size_t {}, std::declval< ITERATOR >() ) )
+      >
+    >
+    {
+      /**
+       * \brief The callback exists
+       */
+      static constexpr bool value = true;
+    };
+
+  /**
+   * \brief Fires all commands of an action on a transducer. Commands whose
+   * callback is not exposed by the transducer are ignored.
+   *
+   * \tparam TABLE a compact automaton table type
+   * \tparam TRANSDUCER the transducer type
+   * \tparam ITERATOR the iterator type given to callbacks
+   *
+   * \param table the table owning the action
+   * \param action the action identifier
+   * \param transducer the transducer receiving commands
+   * \param position the iterator given to callbacks
+   */
+  template< class TABLE, class TRANSDUCER, class ITERATOR >
+    constexpr void apply_transducer_action
+    (
+      const TABLE &table, std::size_t action,
+      TRANSDUCER &transducer, const ITERATOR &position
+    )
+    {
+      constexpr bool has_capturing =
+        has_transducer_callback
+          < group_command_types::capturing, TRANSDUCER, ITERATOR >::value;
+      constexpr bool has_finishing =
+        has_transducer_callback
+          < group_command_types::finishing, TRANSDUCER, ITERATOR >::value;
+      constexpr bool has_resetting =
+        has_transducer_callback
+          < group_command_types::resetting, TRANSDUCER, ITERATOR >::value;
+
+      for( auto c = table.action_begin( action );
+           c < table.action_end( action );
+           ++c )
+      {
+        const auto &command = table.commands[ c ];
+
+        switch( command.type )
+        {
+          case group_command_types::capturing :
+            if constexpr( has_capturing )
+              transducer.capturing( command.group, position );
+            break;
+
+          case group_command_types::finishing :
+            if constexpr( has_finishing )
+              transducer.finishing( command.group, position );
+            break;
+
+          case group_command_types::resetting :
+            if constexpr( has_resetting )
+              transducer.resetting( command.group, position );
+            break;
+        }
+      }
+    }
+
+  /**
+   * \brief Runs a compact automaton table on an input range, firing commands
+   * of each transition on a transducer. Neither allocation nor virtual call
+   * is made, each letter costing a class lookup and a table lookup. Commands
+   * of a transition merge those of all parses, see transcribe.
+   *
+   * \tparam TABLE a compact automaton table type
+   * \tparam ITERATOR a forward iterator type on letters
+   * \tparam TRANSDUCER the transducer type
+   *
+   * \param table the table to run
+   * \param first the beginning of the input
+   * \param last the end of the input
+   * \param transducer the transducer receiving commands
+   *
+   * \return true if the whole input is recognized, false otherwise. If false
+   * is returned, the transducer may have received commands for the
+   * recognized prefix of the input.
+   */
+  template< class TABLE, class ITERATOR, class TRANSDUCER >
+    constexpr bool run_transcription
+    (
+      const TABLE &table, ITERATOR first, ITERATOR last,
+      TRANSDUCER &transducer
+    )
+    {
+      std::size_t state = table.initial_state;
+
+      for( ; first != last; ++first )
+      {
+        const std::size_t klass =
+          table.classes[ static_cast< unsigned char >( *first ) ];
+        const auto action = table.class_action( state, klass );
+
+        state = table.class_target( state, klass );
+
+        if( state == table.no_state )
+          return false;
+
+        if( action != table.no_action )
+          apply_transducer_action( table, action, transducer, first );
+      }
+
+      if( ! table.final_states[ state ] )
+        return false;
+
+      apply_transducer_action
+        ( table, table.final_actions[ state ], transducer, last );
+
+      return true;
+    }
+
+  /**
+   * \brief Adapts a transducer working with offsets to a transcription over a
+   * contiguous buffer. Pointers given to callbacks are turned into offsets
+   * from the beginning of the buffer before being forwarded.
+   *
+   * \tparam TRANSDUCER the adapted transducer type
+   * \tparam LETTER the type of letters of the buffer
+   */
+  template< class TRANSDUCER, class LETTER >
+    class offset_transducer
+    {
+    public :
+      /**
+       * \brief Adapts a transducer
+       *
+       * \param transducer the adapted transducer
+       * \param base the beginning of the buffer
+       */
+      constexpr offset_transducer
+      ( TRANSDUCER &transducer, const LETTER *base ) :
+        transducer_ { transducer }, base_ { base } {}
+
+      /**
+       * \brief Forwards a capturing command
+       *
+       * \param group the group index
+       * \param position the captured letter
+       */
+      constexpr void capturing( std::size_t group, const LETTER *position )
+      {
+        if constexpr( has_transducer_callback
+                        < group_command_types::capturing,
+                          TRANSDUCER, std::size_t >::value )
+          transducer_.capturing( group, offset( position ) );
+      }
+
+      /**
+       * \brief Forwards a finishing command
+       *
+       * \param group the group index
+       * \param position the end of the group
+       */
+      constexpr void finishing( std::size_t group, const LETTER *position )
+      {
+        if constexpr( has_transducer_callback
+                        < group_command_types::finishing,
+                          TRANSDUCER, std::size_t >::value )
+          transducer_.finishing( group, offset( position ) );
+      }
+
+      /**
+       * \brief Forwards a resetting command
+       *
+       * \param group the group index
+       * \param position the beginning of the group
+       */
+      constexpr void resetting( std::size_t group, const LETTER *position )
+      {
+        if constexpr( has_transducer_callback
+                        < group_command_types::resetting,
+                          TRANSDUCER, std::size_t >::value )
+          transducer_.resetting( group, offset( position ) );
+      }
+
+    private :
+      /**
+       * \brief Turns a position into an offset
+       *
+       * \param position a position in the buffer
+       *
+       * \return the offset of the position from the beginning of the buffer
+       */
+      constexpr std::size_t offset( const LETTER *position ) const
+      { return static_cast< std::size_t >( position - base_ ); }
+
+      /**
+       * \brief The adapted transducer
+       */
+      TRANSDUCER &transducer_;
+
+      /**
+       * \brief The beginning of the buffer
+       */
+      const LETTER *base_;
+    };
+
+  /**
+   * \brief The outcome of a transcription, when the transducer is owned by
+   * the transcription itself
+   *
+   * \tparam TRANSDUCER the transducer type
+   */
+  template< class TRANSDUCER >
+    struct transcription_outcome
+    {
+      /**
+       * \brief Indicates if the input is recognized
+       */
+      bool is_recognized;
+
+      /**
+       * \brief The transducer, after it received all group commands
+       */
+      TRANSDUCER transducer;
+    };
+
+  /**
+   * \brief Runs a compact automaton table on an input range, using a default
+   * constructed transducer returned with the recognition result. Used by
+   * compile-time transcriptions.
+   *
+   * \tparam TRANSDUCER a default constructible transducer type
+   * \tparam TABLE a compact automaton table type
+   * \tparam ITERATOR a forward iterator type on letters
+   *
+   * \param table the table to run
+   * \param first the beginning of the input
+   * \param last the end of the input
+   *
+   * \return the outcome of the transcription
+   */
+  template< class TRANSDUCER, class TABLE, class ITERATOR >
+    constexpr transcription_outcome< TRANSDUCER > run_transcription_outcome
+    ( const TABLE &table, ITERATOR first, ITERATOR last )
+    {
+      transcription_outcome< TRANSDUCER > result { false, TRANSDUCER {} };
+
+      result.is_recognized =
+        run_transcription( table, first, last, result.transducer );
+
+      return result;
+    }
+}
+
+#endif // _WARP_SPARK_DETAIL_TRANSCRIPTION_ENGINE_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the engine running compact automaton tables on inputs and
+ * the detection of transducer callbacks
+ */
@@ -0,0 +1,308 @@
+#ifndef _WARP_SPARK_DETAIL_UNION_GRAMMAR_HPP_
+#define _WARP_SPARK_DETAIL_UNION_GRAMMAR_HPP_
+
+#include "automaton_g_command_types.hpp"
+#include "automaton_minimization.hpp"
+#include "automaton_table.hpp"
+#include "bit_set.hpp"
+#include "compact_automaton_table.hpp"
+#include "compiled_grammar.hpp"
+#include "letter_classes.hpp"
+#include "letter_set.hpp"
+#include "subset_construction.hpp"
+#include "thompson_nfa.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace warp::spark::detail
+{
+  /**
+   * \brief Computes sizes of the Thompson automaton of an union of grammars.
+   * Member automata are copied without their commands, and the union adds a
+   * start state, an accepting state, an edge from the start state to each
+   * member, a tagged edge from each member to the accepting state and, if
+   * the union is not anchored, a loop on the start state
+   *
+   * \tparam IS_ANCHORED indicates if the union only recognizes parts of
+   * inputs starting at their beginning
+   * \tparam GRAMMARS root groups of united grammars
+   *
+   * \return sizes of the automaton
+   */
+  template< bool IS_ANCHORED, class... GRAMMARS >
+    constexpr thompson_nfa_size measure_union_nfa()
+    {
+      constexpr auto count = sizeof...( GRAMMARS );
+
+      return thompson_nfa_size
+      {
+        ( thompson_grammar< GRAMMARS >::nfa_size.state_count + ... + 2 ),
+        ( thompson_grammar< GRAMMARS >::nfa_size.edge_count + ... +
+          ( 2 * count + ( IS_ANCHORED ? 0 : 1 ) ) ),
+        count
+      };
+    }
+
+  /**
+   * \brief Copies a member automaton into an union automaton, linking it to
+   * the start and the accepting states of the union. The edge reaching the
+   * accepting state is tagged with a finishing command on the member index,
+   * commands of the member itself are dropped
+   *
+   * \tparam NFA the union automaton type
+   * \tparam MEMBER the member automaton type
+   *
+   * \param nfa the union automaton
+   * \param member the member automaton
+   * \param index the index of the member in the union
+   */
+  template< class NFA, class MEMBER >
+    constexpr void append_union_member
+    ( NFA &nfa, const MEMBER &member, std::size_t index )
+    {
+      const auto offset = nfa.state_count;
+
+      for( std::size_t s = 0; s < member.state_count; ++s )
+        nfa.add_state();
+
+      for( std::size_t e = 0; e < member.edge_count; ++e )
+      {
+        const auto &edge = member.edges[ e ];
+
+        nfa.add_edge
+          ( edge.from + offset, edge.to + offset,
+            edge.is_epsilon, edge.letters );
+      }
+
+      nfa.add_edge( nfa.start, member.start + offset, true );
+      nfa.add_edge( member.accept + offset, nfa.accept, true );
+      nfa.add_command( group_command_types::finishing, index );
+    }
+
+  /**
+   * \brief Builds the Thompson automaton of an union of grammars. Unless the
+   * union is anchored, the start state loops on every letter, thus, the
+   * automaton recognizes any input ending with a part recognized by a member.
+   * Finishing commands met on the way to the accepting state tell which
+   * members recognize it
+   *
+   * \tparam NFA a Thompson automaton type, sized using measure_union_nfa
+   * \tparam IS_ANCHORED indicates if the union only recognizes parts of
+   * inputs starting at their beginning
+   * \tparam GRAMMARS root groups of united grammars
+   *
+   * \return the automaton
+   */
+  template< class NFA, bool IS_ANCHORED, class... GRAMMARS >
+    constexpr NFA build_union_nfa()
+    {
+      NFA result;
+      std::size_t index = 0;
+
+      result.start = result.add_state();
+      result.accept = result.add_state();
+      result.group_count = sizeof...( GRAMMARS );
+
+      ( append_union_member
+          ( result, thompson_grammar< GRAMMARS >::nfa, index++ ), ... );
+
+      if constexpr( ! IS_ANCHORED )
+        result.add_edge
+          ( result.start, result.start, false, letter_set::all() );
+
+      return result;
+    }
+
+  /**
+   * \brief Computes the letter partition of an union of grammars, refining
+   * the partition with each class of each member
+   *
+   * \tparam GRAMMARS root groups of united grammars
+   *
+   * \return the letter partition
+   */
+  template< class... GRAMMARS >
+    constexpr letter_classes union_letter_classes()
+    {
+      letter_classes result;
+
+      const auto refine = [ & ]( const letter_classes &classes )
+      {
+        for( std::size_t c = 0; c < classes.class_count; ++c )
+          result.refine( classes.letters_of( c ) );
+      };
+
+      ( refine( thompson_grammar< GRAMMARS >::classes ), ... );
+
+      return result;
+    }
+
+  /**
+   * \brief Compiles an union of grammars into a single compact automaton
+   * table, using the same pipeline as compiled_grammar. The final action of
+   * each state holds a finishing command for each grammar recognizing a part
+   * of the input ending at this state, the group of the command being the
+   * index of the grammar. Thus, a single pass over an input finds matches of
+   * all grammars.
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \tparam IS_ANCHORED indicates if the union only recognizes parts of
+   * inputs starting at their beginning
+   * \tparam GRAMMARS root groups of united grammars
+   */
+  template< std::size_t STATE_BUDGET, bool IS_ANCHORED, class... GRAMMARS >
+    struct basic_union_grammar
+    {
+      /**
+       * \brief The number of united grammars
+       */
+      static constexpr std::size_t grammar_count = sizeof...( GRAMMARS );
+
+      /**
+       * \brief Exact sizes of the Thompson automaton
+       */
+      static constexpr thompson_nfa_size nfa_size =
+        measure_union_nfa< IS_ANCHORED, GRAMMARS... >();
+
+      /**
+       * \brief The type of the Thompson automaton
+       */
+      using nfa_type =
+        thompson_nfa
+        <
+          nfa_size.state_count,
+          nfa_size.edge_count,
+          nfa_size.command_count
+        >;
+
+      /**
+       * \brief The Thompson automaton of the union
+       */
+      static constexpr nfa_type nfa =
+        build_union_nfa< nfa_type, IS_ANCHORED, GRAMMARS... >();
+
+      /**
+       * \brief The letter partition of the union
+       */
+      static constexpr letter_classes classes =
+        union_letter_classes< GRAMMARS... >();
+
+      /**
+       * \brief The type of the subset automaton
+       */
+      using subset_type =
+        subset_automaton
+        <
+          STATE_BUDGET,
+          classes.class_count,
+          nfa_size.state_count,
+          3 * grammar_count
+        >;
+
+      /**
+       * \brief The determinized automaton
+       */
+      static constexpr subset_type subset =
+        determinize< subset_type >( nfa, classes );
+
+      static_assert( subset.is_complete,
+                     "Invalid grammars used. The deterministic automaton of "
+                     "the union exceeds the state budget." );
+
+      /**
+       * \brief Exact sizes of the action storage
+       */
+      static constexpr subset_action_size action_size =
+        measure_subset_actions( subset );
+
+      /**
+       * \brief The type of the deterministic automaton table
+       */
+      using dfa_type =
+        automaton_table
+        <
+          subset.state_count,
+          classes.class_count,
+          action_size.action_count,
+          action_size.command_count
+        >;
+
+      /**
+       * \brief The deterministic automaton table
+       */
+      static constexpr dfa_type dfa =
+        subset_to_automaton_table< dfa_type >( subset, classes );
+
+      /**
+       * \brief The minimal automaton table
+       */
+      static constexpr dfa_type minimal = minimize_automaton_table( dfa );
+
+      /**
+       * \brief The type of the compact table, with exact sizes
+       */
+      using table_type = compact_automaton_table_for< minimal >;
+
+      /**
+       * \brief The compact table of the union
+       */
+      static constexpr table_type table =
+        compress_automaton_table< table_type >( minimal );
+
+      /**
+       * \brief Type of a set of grammars
+       */
+      using grammar_set_type = bit_set< grammar_count >;
+
+    private :
+      /**
+       * \brief Converts each action of the table into the set of grammars it
+       * reports
+       *
+       * \return a set of grammars per action
+       */
+      static constexpr auto make_accepted()
+      {
+        std::array< grammar_set_type, table_type::action_count > result {};
+
+        for( std::size_t a = 0; a < table_type::action_count; ++a )
+          for( auto c = table.action_begin( a );
+               c < table.action_end( a );
+               ++c )
+            result[ a ].insert( table.commands[ c ].group );
+
+        return result;
+      }
+
+    public :
+      /**
+       * \brief Grammars reported by each action of the table
+       */
+      static constexpr std::array< grammar_set_type, table_type::action_count >
+        accepted = make_accepted();
+    };
+
+  /**
+   * \brief Compiles an union of grammars recognizing parts of inputs ending
+   * anywhere
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \tparam GRAMMARS root groups of united grammars
+   */
+  template< std::size_t STATE_BUDGET, class... GRAMMARS >
+    using union_grammar =
+      basic_union_grammar< STATE_BUDGET, false, GRAMMARS... >;
+}
+
+#endif // _WARP_SPARK_DETAIL_UNION_GRAMMAR_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the compile-time pipeline turning several grammars into a
+ * single automaton table able to find matches of all of them at once
+ */
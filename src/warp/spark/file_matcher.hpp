@@ -0,0 +1,115 @@
+#ifndef _WARP_SPARK_FILE_MATCHER_HPP_
+#define _WARP_SPARK_FILE_MATCHER_HPP_
+
+#include "capture_spans.hpp"
+#include "group_traits.hpp"
+#include "transcription.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/transcription_engine.hpp"
+
+#include <filesystem>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Transcribes a whole file using a grammar. The file is mapped
+   * read-only in memory and the automaton reads the mapping directly, thus,
+   * the file is never copied into a buffer. The mapping is read sequentially
+   * and the kernel is told so. The transducer receives offsets from the
+   * beginning of the file, as std::size_t, instead of iterators.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam TRANSDUCER the transducer type
+   *
+   * \param path the path of the file
+   * \param transducer the transducer receiving group commands
+   *
+   * \return true if the whole file is recognized by the grammar, false
+   * otherwise
+   *
+   * \throw std::system_error if the file cannot be opened or mapped
+   */
+  template< class GRAMMAR, class TRANSDUCER >
+    bool match_file
+    (
+      const std::filesystem::path &path, const GRAMMAR &,
+      TRANSDUCER &transducer
+    )
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      const detail::mapped_file file { path };
+      detail::offset_transducer< TRANSDUCER, char > adapter
+        { transducer, file.data() };
+
+      return detail::run_transcription
+        ( detail::compiled_grammar< GRAMMAR >::table,
+          file.data(), file.data() + file.size(), adapter );
+    }
+
+  /**
+   * \brief Parses a whole file using a grammar, recording capture spans of
+   * its leftmost greedy parse, as capture does for a buffer. The file is
+   * mapped read-only in memory and is never copied into a buffer.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param path the path of the file
+   * \param grammar the grammar
+   * \param spans the capture spans to fill, offsets being counted from the
+   * beginning of the file
+   *
+   * \return true if the whole file is recognized by the grammar, false
+   * otherwise
+   *
+   * \throw std::system_error if the file cannot be opened or mapped
+   */
+  template< class GRAMMAR >
+    bool match_file
+    (
+      const std::filesystem::path &path, const GRAMMAR &grammar,
+      capture_spans< GRAMMAR > &spans
+    )
+    {
+      const detail::mapped_file file { path };
+
+      return capture
+        ( grammar, std::string_view { file.data(), file.size() }, spans );
+    }
+
+  /**
+   * \brief Recognizes a whole file using a grammar, without reporting any
+   * command
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param path the path of the file
+   * \param grammar the grammar
+   *
+   * \return true if the whole file is recognized by the grammar, false
+   * otherwise
+   *
+   * \throw std::system_error if the file cannot be opened or mapped
+   */
+  template< class GRAMMAR >
+    bool match_file
+    ( const std::filesystem::path &path, const GRAMMAR &grammar )
+    {
+      recognizing_transducer transducer;
+
+      return match_file( path, grammar, transducer );
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_FILE_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the file matcher of spark, transcribing memory mapped
+ * files
+ */
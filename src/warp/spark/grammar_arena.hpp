@@ -0,0 +1,231 @@
+#ifndef _WARP_SPARK_GRAMMAR_ARENA_HPP_
+#define _WARP_SPARK_GRAMMAR_ARENA_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace warp::spark
+{
+  /**
+   * \brief A monotonic memory resource dedicated to the construction of
+   * automata at run time, usable with any polymorphic allocator. Memory is
+   * carved out of blocks obtained from an upstream resource, deallocations
+   * are no-ops, and all memory is reclaimed at once by a reset. Unlike
+   * std::pmr::monotonic_buffer_resource, a reset keeps blocks for the next
+   * allocations, thus, recompiling grammars with the same arena quickly
+   * stops reaching the upstream resource at all.
+   */
+  class grammar_arena : public std::pmr::memory_resource
+  {
+  public :
+    /**
+     * \brief Builds an arena without any block
+     *
+     * \param block_size the size of the first block, each new block being
+     * twice as large as the previous one
+     * \param upstream the resource blocks are obtained from
+     */
+    explicit grammar_arena
+    (
+      std::size_t block_size = 64 * 1024,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource()
+    ) :
+      upstream_ { upstream }, next_block_size_ { block_size } {}
+
+    /**
+     * \brief Arenas are not copyable, polymorphic allocators referencing
+     * them
+     */
+    grammar_arena( const grammar_arena & ) = delete;
+
+    /**
+     * \brief Arenas are not copyable, polymorphic allocators referencing
+     * them
+     */
+    grammar_arena &operator = ( const grammar_arena & ) = delete;
+
+    /**
+     * \brief Gives all blocks back to the upstream resource
+     */
+    ~grammar_arena() override { release(); }
+
+    /**
+     * \brief Reclaims all memory allocated from the arena, keeping blocks for
+     * next allocations. Anything allocated from the arena must be destroyed
+     * before
+     */
+    void reset()
+    {
+      current_ = 0;
+      offset_ = 0;
+      used_ = 0;
+    }
+
+    /**
+     * \brief Reclaims all memory allocated from the arena, giving blocks back
+     * to the upstream resource. Anything allocated from the arena must be
+     * destroyed before
+     */
+    void release()
+    {
+      for( const auto &block : blocks_ )
+        upstream_->deallocate( block.data, block.size, block_alignment );
+
+      blocks_.clear();
+      reset();
+    }
+
+    /**
+     * \brief Gives the number of blocks held by the arena
+     *
+     * \return the number of blocks obtained from the upstream resource
+     */
+    std::size_t block_count() const { return blocks_.size(); }
+
+    /**
+     * \brief Gives the number of bytes held by the arena
+     *
+     * \return the total size of blocks
+     */
+    std::size_t capacity() const
+    {
+      std::size_t result = 0;
+
+      for( const auto &block : blocks_ )
+        result += block.size;
+
+      return result;
+    }
+
+    /**
+     * \brief Gives the number of bytes allocated since the last reset
+     *
+     * \return the number of allocated bytes, alignment paddings excluded
+     */
+    std::size_t used() const { return used_; }
+
+  private :
+    /**
+     * \brief A block obtained from the upstream resource
+     */
+    struct block
+    {
+      /**
+       * \brief The first byte of the block
+       */
+      std::byte *data;
+
+      /**
+       * \brief The size of the block
+       */
+      std::size_t size;
+    };
+
+    /**
+     * \brief The alignment of blocks, suitable for any scalar type
+     */
+    static constexpr std::size_t block_alignment = alignof( std::max_align_t );
+
+    /**
+     * \brief Carves memory out of the current block, moving to the next
+     * block, kept or new, when the current one is exhausted
+     *
+     * \param bytes the size of the memory to allocate
+     * \param alignment the alignment of the memory to allocate
+     *
+     * \return the allocated memory
+     */
+    void *do_allocate( std::size_t bytes, std::size_t alignment ) override
+    {
+      for( ; current_ < blocks_.size(); ++current_, offset_ = 0 )
+      {
+        const auto &block = blocks_[ current_ ];
+
+        void *result = block.data + offset_;
+        auto space = block.size - offset_;
+
+        if( std::align( alignment, bytes, result, space ) )
+        {
+          offset_ = block.size - space + bytes;
+          used_ += bytes;
+
+          return result;
+        }
+      }
+
+      // a new block, large enough whatever the alignment
+      const auto size = std::max( next_block_size_, bytes + alignment );
+
+      blocks_.push_back
+        ( block
+          {
+            static_cast< std::byte * >
+              ( upstream_->allocate( size, block_alignment ) ),
+            size
+          } );
+      next_block_size_ = 2 * size;
+
+      return do_allocate( bytes, alignment );
+    }
+
+    /**
+     * \brief Does nothing, memory being reclaimed by reset and release
+     */
+    void do_deallocate( void *, std::size_t, std::size_t ) override {}
+
+    /**
+     * \brief Tells if memory allocated from a resource may be deallocated by
+     * the arena
+     *
+     * \param other the other resource
+     *
+     * \return true if the other resource is this arena
+     */
+    bool do_is_equal
+    ( const std::pmr::memory_resource &other ) const noexcept override
+    { return this == &other; }
+
+    /**
+     * \brief The resource blocks are obtained from
+     */
+    std::pmr::memory_resource *upstream_;
+
+    /**
+     * \brief The size of the next block obtained from the upstream resource
+     */
+    std::size_t next_block_size_;
+
+    /**
+     * \brief Blocks held by the arena, in allocation order
+     */
+    std::vector< block > blocks_;
+
+    /**
+     * \brief The index of the block memory is carved out of
+     */
+    std::size_t current_ = 0;
+
+    /**
+     * \brief The offset of the first free byte of the current block
+     */
+    std::size_t offset_ = 0;
+
+    /**
+     * \brief The number of bytes allocated since the last reset
+     */
+    std::size_t used_ = 0;
+  };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_GRAMMAR_ARENA_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the arena memory resource used to build automata at run
+ * time, reusable across grammar compilations
+ */
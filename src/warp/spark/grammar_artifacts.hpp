@@ -0,0 +1,177 @@
+#ifndef _WARP_SPARK_GRAMMAR_ARTIFACTS_HPP_
+#define _WARP_SPARK_GRAMMAR_ARTIFACTS_HPP_
+
+#include "group_traits.hpp"
+#include "regular_grammar_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/grammar_fingerprint.hpp"
+#include "detail/group_node_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Computes a stable fingerprint of a grammar, the same in every
+   * translation unit and with every compiler. This version works with a
+   * regular grammar, whose fingerprint is the one of its definition
+   * sequence, whatever the form of its definition
+   *
+   * \tparam T a regular grammar type
+   */
+  template< class T, bool = group_traits< T >::is_group >
+    struct grammar_fingerprint
+    {
+      static_assert( regular_grammar_traits< T >::is_regular_grammar,
+                     "Invalid type used. Only regular grammar or group types "
+                     "are allowed." );
+
+      /**
+       * \brief The fingerprint of the definition sequence
+       */
+      static constexpr std::uint64_t value =
+        detail::definition_fingerprint
+        <
+          typename regular_grammar_definition_traits
+          <
+            typename regular_grammar_traits< T >::regular_grammar_definition
+          >::regular_grammar_definition_sequence
+        >::value;
+    };
+
+  /**
+   * \brief Specialization dealing with a group, whose fingerprint is the one
+   * of its flattened group tree. Groups whose trees only differ by names
+   * share a fingerprint and build the same automata
+   *
+   * \tparam T a group type
+   */
+  template< class T >
+    struct grammar_fingerprint< T, true >
+    {
+      /**
+       * \brief The fingerprint of the flattened group tree
+       */
+      static constexpr std::uint64_t value =
+        detail::group_nodes_fingerprint( detail::group_dag_from< T >::value );
+    };
+
+  /**
+   * \brief Convenient variable template to get the fingerprint of a grammar
+   *
+   * \tparam T a regular grammar or a group type
+   */
+  template< class T >
+    inline constexpr std::uint64_t grammar_fingerprint_v =
+      grammar_fingerprint< T >::value;
+
+  /**
+   * \brief The compact table of a grammar, reporting group commands. Being
+   * an inline variable, it is emitted once in the whole program, whatever
+   * the number of translation units referencing it
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    inline constexpr const auto &compiled_table_v =
+      detail::compiled_grammar< GRAMMAR, STATE_BUDGET >::table;
+
+  /**
+   * \brief The compact table of a grammar used for recognition only, see
+   * compiled_table_v
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    inline constexpr const auto &recognition_table_v =
+      detail::recognition_grammar< GRAMMAR, STATE_BUDGET >::table;
+
+  /**
+   * \brief Gathers artifacts compiled from a grammar, tagged with the
+   * fingerprint of the grammar. Tables are inline variables. Member
+   * functions are not inline, thus, a program may compile them once, using
+   * an explicit instantiation definition in a single translation unit :
+   * \code
+   * template struct warp::spark::grammar_artifacts< my_grammar >;
+   * \endcode
+   * and an explicit instantiation declaration everywhere else :
+   * \code
+   * extern template struct warp::spark::grammar_artifacts< my_grammar >;
+   * \endcode
+   * The fingerprint lets a translation unit check, at compile time, that
+   * artifacts it references were built from the grammar it expects.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET = 128 >
+    struct grammar_artifacts
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      /**
+       * \brief The fingerprint of the grammar
+       */
+      static constexpr std::uint64_t fingerprint =
+        grammar_fingerprint_v< GRAMMAR >;
+
+      /**
+       * \brief The compact table reporting group commands
+       */
+      static constexpr const auto &compiled_table =
+        compiled_table_v< GRAMMAR, STATE_BUDGET >;
+
+      /**
+       * \brief The compact table used for recognition only
+       */
+      static constexpr const auto &recognition_table =
+        recognition_table_v< GRAMMAR, STATE_BUDGET >;
+
+      /**
+       * \brief Recognizes an input using the recognition table
+       *
+       * \param input the input to recognize
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      static bool recognize( std::string_view input );
+    };
+
+  template< class GRAMMAR, std::size_t STATE_BUDGET >
+    bool grammar_artifacts< GRAMMAR, STATE_BUDGET >::recognize
+    ( std::string_view input )
+    {
+      const auto &table = recognition_table;
+
+      auto state = table.initial_state;
+
+      for( const auto letter : input )
+      {
+        state = table.target( state, static_cast< unsigned char >( letter ) );
+
+        if( state == table.no_state )
+          return false;
+      }
+
+      return table.final_states[ state ];
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_GRAMMAR_ARTIFACTS_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains grammar fingerprints and compiled artifacts of grammars,
+ * shared by all translation units of a program
+ */
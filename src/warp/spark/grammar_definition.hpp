@@ -0,0 +1,827 @@
+#ifndef _WARP_SPARK_GRAMMAR_DEFINITION_HPP_
+#define _WARP_SPARK_GRAMMAR_DEFINITION_HPP_
+
+#include "regular_grammar_type_system_enumerations.hpp"
+#include "detail/letter_set.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace warp::spark
+{
+  /**
+   * \brief Reports an invalid regular grammar definition read at run time
+   */
+  class grammar_definition_error : public std::runtime_error
+  {
+  public :
+    /**
+     * \brief Builds an error
+     *
+     * \param what the description of the error
+     * \param offset the offset of the error in the definition
+     */
+    grammar_definition_error( const std::string &what, std::size_t offset ) :
+      std::runtime_error { what + " at offset " + std::to_string( offset ) },
+      offset_ { offset } {}
+
+    /**
+     * \brief Gives the offset of the error
+     *
+     * \return the offset of the error in the definition
+     */
+    std::size_t offset() const { return offset_; }
+
+  private :
+    /**
+     * \brief The offset of the error
+     */
+    std::size_t offset_;
+  };
+
+  /**
+   * \brief A symbol of a regular grammar definition read at run time
+   */
+  struct grammar_symbol
+  {
+    /**
+     * \brief The name of the symbol
+     */
+    std::string name;
+
+    /**
+     * \brief Letters recognized by the symbol
+     */
+    detail::letter_set letters;
+  };
+
+  /**
+   * \brief A group of a regular grammar definition read at run time
+   */
+  struct grammar_group
+  {
+    /**
+     * \brief The name of the group
+     */
+    std::string name;
+
+    /**
+     * \brief True for a group applying a binary closure
+     */
+    bool is_binary;
+
+    /**
+     * \brief The closure of an unary group
+     */
+    group_unary_closures unary_closure;
+
+    /**
+     * \brief The closure of a binary group
+     */
+    group_binary_closures binary_closure;
+
+    /**
+     * \brief True if the operand of an unary group is a symbol
+     */
+    bool is_first_symbol;
+
+    /**
+     * \brief Index of the first operand, among symbols or groups
+     */
+    std::size_t first;
+
+    /**
+     * \brief Index of the second operand of a binary group, among groups
+     */
+    std::size_t second;
+  };
+
+  /**
+   * \brief A regular grammar definition read at run time. Operands of a group
+   * are always defined before it, the last group being the root of the
+   * grammar
+   */
+  struct grammar_definition
+  {
+    /**
+     * \brief Symbols, in definition order
+     */
+    std::vector< grammar_symbol > symbols;
+
+    /**
+     * \brief Groups, in definition order
+     */
+    std::vector< grammar_group > groups;
+  };
+
+  namespace detail
+  {
+    /**
+     * \brief Reads a regular grammar definition, written in the syntax
+     * documented for compile-time definitions, into a grammar definition
+     * value. Groups created by macros are expanded as documented, groups
+     * inside BINARY_CLOSURE_ON trees being given names that cannot be
+     * written in a definition.
+     */
+    class grammar_definition_parser
+    {
+    public :
+      /**
+       * \brief Builds a parser
+       *
+       * \param input the definition to read
+       */
+      explicit grammar_definition_parser( std::string_view input ) :
+        input_ { input }, offset_ { 0 } {}
+
+      /**
+       * \brief Reads the whole definition
+       *
+       * \return the definition
+       *
+       * \throw grammar_definition_error if the definition is invalid
+       */
+      grammar_definition parse()
+      {
+        expect_marker( "BEGIN_SYMBOLS;" );
+
+        while( ! accept_marker( "END_SYMBOLS;" ) )
+          parse_symbol_statement();
+
+        expect_marker( "BEGIN_GROUPS;" );
+
+        while( ! accept_marker( "END_GROUPS;" ) )
+          parse_group_statement();
+
+        skip_blanks();
+
+        if( ! at_end() )
+          fail( "Unexpected content after the group definition block" );
+
+        if( result_.groups.empty() )
+          fail( "A grammar needs at least a group" );
+
+        return std::move( result_ );
+      }
+
+    private :
+      /**
+       * \brief Tells if the whole input has been read
+       *
+       * \return true at the end of the input
+       */
+      bool at_end() const { return offset_ == input_.size(); }
+
+      /**
+       * \brief Gives the current letter
+       *
+       * \return the current letter, or 0 at the end of the input
+       */
+      char current() const { return at_end() ? '\0' : input_[ offset_ ]; }
+
+      /**
+       * \brief Tells if a letter is a white space
+       *
+       * \param letter the letter
+       *
+       * \return true for spaces, tabulations and end of lines
+       */
+      static bool is_blank( char letter )
+      {
+        return
+          letter == ' ' || letter == '\t' || letter == '\n' || letter == '\r';
+      }
+
+      /**
+       * \brief Reports an error at the current offset
+       *
+       * \param what the description of the error
+       *
+       * \throw grammar_definition_error always
+       */
+      [[ noreturn ]] void fail( const std::string &what ) const
+      { throw grammar_definition_error { what, offset_ }; }
+
+      /**
+       * \brief Skips white spaces and documentation blocks
+       */
+      void skip_blanks()
+      {
+        for( ;; )
+        {
+          if( is_blank( current() ) )
+            ++offset_;
+          else if( input_.substr( offset_, 2 ) == "/*" )
+          {
+            const auto end = input_.find( "*/", offset_ + 2 );
+
+            if( end == std::string_view::npos )
+              fail( "Unterminated documentation block" );
+
+            offset_ = end + 2;
+          }
+          else
+            return;
+        }
+      }
+
+      /**
+       * \brief Reads a marker or a macro name if present
+       *
+       * \param marker the expected marker
+       *
+       * \return true if the marker has been read
+       */
+      bool accept_marker( std::string_view marker )
+      {
+        skip_blanks();
+
+        if( input_.substr( offset_, marker.size() ) != marker )
+          return false;
+
+        offset_ += marker.size();
+
+        return true;
+      }
+
+      /**
+       * \brief Reads a marker
+       *
+       * \param marker the expected marker
+       *
+       * \throw grammar_definition_error if the marker is missing
+       */
+      void expect_marker( std::string_view marker )
+      {
+        if( ! accept_marker( marker ) )
+          fail( "Expected " + std::string { marker } );
+      }
+
+      /**
+       * \brief Reads a macro name followed by a white space, if present
+       *
+       * \param macro the macro name
+       *
+       * \return true if the macro name has been read
+       */
+      bool accept_macro( std::string_view macro )
+      {
+        const auto end = offset_ + macro.size();
+
+        if( input_.substr( offset_, macro.size() ) != macro ||
+            end >= input_.size() || ! is_blank( input_[ end ] ) )
+          return false;
+
+        offset_ += macro.size();
+
+        return true;
+      }
+
+      /**
+       * \brief Reads the name of a definition, up to a white space or the
+       * assignation letter
+       *
+       * \return the name
+       */
+      std::string read_name()
+      {
+        const auto begin = offset_;
+
+        while( ! at_end() && ! is_blank( current() ) && current() != '=' )
+          ++offset_;
+
+        if( offset_ == begin )
+          fail( "Expected a name" );
+
+        return std::string { input_.substr( begin, offset_ - begin ) };
+      }
+
+      /**
+       * \brief Reads a macro operand, up to a white space or the end of the
+       * statement
+       *
+       * \return the operand, empty at the end of the statement
+       */
+      std::string read_operand()
+      {
+        skip_blanks();
+
+        const auto begin = offset_;
+
+        while( ! at_end() && ! is_blank( current() ) && current() != ';' )
+          ++offset_;
+
+        return std::string { input_.substr( begin, offset_ - begin ) };
+      }
+
+      /**
+       * \brief Reads the assignation letter of a definition
+       */
+      void expect_assignation()
+      {
+        skip_blanks();
+
+        if( current() != '=' )
+          fail( "Expected =" );
+
+        ++offset_;
+        skip_blanks();
+      }
+
+      /**
+       * \brief Reads the end of a statement
+       */
+      void expect_end_of_statement()
+      {
+        skip_blanks();
+
+        if( current() != ';' )
+          fail( "Expected ;" );
+
+        ++offset_;
+      }
+
+      /**
+       * \brief Reads an escaped part, the opening ` being the current letter.
+       * A ` following the opening one is a raw letter
+       *
+       * \return letters of the escaped part
+       */
+      std::string read_escaped()
+      {
+        const auto begin = ++offset_;
+
+        if( current() == '`' )
+          ++offset_;
+
+        while( ! at_end() && current() != '`' )
+          ++offset_;
+
+        if( at_end() )
+          fail( "Unterminated escaped part" );
+
+        if( offset_ == begin )
+          fail( "Empty escaped part" );
+
+        return std::string { input_.substr( begin, offset_++ - begin ) };
+      }
+
+      /**
+       * \brief Reads letters of a symbol value up to the end of the
+       * statement, white spaces being separators unless escaped
+       *
+       * \return read letters
+       */
+      std::string read_letters()
+      {
+        if( current() == '`' )
+        {
+          auto result = read_escaped();
+
+          expect_end_of_statement();
+
+          return result;
+        }
+
+        std::string result;
+
+        for( skip_blanks(); ! at_end() && current() != ';'; skip_blanks() )
+          result += input_[ offset_++ ];
+
+        expect_end_of_statement();
+
+        return result;
+      }
+
+      /**
+       * \brief Defines a symbol
+       *
+       * \param name the name of the symbol
+       * \param letters letters recognized by the symbol
+       * \param is_redefinable true if an identical definition is allowed
+       */
+      void add_symbol
+      ( const std::string &name, const letter_set &letters,
+        bool is_redefinable )
+      {
+        const auto found = symbols_.find( name );
+
+        if( found != symbols_.end() )
+        {
+          if( ! is_redefinable ||
+              result_.symbols[ found->second ].letters != letters )
+            fail( "Symbol " + name + " already defined" );
+
+          return;
+        }
+
+        symbols_.emplace( name, result_.symbols.size() );
+        result_.symbols.push_back( grammar_symbol { name, letters } );
+      }
+
+      /**
+       * \brief Reads a symbol definition or a symbol macro
+       */
+      void parse_symbol_statement()
+      {
+        if( accept_macro( "BASIC_SYMBOLS" ) )
+        {
+          for( skip_blanks(); current() != ';'; skip_blanks() )
+          {
+            if( at_end() || current() == '=' )
+              fail( "Invalid basic symbol" );
+
+            letter_set letters;
+
+            letters.insert( static_cast< unsigned char >( current() ) );
+            add_symbol( std::string( 1, input_[ offset_++ ] ), letters, true );
+          }
+
+          ++offset_;
+
+          return;
+        }
+
+        const auto name = read_name();
+
+        expect_assignation();
+
+        if( current() == '-' )
+        {
+          ++offset_;
+
+          letter_set letters;
+
+          for( const auto letter : read_letters() )
+            letters.insert( static_cast< unsigned char >( letter ) );
+
+          add_symbol( name, letters.complement(), false );
+
+          return;
+        }
+
+        const auto is_any = current() == '.';
+        const auto letters = read_letters();
+
+        if( letters.size() != 1 )
+          fail( "Inclusive symbol " + name + " needs a single letter" );
+
+        letter_set set;
+
+        set.insert( static_cast< unsigned char >( letters[ 0 ] ) );
+        add_symbol( name, is_any ? letter_set::all() : set, false );
+      }
+
+      /**
+       * \brief Defines a group
+       *
+       * \param group the group
+       */
+      void add_group( grammar_group group )
+      {
+        if( groups_.count( group.name ) != 0 )
+          fail( "Group " + group.name + " already defined" );
+
+        groups_.emplace( group.name, result_.groups.size() );
+        result_.groups.push_back( std::move( group ) );
+      }
+
+      /**
+       * \brief Looks a group up
+       *
+       * \param name the name of the group
+       *
+       * \return the index of the group
+       */
+      std::size_t find_group( const std::string &name ) const
+      {
+        const auto found = groups_.find( name );
+
+        if( found == groups_.end() )
+          fail( "Unknown group " + name );
+
+        return found->second;
+      }
+
+      /**
+       * \brief Defines a group applying an unary closure, its operand being
+       * looked up among groups first, then among symbols
+       *
+       * \param name the name of the group
+       * \param closure the closure
+       * \param operand the name of the operand
+       */
+      void add_unary_group
+      ( const std::string &name, group_unary_closures closure,
+        const std::string &operand )
+      {
+        grammar_group group {};
+
+        group.name = name;
+        group.unary_closure = closure;
+
+        if( groups_.count( operand ) != 0 )
+          group.first = find_group( operand );
+        else
+        {
+          const auto found = symbols_.find( operand );
+
+          if( found == symbols_.end() )
+            fail( "Unknown group or symbol " + operand );
+
+          group.is_first_symbol = true;
+          group.first = found->second;
+        }
+
+        add_group( std::move( group ) );
+      }
+
+      /**
+       * \brief Defines a group applying a binary closure on groups
+       *
+       * \param name the name of the group
+       * \param closure the closure
+       * \param first the index of the first group
+       * \param second the index of the second group
+       */
+      void add_binary_group
+      ( const std::string &name, group_binary_closures closure,
+        std::size_t first, std::size_t second )
+      {
+        grammar_group group {};
+
+        group.name = name;
+        group.is_binary = true;
+        group.binary_closure = closure;
+        group.first = first;
+        group.second = second;
+
+        add_group( std::move( group ) );
+      }
+
+      /**
+       * \brief Tells if a letter is an unary closure meta character
+       *
+       * \param letter the letter
+       *
+       * \return true for *, + and ?
+       */
+      static bool is_unary_closure( char letter )
+      { return letter == '*' || letter == '+' || letter == '?'; }
+
+      /**
+       * \brief Gives the unary closure of a meta character
+       *
+       * \param letter one of *, + and ?
+       *
+       * \return the closure
+       */
+      static group_unary_closures unary_closure_of( char letter )
+      {
+        return
+          letter == '*' ? group_unary_closures::zero_many :
+          letter == '+' ? group_unary_closures::one_many :
+          group_unary_closures::zero_one;
+      }
+
+      /**
+       * \brief Gives the binary closure of a meta character
+       *
+       * \param letter one of . and |
+       *
+       * \return the closure
+       */
+      static group_binary_closures binary_closure_of( char letter )
+      {
+        return
+          letter == '.' ?
+            group_binary_closures::concatenation :
+            group_binary_closures::alternation;
+      }
+
+      /**
+       * \brief Reads the right hand side of a group definition
+       *
+       * \param name the name of the defined group
+       */
+      void parse_group_value( const std::string &name )
+      {
+        const auto begin = offset_;
+
+        std::string first;
+
+        if( current() == '`' )
+          first = read_escaped();
+
+        std::string rest;
+
+        for( skip_blanks(); ! at_end() && current() != ';'; skip_blanks() )
+          rest += input_[ offset_++ ];
+
+        expect_end_of_statement();
+
+        // errors on operands are reported at the beginning of the value
+        const auto end = offset_;
+
+        offset_ = begin;
+
+        // without escaping, the first binary meta character splits operands
+        if( first.empty() )
+        {
+          const auto split = rest.find_first_of( ".|", 1 );
+
+          first = rest.substr( 0, split );
+          rest = split == std::string::npos ? "" : rest.substr( split );
+
+          if( rest.empty() && first.size() > 1 &&
+              is_unary_closure( first.back() ) )
+          {
+            rest = first.substr( first.size() - 1 );
+            first.pop_back();
+          }
+        }
+
+        if( first.empty() )
+          fail( "Group " + name + " needs an operand" );
+
+        if( rest.empty() )
+          add_unary_group( name, group_unary_closures::one_one, first );
+        else if( rest.size() == 1 && is_unary_closure( rest[ 0 ] ) )
+          add_unary_group( name, unary_closure_of( rest[ 0 ] ), first );
+        else if( rest.size() > 1 && ( rest[ 0 ] == '.' || rest[ 0 ] == '|' ) )
+          add_binary_group
+            ( name, binary_closure_of( rest[ 0 ] ),
+              find_group( first ), find_group( rest.substr( 1 ) ) );
+        else
+          fail( "Invalid closure in group " + name );
+
+        offset_ = end;
+      }
+
+      /**
+       * \brief Reads a BINARY_CLOSURE_ON macro, operands being combined
+       * pairwise, level after level, an odd operand being carried to the
+       * next level
+       */
+      void parse_binary_closure_macro()
+      {
+        skip_blanks();
+
+        if( current() != '.' && current() != '|' )
+          fail( "Expected a binary closure" );
+
+        const auto closure = binary_closure_of( input_[ offset_++ ] );
+        const auto name = read_operand();
+
+        std::vector< std::size_t > operands;
+
+        for( auto operand = read_operand();
+             ! operand.empty();
+             operand = read_operand() )
+          operands.push_back( find_group( operand ) );
+
+        expect_end_of_statement();
+
+        if( name.empty() || operands.size() < 2 )
+          fail( "A binary closure needs a name and at least two groups" );
+
+        for( std::size_t level = 0; operands.size() > 1; ++level )
+        {
+          std::vector< std::size_t > combined;
+
+          for( std::size_t o = 0; o + 1 < operands.size(); o += 2 )
+          {
+            // blanks make intermediate names impossible to write
+            const auto is_last = operands.size() == 2;
+            const auto intermediate =
+              is_last ?
+                name :
+                name + ' ' + std::to_string( level ) + ' ' +
+                  std::to_string( o / 2 );
+
+            add_binary_group
+              ( intermediate, closure, operands[ o ], operands[ o + 1 ] );
+            combined.push_back( result_.groups.size() - 1 );
+          }
+
+          if( operands.size() % 2 != 0 )
+            combined.push_back( operands.back() );
+
+          operands = std::move( combined );
+        }
+      }
+
+      /**
+       * \brief Reads a group definition or a group macro
+       */
+      void parse_group_statement()
+      {
+        if( accept_macro( "SYMBOLS_AS_GROUPS" ) )
+        {
+          for( auto name = read_operand();
+               ! name.empty();
+               name = read_operand() )
+          {
+            if( symbols_.count( name ) == 0 )
+              fail( "Unknown symbol " + name );
+
+            add_unary_group( name, group_unary_closures::one_one, name );
+          }
+
+          expect_end_of_statement();
+
+          return;
+        }
+
+        if( accept_macro( "UNARY_CLOSURE_ON" ) )
+        {
+          skip_blanks();
+
+          if( ! is_unary_closure( current() ) )
+            fail( "Expected an unary closure" );
+
+          const auto closure = unary_closure_of( input_[ offset_++ ] );
+          const auto suffix = read_operand();
+
+          if( suffix.empty() )
+            fail( "Expected a suffix" );
+
+          for( auto name = read_operand();
+               ! name.empty();
+               name = read_operand() )
+            add_unary_group( name + suffix, closure, name );
+
+          expect_end_of_statement();
+
+          return;
+        }
+
+        if( accept_macro( "BINARY_CLOSURE_ON" ) )
+        {
+          parse_binary_closure_macro();
+
+          return;
+        }
+
+        const auto name = read_name();
+
+        expect_assignation();
+        parse_group_value( name );
+      }
+
+      /**
+       * \brief The definition to read
+       */
+      std::string_view input_;
+
+      /**
+       * \brief The current offset in the definition
+       */
+      std::size_t offset_;
+
+      /**
+       * \brief Indices of symbols by name
+       */
+      std::unordered_map< std::string, std::size_t > symbols_;
+
+      /**
+       * \brief Indices of groups by name
+       */
+      std::unordered_map< std::string, std::size_t > groups_;
+
+      /**
+       * \brief The definition being read
+       */
+      grammar_definition result_;
+    };
+  }
+
+  /**
+   * \brief Reads a regular grammar definition at run time. The syntax is the
+   * one of compile-time definitions, including documentation blocks and
+   * macros.
+   *
+   * \param definition the definition
+   *
+   * \return the definition value, whose last group is the root of the
+   * grammar
+   *
+   * \throw grammar_definition_error if the definition is invalid
+   */
+  inline grammar_definition parse_grammar_definition
+  ( std::string_view definition )
+  { return detail::grammar_definition_parser { definition }.parse(); }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_GRAMMAR_DEFINITION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the run-time reader of regular grammar definitions
+ */
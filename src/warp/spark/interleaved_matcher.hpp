@@ -0,0 +1,145 @@
+#ifndef _WARP_SPARK_INTERLEAVED_MATCHER_HPP_
+#define _WARP_SPARK_INTERLEAVED_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/total_automaton_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Recognizes batches of inputs, advancing several of them in
+   * lockstep through the same automaton. A single run is bound by the
+   * latency of table loads, each state depending on the previous one ;
+   * interleaving independent runs lets loads of distinct runs overlap. Runs
+   * are stepped together for as many letters as the shortest run has left,
+   * then finished runs are replaced by pending inputs. Group commands are
+   * not reported, use transcribe for that matter.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam STREAM_COUNT the number of runs advanced in lockstep, usually
+   * between 4 and 16
+   */
+  template< class GRAMMAR, std::size_t STREAM_COUNT = 8 >
+    struct interleaved_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      static_assert( STREAM_COUNT > 0,
+                     "Invalid stream count. At least one stream is needed." );
+
+    private :
+      /**
+       * \brief The compact table type of the grammar
+       */
+      using table_type_ =
+        typename detail::recognition_grammar< GRAMMAR >::table_type;
+
+    public :
+      /**
+       * \brief Exposes the number of runs advanced in lockstep
+       */
+      static constexpr std::size_t stream_count = STREAM_COUNT;
+
+      /**
+       * \brief The type of the total table of the grammar
+       */
+      using total_type =
+        detail::total_automaton_table
+          < table_type_::state_count, table_type_::class_count >;
+
+      /**
+       * \brief The total table of the grammar, whose runs never check for a
+       * rejection
+       */
+      static constexpr total_type table =
+        detail::build_total_automaton_table< total_type >
+          ( detail::recognition_grammar< GRAMMAR >::table );
+
+      /**
+       * \brief Recognizes a batch of inputs
+       *
+       * \param inputs the inputs to recognize
+       * \param count the number of inputs
+       * \param results receives, for each input, true if the whole input is
+       * recognized by the grammar, false otherwise
+       */
+      static constexpr void recognize
+      ( const std::string_view *inputs, std::size_t count, bool *results )
+      {
+        std::array< const char *, STREAM_COUNT > positions {};
+        std::array< std::size_t, STREAM_COUNT > remainings {};
+        std::array< std::size_t, STREAM_COUNT > states {};
+        std::array< std::size_t, STREAM_COUNT > owners {};
+        std::size_t active = 0;
+        std::size_t next = 0;
+
+        for( ;; )
+        {
+          // finishing runs, then filling free streams, active ones first
+          for( std::size_t s = 0; s < active; )
+            if( remainings[ s ] == 0 )
+            {
+              results[ owners[ s ] ] = table.final_states[ states[ s ] ];
+
+              --active;
+              positions[ s ] = positions[ active ];
+              remainings[ s ] = remainings[ active ];
+              states[ s ] = states[ active ];
+              owners[ s ] = owners[ active ];
+            }
+            else
+              ++s;
+
+          for( ; active < STREAM_COUNT && next < count; ++next )
+          {
+            positions[ active ] = inputs[ next ].data();
+            remainings[ active ] = inputs[ next ].size();
+            states[ active ] = table.initial_state;
+            owners[ active ] = next;
+
+            if( remainings[ active ] != 0 )
+              ++active;
+            else
+              results[ next ] = table.final_states[ table.initial_state ];
+          }
+
+          if( active == 0 )
+            return;
+
+          auto steps = remainings[ 0 ];
+
+          for( std::size_t s = 1; s < active; ++s )
+            steps = remainings[ s ] < steps ? remainings[ s ] : steps;
+
+          for( std::size_t l = 0; l < steps; ++l )
+            for( std::size_t s = 0; s < active; ++s )
+              states[ s ] =
+                table.target
+                  ( states[ s ],
+                    static_cast< unsigned char >( positions[ s ][ l ] ) );
+
+          for( std::size_t s = 0; s < active; ++s )
+          {
+            positions[ s ] += steps;
+            remainings[ s ] -= steps;
+          }
+        }
+      }
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_INTERLEAVED_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the interleaved recognizer of spark, advancing several
+ * inputs in lockstep
+ */
@@ -0,0 +1,103 @@
+#ifndef _WARP_SPARK_KEYWORD_MATCHER_HPP_
+#define _WARP_SPARK_KEYWORD_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/keyword_automaton.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Finds keywords in inputs, for grammars that are alternations of
+   * literals, such as keyword lists or blacklists. Such grammars are detected
+   * at compile time and compiled into an Aho-Corasick automaton stored as a
+   * compact double array instead of the generic deterministic automaton.
+   * Keywords are numbered in the order of their groups.
+   *
+   * \tparam GRAMMAR the root group of the grammar, an alternation of
+   * literals
+   */
+  template< class GRAMMAR >
+    struct keyword_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+    private :
+      /**
+       * \brief The keyword form of the grammar
+       */
+      using grammar_ = detail::keyword_grammar< GRAMMAR >;
+
+      static_assert( grammar_::is_keyword_grammar,
+                     "Invalid grammar used. Only alternations of literals "
+                     "are allowed." );
+
+    public :
+      /**
+       * \brief The number of keywords
+       */
+      static constexpr std::size_t keyword_count = grammar_::keywords.count;
+
+      /**
+       * \brief The number of cells of the double array
+       */
+      static constexpr std::size_t cell_count = grammar_::automaton.size;
+
+      /**
+       * \brief Reports all keyword occurrences of an input, overlapping ones
+       * included, in the order of their end
+       *
+       * \tparam FUNCTION a callable type, taking the keyword index, the
+       * offset of its first letter and the offset after its last letter
+       *
+       * \param input the input to scan
+       * \param function the function called for each occurrence
+       */
+      template< class FUNCTION >
+        static constexpr void for_each_match
+        ( std::string_view input, FUNCTION &&function )
+        {
+          detail::scan_keywords
+            ( grammar_::automaton, input,
+              [ & ]( std::size_t keyword, std::size_t begin, std::size_t end )
+              {
+                function( keyword, begin, end );
+
+                return true;
+              } );
+        }
+
+      /**
+       * \brief Indicates if an input contains a keyword, stopping at the
+       * first occurrence
+       *
+       * \param input the input to scan
+       *
+       * \return true if a keyword occurs in the input
+       */
+      static constexpr bool contains( std::string_view input )
+      {
+        bool result = false;
+
+        detail::scan_keywords
+          ( grammar_::automaton, input,
+            [ & ]( std::size_t, std::size_t, std::size_t )
+            { return ! ( result = true ); } );
+
+        return result;
+      }
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_KEYWORD_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the keyword matcher of spark, an Aho-Corasick automaton
+ * used for grammars made of alternations of literals
+ */
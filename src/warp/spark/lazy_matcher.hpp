@@ -0,0 +1,412 @@
+#ifndef _WARP_SPARK_LAZY_MATCHER_HPP_
+#define _WARP_SPARK_LAZY_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "transcription.hpp"
+#include "detail/automaton_g_command_types.hpp"
+#include "detail/epsilon_elimination.hpp"
+#include "detail/transcription_engine.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::spark
+{
+  /**
+   * \brief Counters reported by a lazy matcher, giving a way to watch the
+   * efficiency of its state cache
+   */
+  struct lazy_cache_statistics
+  {
+    /**
+     * \brief The number of transitions found in the cache
+     */
+    std::size_t hits;
+
+    /**
+     * \brief The number of transitions computed on demand
+     */
+    std::size_t misses;
+
+    /**
+     * \brief The number of times the cache has been flushed
+     */
+    std::size_t flushes;
+
+    /**
+     * \brief Computes the ratio of transitions found in the cache
+     *
+     * \return the hit ratio, between 0 and 1
+     */
+    constexpr double hit_ratio() const
+    {
+      return hits + misses == 0 ?
+        0.0 :
+        static_cast< double >( hits ) / static_cast< double >( hits + misses );
+    }
+  };
+
+  /**
+   * \brief Transcribes inputs using a grammar whose deterministic automaton is
+   * too large to be built at compile time. Only the epsilon free automaton of
+   * the grammar is built at compile time, thus, building a state on demand
+   * only follows letter edges, without computing any closure ; deterministic
+   * states are built while reading inputs, and kept in a bounded cache shared
+   * by all transcriptions of this matcher. When the cache is full, it is
+   * flushed and filled again from the current state. Thus, the memory used by
+   * the matcher is fixed, and typical inputs run almost as fast as with a
+   * deterministic table. Commands are reported exactly as transcribe does.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam CACHE_CAPACITY the maximum number of cached deterministic states,
+   * at least 2
+   */
+  template< class GRAMMAR, std::size_t CACHE_CAPACITY = 64 >
+    class lazy_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      static_assert( CACHE_CAPACITY >= 2,
+                     "Invalid cache capacity. A lazy matcher needs at least "
+                     "two cached states." );
+
+      /**
+       * \brief The epsilon free form of the grammar
+       */
+      using grammar_ = detail::epsilon_free_grammar< GRAMMAR >;
+
+      /**
+       * \brief The number of letter classes
+       */
+      static constexpr std::size_t class_count_ =
+        grammar_::classes.class_count;
+
+      /**
+       * \brief The number of groups
+       */
+      static constexpr std::size_t group_count_ = grammar_::nfa.group_count;
+
+      /**
+       * \brief Type of a set of non deterministic states
+       */
+      using kernel_type = typename grammar_::nfa_type::state_set_type;
+
+      /**
+       * \brief Type of a set of commands
+       */
+      using command_set_type = typename grammar_::nfa_type::command_set_type;
+
+      /**
+       * \brief Marks a transition leading nowhere
+       */
+      static constexpr std::size_t dead_ = CACHE_CAPACITY;
+
+      /**
+       * \brief Marks a transition not computed yet
+       */
+      static constexpr std::size_t unknown_ = CACHE_CAPACITY + 1;
+
+    public :
+      /**
+       * \brief Exposes the cache capacity
+       */
+      static constexpr std::size_t cache_capacity = CACHE_CAPACITY;
+
+      /**
+       * \brief Builds a matcher with an empty cache
+       */
+      lazy_matcher() { flush(); }
+
+      /**
+       * \brief Transcribes an input, firing group commands on a transducer
+       *
+       * \tparam ITERATOR a forward iterator type on letters
+       * \tparam TRANSDUCER the transducer type
+       *
+       * \param first the beginning of the input
+       * \param last the end of the input
+       * \param transducer the transducer receiving group commands
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      template< class ITERATOR, class TRANSDUCER >
+        bool transcribe( ITERATOR first, ITERATOR last, TRANSDUCER &transducer )
+        {
+          static_assert( std::is_base_of
+                           <
+                             std::forward_iterator_tag,
+                             typename std::iterator_traits< ITERATOR >::
+                               iterator_category
+                           >::value,
+                         "Invalid type used. Only forward iterator types are "
+                         "allowed." );
+
+          std::size_t state = initial_state();
+
+          for( ; first != last; ++first )
+          {
+            const std::size_t klass =
+              grammar_::classes.class_of
+                [ static_cast< unsigned char >( *first ) ];
+            const auto cell = state * class_count_ + klass;
+
+            if( targets_[ cell ] != unknown_ )
+              ++statistics_.hits;
+            else
+            {
+              ++statistics_.misses;
+              state = compute_transition( state, klass );
+            }
+
+            const auto target = targets_[ state * class_count_ + klass ];
+
+            if( target == dead_ )
+              return false;
+
+            fire( actions_[ state * class_count_ + klass ], transducer, first );
+
+            state = target;
+          }
+
+          if( ! final_states_[ state ] )
+            return false;
+
+          fire( final_actions_[ state ], transducer, last );
+
+          return true;
+        }
+
+      /**
+       * \brief Transcribes a string
+       *
+       * \tparam TRANSDUCER the transducer type
+       *
+       * \param input the string to transcribe
+       * \param transducer the transducer receiving group commands
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      template< class TRANSDUCER >
+        bool transcribe( std::string_view input, TRANSDUCER &transducer )
+        { return transcribe( input.begin(), input.end(), transducer ); }
+
+      /**
+       * \brief Recognizes a string, ignoring group commands
+       *
+       * \param input the string to recognize
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      bool recognize( std::string_view input )
+      {
+        recognizing_transducer transducer;
+
+        return transcribe( input, transducer );
+      }
+
+      /**
+       * \brief Gives counters of the cache
+       *
+       * \return cache statistics since the construction of the matcher
+       */
+      const lazy_cache_statistics &statistics() const { return statistics_; }
+
+      /**
+       * \brief Gives the number of cached deterministic states
+       *
+       * \return the number of states in the cache
+       */
+      std::size_t cached_state_count() const { return state_count_; }
+
+    private :
+      /**
+       * \brief Empties the cache
+       */
+      void flush()
+      {
+        state_count_ = 0;
+        targets_.fill( unknown_ );
+      }
+
+      /**
+       * \brief Gives the cached initial state, adding it if needed
+       *
+       * \return the index of the initial state in the cache
+       */
+      std::size_t initial_state()
+      {
+        kernel_type kernel;
+
+        kernel.insert( grammar_::nfa.start );
+
+        return find_or_add( kernel );
+      }
+
+      /**
+       * \brief Looks for a kernel in the cache, adding it if needed. The
+       * cache is flushed if it is full.
+       *
+       * \param kernel the kernel of the state
+       *
+       * \return the index of the state in the cache
+       */
+      std::size_t find_or_add( const kernel_type &kernel )
+      {
+        for( std::size_t s = 0; s < state_count_; ++s )
+          if( kernels_[ s ] == kernel )
+            return s;
+
+        if( state_count_ == CACHE_CAPACITY )
+        {
+          flush();
+          ++statistics_.flushes;
+        }
+
+        command_set_type final_action;
+
+        kernels_[ state_count_ ] = kernel;
+        final_states_[ state_count_ ] =
+          grammar_::nfa.finish( kernel, final_action );
+        final_actions_[ state_count_ ] = final_action;
+
+        return state_count_++;
+      }
+
+      /**
+       * \brief Computes a transition and caches it. The source state is moved
+       * if the cache is flushed meanwhile.
+       *
+       * \param state the source state
+       * \param klass the letter class read in the source state
+       *
+       * \return the index of the source state, possibly moved
+       */
+      std::size_t compute_transition( std::size_t state, std::size_t klass )
+      {
+        kernel_type kernel;
+        command_set_type action;
+
+        grammar_::nfa.step
+          ( kernels_[ state ], grammar_::classes.letters_of( klass ),
+            kernel, action );
+
+        std::size_t target = dead_;
+
+        if( ! kernel.empty() )
+        {
+          const auto source = kernels_[ state ];
+          const auto flushes = statistics_.flushes;
+
+          target = find_or_add( kernel );
+
+          if( flushes != statistics_.flushes )
+            state = find_or_add( source );
+        }
+
+        targets_[ state * class_count_ + klass ] = target;
+        actions_[ state * class_count_ + klass ] = action;
+
+        return state;
+      }
+
+      /**
+       * \brief Fires commands of a command set on a transducer
+       *
+       * \tparam TRANSDUCER the transducer type
+       * \tparam ITERATOR the iterator type given to callbacks
+       *
+       * \param action the command set
+       * \param transducer the transducer receiving commands
+       * \param position the iterator given to callbacks
+       */
+      template< class TRANSDUCER, class ITERATOR >
+        static void fire
+        (
+          const command_set_type &action,
+          TRANSDUCER &transducer, const ITERATOR &position
+        )
+        {
+          using detail::group_command_types;
+          using detail::has_transducer_callback;
+
+          if( action.empty() )
+            return;
+
+          detail::for_each_ordered_command
+            ( action, group_count_,
+              [ & ]( const detail::command_entry &command )
+              {
+                if constexpr( has_transducer_callback
+                                < group_command_types::capturing,
+                                  TRANSDUCER, ITERATOR >::value )
+                  if( command.type == group_command_types::capturing )
+                    transducer.capturing( command.group, position );
+
+                if constexpr( has_transducer_callback
+                                < group_command_types::finishing,
+                                  TRANSDUCER, ITERATOR >::value )
+                  if( command.type == group_command_types::finishing )
+                    transducer.finishing( command.group, position );
+
+                if constexpr( has_transducer_callback
+                                < group_command_types::resetting,
+                                  TRANSDUCER, ITERATOR >::value )
+                  if( command.type == group_command_types::resetting )
+                    transducer.resetting( command.group, position );
+              } );
+        }
+
+      /**
+       * \brief The number of cached states
+       */
+      std::size_t state_count_ = 0;
+
+      /**
+       * \brief Cache counters
+       */
+      lazy_cache_statistics statistics_ {};
+
+      /**
+       * \brief Kernel of each cached state
+       */
+      std::array< kernel_type, CACHE_CAPACITY > kernels_ {};
+
+      /**
+       * \brief Indicates, for each cached state, if it is final
+       */
+      std::array< bool, CACHE_CAPACITY > final_states_ {};
+
+      /**
+       * \brief Commands applied when the input ends in a cached state
+       */
+      std::array< command_set_type, CACHE_CAPACITY > final_actions_ {};
+
+      /**
+       * \brief Target of each cached transition
+       */
+      std::array< std::size_t, CACHE_CAPACITY * class_count_ > targets_ {};
+
+      /**
+       * \brief Commands of each cached transition
+       */
+      std::array< command_set_type, CACHE_CAPACITY * class_count_ >
+        actions_ {};
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_LAZY_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the lazy matcher of spark, building deterministic states on
+ * demand within a bounded cache
+ */
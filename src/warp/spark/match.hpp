@@ -0,0 +1,136 @@
+#ifndef _WARP_SPARK_MATCH_HPP_
+#define _WARP_SPARK_MATCH_HPP_
+
+#include "group_traits.hpp"
+#include "search.hpp"
+#include "detail/automaton_state_enumeration.hpp"
+#include "detail/compiled_grammar.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Enumerates ways a grammar may match an input
+   */
+  enum class match_modes
+  {
+    /**
+     * \brief The whole input must be recognized
+     */
+    full,
+
+    /**
+     * \brief The longest prefix of the input recognized by the grammar
+     */
+    anchored_longest,
+
+    /**
+     * \brief The shortest prefix of the input recognized by the grammar
+     */
+    anchored_shortest,
+
+    /**
+     * \brief The leftmost part of the input recognized by the grammar, as
+     * found by search
+     */
+    unanchored
+  };
+
+  /**
+   * \brief Matches an input using a compact automaton table, in an anchored
+   * or full mode. Runs stop as soon as their outcome is known : reaching a
+   * dead state rejects at once, reaching an always final state accepts the
+   * rest of the input without reading it, and the shortest prefix is found as
+   * soon as a final state is reached. Tables compiled at compile time, at run
+   * time or emitted by warp-sparkc are all matched here.
+   *
+   * \tparam MODE the match mode, anything but unanchored
+   * \tparam TABLE a compact automaton table type
+   *
+   * \param table the table of the grammar, used for recognition
+   * \param input the input to match
+   *
+   * \return the matched part of the input, if any, always beginning at the
+   * first letter
+   */
+  template< match_modes MODE, class TABLE >
+    constexpr search_result match_table
+    ( const TABLE &table, std::string_view input )
+    {
+      static_assert( MODE != match_modes::unanchored,
+                     "Invalid match mode used. Only anchored and full modes "
+                     "are allowed." );
+
+      using detail::state_types;
+
+      const auto size = input.size();
+
+      search_result result { false, size, size };
+      std::size_t state = table.initial_state;
+
+      for( std::size_t o = 0; table.types[ state ] != state_types::dead; )
+      {
+        if( table.final_states[ state ] )
+        {
+          if( MODE == match_modes::anchored_shortest )
+            return search_result { true, 0, o };
+
+          if( table.types[ state ] == state_types::always_final )
+            return search_result { true, 0, size };
+
+          if( MODE == match_modes::anchored_longest || o == size )
+            result = search_result { true, 0, o };
+        }
+
+        if( o == size )
+          break;
+
+        state =
+          table.target( state, static_cast< unsigned char >( input[ o++ ] ) );
+
+        if( state == table.no_state )
+          break;
+      }
+
+      return result;
+    }
+
+  /**
+   * \brief Matches an input using a grammar, in a given mode, see
+   * match_table. The unanchored mode is handled by search
+   *
+   * \tparam MODE the match mode
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param input the input to match
+   *
+   * \return the matched part of the input, if any. Anchored and full matches
+   * always begin at the first letter
+   */
+  template< match_modes MODE, class GRAMMAR >
+    constexpr search_result match
+    ( const GRAMMAR &grammar, std::string_view input )
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      if constexpr( MODE == match_modes::unanchored )
+        return search( grammar, input );
+      else
+        return
+          match_table< MODE >
+            ( detail::recognition_grammar< GRAMMAR >::table, input );
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_MATCH_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the match algorithm of spark, supporting full, anchored and
+ * unanchored match modes
+ */
@@ -0,0 +1,307 @@
+#ifndef _WARP_SPARK_PARALLEL_MATCHER_HPP_
+#define _WARP_SPARK_PARALLEL_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace warp::spark
+{
+  /**
+   * \brief Default thread pool used by parallel algorithms of spark, based on
+   * std::thread. Any type exposing the same run member function may be used
+   * instead, to share threads with the rest of an application.
+   */
+  class thread_pool
+  {
+  public :
+    /**
+     * \brief Builds a pool using a number of threads
+     *
+     * \param thread_count the number of threads, the hardware concurrency by
+     * default
+     */
+    explicit thread_pool
+    ( std::size_t thread_count = std::thread::hardware_concurrency() ) :
+      thread_count_ { std::max( thread_count, std::size_t { 1 } ) } {}
+
+    /**
+     * \brief Gives the number of threads of the pool
+     *
+     * \return the number of threads
+     */
+    std::size_t thread_count() const { return thread_count_; }
+
+    /**
+     * \brief Runs tasks, each thread taking the next pending task until none
+     * is left, and waits for their completion. The calling thread works too.
+     * A task throwing stops the distribution of pending tasks, and its
+     * exception is rethrown once every thread is joined.
+     *
+     * \tparam FUNCTION a callable type taking a task index
+     *
+     * \param task_count the number of tasks
+     * \param function the function running a task
+     *
+     * \throw anything thrown by a task, the first one caught if several tasks
+     * throw, or std::system_error if a thread cannot be started
+     */
+    template< class FUNCTION >
+      void run( std::size_t task_count, FUNCTION function )
+      {
+        const auto used = std::min( thread_count_, task_count );
+
+        std::atomic< std::size_t > next { 0 };
+        std::vector< std::exception_ptr > errors( used );
+
+        const auto work = [ & ]( std::size_t worker )
+        {
+          try
+          {
+            for( auto task = next++; task < task_count; task = next++ )
+              function( task );
+          }
+          catch( ... )
+          {
+            errors[ worker ] = std::current_exception();
+            next = task_count;
+          }
+        };
+
+        // started threads are joined even if starting another one throws,
+        // destroying a joinable thread terminating the program
+        struct joiner
+        {
+          ~joiner()
+          {
+            for( auto &thread : threads )
+              thread.join();
+          }
+
+          std::vector< std::thread > threads;
+        };
+
+        {
+          joiner joined;
+
+          joined.threads.reserve( used );
+
+          for( std::size_t t = 1; t < used; ++t )
+            joined.threads.emplace_back( work, t );
+
+          work( 0 );
+        }
+
+        for( const auto &error : errors )
+          if( error )
+            std::rethrow_exception( error );
+      }
+
+  private :
+    /**
+     * \brief The number of threads
+     */
+    std::size_t thread_count_;
+  };
+
+  namespace detail
+  {
+    /**
+     * \brief Runs a compact table over a chunk of input from every state at
+     * once, the rejecting state included. Runs reaching a same state are
+     * merged regularly, thus, the cost quickly drops to the cost of a
+     * single run on real automata, whose runs synchronize fast.
+     *
+     * \tparam TABLE a compact automaton table type
+     *
+     * \param table the table
+     * \param first the beginning of the chunk
+     * \param last the end of the chunk
+     * \param map receives, for each state, the state reached at the end of
+     * the chunk, the state no_state being the rejecting state
+     */
+    template< class TABLE >
+      void enumerate_chunk
+      (
+        const TABLE &table, const char *first, const char *last,
+        std::array< std::size_t, TABLE::state_count + 1 > &map
+      )
+      {
+        constexpr std::size_t count = TABLE::state_count + 1;
+        constexpr std::size_t merge_period = 64;
+
+        // distinct runs and the run followed by each start state
+        std::array< std::size_t, count > runs {};
+        std::array< std::size_t, count > slots {};
+        std::size_t run_count = count;
+
+        for( std::size_t s = 0; s < count; ++s )
+          runs[ s ] = slots[ s ] = s;
+
+        while( first != last )
+        {
+          const auto block =
+            first +
+            std::min
+              ( merge_period, static_cast< std::size_t >( last - first ) );
+
+          for( ; first != block; ++first )
+            for( std::size_t r = 0; r < run_count; ++r )
+              if( runs[ r ] != TABLE::no_state )
+                runs[ r ] =
+                  table.target
+                    ( runs[ r ], static_cast< unsigned char >( *first ) );
+
+          // merging runs having reached a same state
+          std::array< std::size_t, count > merged {};
+          std::array< std::size_t, count > renumbered {};
+          std::size_t merged_count = 0;
+
+          merged.fill( count );
+
+          for( std::size_t r = 0; r < run_count; ++r )
+          {
+            const auto state = runs[ r ];
+
+            if( merged[ state ] == count )
+            {
+              merged[ state ] = merged_count;
+              runs[ merged_count++ ] = state;
+            }
+
+            renumbered[ r ] = merged[ state ];
+          }
+
+          for( std::size_t s = 0; s < count; ++s )
+            slots[ s ] = renumbered[ slots[ s ] ];
+
+          run_count = merged_count;
+
+          if( run_count == 1 && runs[ 0 ] == TABLE::no_state )
+            break;
+        }
+
+        for( std::size_t s = 0; s < count; ++s )
+          map[ s ] = runs[ slots[ s ] ];
+      }
+  }
+
+  /**
+   * \brief Recognizes a large input using several threads. The input is
+   * split into chunks, each chunk being run from every state of the
+   * automaton in parallel, giving a map from start states to end states.
+   * Maps are then composed sequentially, from the initial state, to find the
+   * state reached at the end of the input. Only recognition is supported :
+   * no command is reported.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam POOL a thread pool type, exposing a
+   * run( task_count, function ) member function calling function( task )
+   * for each task and waiting for their completion
+   *
+   * \param input the input to recognize
+   * \param pool the pool running chunks
+   * \param chunk_count the number of chunks, usually the number of threads
+   *
+   * \return true if the whole input is recognized by the grammar, false
+   * otherwise
+   */
+  template< class GRAMMAR, class POOL >
+    bool parallel_recognize
+    (
+      const GRAMMAR &, std::string_view input,
+      POOL &pool, std::size_t chunk_count
+    )
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      using grammar_type = detail::recognition_grammar< GRAMMAR >;
+      using table_type = typename grammar_type::table_type;
+      using map_type = std::array< std::size_t, table_type::state_count + 1 >;
+
+      constexpr const auto &table = grammar_type::table;
+
+      chunk_count =
+        std::max
+          ( std::size_t { 1 }, std::min( chunk_count, input.size() ) );
+
+      std::vector< map_type > maps( chunk_count );
+      const auto chunk_size = input.size() / chunk_count;
+
+      pool.run
+        ( chunk_count,
+          [ & ]( std::size_t chunk )
+          {
+            const auto first = input.data() + chunk * chunk_size;
+            const auto last =
+              chunk + 1 == chunk_count ?
+                input.data() + input.size() :
+                first + chunk_size;
+
+            // the first chunk is only run from the initial state
+            if( chunk != 0 )
+            {
+              detail::enumerate_chunk( table, first, last, maps[ chunk ] );
+
+              return;
+            }
+
+            auto state = table.initial_state;
+
+            for( auto current = first;
+                 current != last && state != table.no_state;
+                 ++current )
+              state =
+                table.target
+                  ( state, static_cast< unsigned char >( *current ) );
+
+            maps[ 0 ][ table.initial_state ] = state;
+          } );
+
+      auto state = table.initial_state;
+
+      for( const auto &map : maps )
+        state = map[ state ];
+
+      return state != table.no_state && table.final_states[ state ];
+    }
+
+  /**
+   * \brief Recognizes a large input using the default thread pool, with a
+   * chunk per hardware thread
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param grammar the grammar
+   * \param input the input to recognize
+   *
+   * \return true if the whole input is recognized by the grammar, false
+   * otherwise
+   */
+  template< class GRAMMAR >
+    bool parallel_recognize( const GRAMMAR &grammar, std::string_view input )
+    {
+      thread_pool pool;
+
+      return parallel_recognize( grammar, input, pool, pool.thread_count() );
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_PARALLEL_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the parallel recognizer of spark, splitting large inputs
+ * into chunks run on several threads
+ */
@@ -0,0 +1,263 @@
+#ifndef _WARP_SPARK_RUNTIME_GRAMMAR_HPP_
+#define _WARP_SPARK_RUNTIME_GRAMMAR_HPP_
+
+#include "grammar_arena.hpp"
+#include "grammar_definition.hpp"
+#include "match.hpp"
+#include "search.hpp"
+#include "detail/automaton_minimization.hpp"
+#include "detail/grammar_fingerprint.hpp"
+#include "detail/runtime_compiled_grammar.hpp"
+#include "detail/transcription_engine.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::spark
+{
+  /**
+   * \brief A regular grammar built at run time from a definition string,
+   * written in the syntax read by warp-sparkc. The definition is parsed and
+   * compiled once, at construction, intermediate automata being allocated
+   * from an arena, either dedicated to the grammar or shared by successive
+   * compilations, as when a rule set is reloaded. The compiled tables share
+   * the compact format of tables compiled at compile time, thus, both are
+   * run by the same match and transcription engines, and a grammar built at
+   * run time holds the very tables of the group types describing the same
+   * tree.
+   */
+  class runtime_grammar
+  {
+  public :
+    /**
+     * \brief Parses and compiles a definition, measuring the latency of the
+     * whole compilation. Intermediate automata are allocated from an arena
+     * dedicated to the grammar, released once the grammar is built
+     *
+     * \param definition the definition of the grammar
+     * \param state_budget the maximum number of deterministic states the
+     * subset construction is allowed to build
+     *
+     * \throw grammar_definition_error if the definition is invalid
+     * \throw std::length_error if the state budget is exceeded
+     */
+    explicit runtime_grammar
+    ( std::string_view definition, std::size_t state_budget = 128 )
+    {
+      grammar_arena arena;
+
+      compile( definition, state_budget, arena );
+    }
+
+    /**
+     * \brief Parses and compiles a definition, measuring the latency of the
+     * whole compilation. Intermediate automata are allocated from an arena
+     * reset first, thus, its blocks are reused by each compilation and it
+     * must only serve grammar compilations
+     *
+     * \param definition the definition of the grammar
+     * \param arena the memory resource of intermediate automata
+     * \param state_budget the maximum number of deterministic states the
+     * subset construction is allowed to build
+     *
+     * \throw grammar_definition_error if the definition is invalid
+     * \throw std::length_error if the state budget is exceeded
+     */
+    runtime_grammar
+    (
+      std::string_view definition, grammar_arena &arena,
+      std::size_t state_budget = 128
+    )
+    {
+      arena.reset();
+      compile( definition, state_budget, arena );
+    }
+
+    /**
+     * \brief Matches an input, see match_table
+     *
+     * \tparam MODE the match mode, anything but unanchored
+     *
+     * \param input the input to match
+     *
+     * \return the matched part of the input, if any, always beginning at the
+     * first letter
+     */
+    template< match_modes MODE >
+      search_result match( std::string_view input ) const
+      { return match_table< MODE >( recognition_table_, input ); }
+
+    /**
+     * \brief Indicates if the whole input is recognized by the grammar
+     *
+     * \param input the input to recognize
+     *
+     * \return true if the whole input is recognized, false otherwise
+     */
+    bool recognize( std::string_view input ) const
+    { return match< match_modes::full >( input ).is_found; }
+
+    /**
+     * \brief Transcribes an input range using the grammar, see transcribe.
+     * Groups are indexed in the pre-order of the group tree, the root having
+     * the index 0
+     *
+     * \tparam ITERATOR a forward iterator type on letters
+     * \tparam TRANSDUCER the transducer type
+     *
+     * \param first the beginning of the input
+     * \param last the end of the input
+     * \param transducer the transducer receiving group commands
+     *
+     * \return true if the whole input is recognized by the grammar, false
+     * otherwise
+     */
+    template< class ITERATOR, class TRANSDUCER >
+      bool transcribe
+      ( ITERATOR first, ITERATOR last, TRANSDUCER &transducer ) const
+      {
+        static_assert( std::is_base_of
+                         <
+                           std::forward_iterator_tag,
+                           typename std::iterator_traits< ITERATOR >::
+                             iterator_category
+                         >::value,
+                       "Invalid type used. Only forward iterator types are "
+                       "allowed." );
+
+        return detail::run_transcription( table_, first, last, transducer );
+      }
+
+    /**
+     * \brief Transcribes a string using the grammar
+     *
+     * \tparam TRANSDUCER the transducer type
+     *
+     * \param input the string to transcribe
+     * \param transducer the transducer receiving group commands
+     *
+     * \return true if the whole input is recognized by the grammar, false
+     * otherwise
+     */
+    template< class TRANSDUCER >
+      bool transcribe
+      ( std::string_view input, TRANSDUCER &transducer ) const
+      { return transcribe( input.begin(), input.end(), transducer ); }
+
+    /**
+     * \brief Gives the compact table reporting group commands
+     *
+     * \return the table used by transcription
+     */
+    const detail::runtime_compact_table &table() const { return table_; }
+
+    /**
+     * \brief Gives the compact table used for recognition only
+     *
+     * \return the table used by match
+     */
+    const detail::runtime_compact_table &recognition_table() const
+    { return recognition_table_; }
+
+    /**
+     * \brief Gives the fingerprint of the flattened group tree, the one of
+     * group types describing the same tree, see grammar_fingerprint
+     *
+     * \return the fingerprint of the grammar
+     */
+    std::uint64_t fingerprint() const { return fingerprint_; }
+
+    /**
+     * \brief Gives state and transition counts of the table reporting group
+     * commands, before and after minimization
+     *
+     * \return the statistics of the compilation
+     */
+    const detail::automaton_statistics &statistics() const
+    { return statistics_; }
+
+    /**
+     * \brief Gives the time spent parsing and compiling the definition
+     *
+     * \return the latency of the compilation
+     */
+    std::chrono::nanoseconds compile_latency() const
+    { return compile_latency_; }
+
+  private :
+    /**
+     * \brief Parses and compiles a definition, intermediate automata being
+     * allocated from an arena. Tables are allocated from the default
+     * resource, thus, they outlive the arena
+     *
+     * \param definition the definition of the grammar
+     * \param state_budget the maximum number of deterministic states
+     * \param arena the memory resource of intermediate automata
+     */
+    void compile
+    (
+      std::string_view definition, std::size_t state_budget,
+      grammar_arena &arena
+    )
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const auto parsed = parse_grammar_definition( definition );
+
+      auto compiled =
+        detail::compile_runtime_grammar
+          ( detail::runtime_thompson_grammar_from( parsed, &arena ),
+            state_budget, &arena );
+      auto recognition =
+        detail::compile_runtime_grammar
+          ( detail::simplified_runtime_thompson_grammar_from( parsed, &arena ),
+            state_budget, &arena );
+
+      table_ = std::move( compiled.table );
+      recognition_table_ = std::move( recognition.table );
+      statistics_ = compiled.statistics;
+      fingerprint_ =
+        detail::group_nodes_fingerprint
+          ( detail::runtime_group_dag_from( parsed, &arena ) );
+      compile_latency_ = std::chrono::steady_clock::now() - start;
+    }
+
+    /**
+     * \brief The table reporting group commands
+     */
+    detail::runtime_compact_table table_;
+
+    /**
+     * \brief The table used for recognition only
+     */
+    detail::runtime_compact_table recognition_table_;
+
+    /**
+     * \brief The fingerprint of the grammar
+     */
+    std::uint64_t fingerprint_ = 0;
+
+    /**
+     * \brief Statistics of the compilation
+     */
+    detail::automaton_statistics statistics_ {};
+
+    /**
+     * \brief The time spent parsing and compiling the definition
+     */
+    std::chrono::nanoseconds compile_latency_ {};
+  };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_RUNTIME_GRAMMAR_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains regular grammars built at run time from a definition
+ * string, sharing tables and engines with grammars built at compile time
+ */
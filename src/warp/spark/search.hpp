@@ -0,0 +1,181 @@
+#ifndef _WARP_SPARK_SEARCH_HPP_
+#define _WARP_SPARK_SEARCH_HPP_
+
+#include "group_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/keyword_automaton.hpp"
+#include "detail/literal_analysis.hpp"
+#include "detail/literal_scanner.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief The part of a buffer matched by a search
+   */
+  struct search_result
+  {
+    /**
+     * \brief Indicates if a match has been found
+     */
+    bool is_found;
+
+    /**
+     * \brief The offset of the first matched letter
+     */
+    std::size_t begin;
+
+    /**
+     * \brief The offset after the last matched letter
+     */
+    std::size_t end;
+  };
+
+  /**
+   * \brief Looks for the first match of a grammar in a buffer : the one
+   * ending first, beginning as far left as possible. Literals required by
+   * the grammar are extracted at compile time and used to skip the buffer at
+   * memory speed : a buffer not containing the required factor is rejected
+   * at once, and the buffer part preceding the first occurrence of the
+   * required prefix is skipped. The rest is read once by an unanchored
+   * automaton, stopping where the first match ends, then read backward by
+   * the reversed automaton of the grammar, from that end only, to find where
+   * the match begins. Thus, the search runs in linear time. Grammars made of
+   * alternations of literals are searched using their Aho-Corasick automaton
+   * instead.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   *
+   * \param input the buffer to search in
+   *
+   * \return the leftmost match, if any
+   */
+  template< class GRAMMAR >
+    search_result search( const GRAMMAR &, std::string_view input )
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      if constexpr( detail::keyword_grammar< GRAMMAR >::is_keyword_grammar )
+      {
+        constexpr const auto &automaton =
+          detail::keyword_grammar< GRAMMAR >::automaton;
+
+        search_result result { false, input.size(), input.size() };
+        std::size_t state = automaton.root;
+
+        for( std::size_t o = 0; o < input.size() && ! result.is_found; ++o )
+        {
+          const auto letter = static_cast< unsigned char >( input[ o ] );
+
+          state = automaton.step( state, letter );
+
+          // the longest keyword ending here begins as far left as possible
+          for( auto output = automaton.first_output( state );
+               output != automaton.no_state;
+               output = automaton.next_outputs[ output ] )
+          {
+            const auto length =
+              automaton.lengths[ automaton.outputs[ output ] - 1 ];
+
+            if( ! result.is_found || o + 1 - length < result.begin )
+              result = search_result { true, o + 1 - length, o + 1 };
+          }
+        }
+
+        return result;
+      }
+      else
+      {
+        constexpr const auto &forward =
+          detail::unanchored_recognition_grammar< GRAMMAR >::table;
+        constexpr const auto &backward =
+          detail::reversed_recognition_grammar< GRAMMAR >::table;
+        constexpr const auto &literals =
+          detail::required_literals_of< GRAMMAR >::value;
+
+        const char *const first = input.data();
+        const char *const last = first + input.size();
+
+        if( literals.factor.size != 0 &&
+            detail::find_literal
+              ( first, last,
+                literals.factor.letters.data(),
+                literals.factor.size ) == last )
+          return search_result { false, input.size(), input.size() };
+
+        // no match begins before the first occurrence of the prefix
+        const char *start = first;
+
+        if constexpr( literals.prefix.size != 0 )
+        {
+          start =
+            detail::find_literal
+              ( first, last,
+                literals.prefix.letters.data(), literals.prefix.size );
+
+          if( start == last )
+            return search_result { false, input.size(), input.size() };
+        }
+
+        // finding where the first match ends
+        auto state = forward.initial_state;
+        const char *end = forward.final_states[ state ] ? start : nullptr;
+
+        for( auto current = start; end == nullptr && current != last; )
+        {
+          state =
+            forward.target( state, static_cast< unsigned char >( *current ) );
+
+          if( state == forward.no_state ||
+              forward.types[ state ] == detail::state_types::dead )
+            break;
+
+          ++current;
+
+          if( forward.final_states[ state ] )
+            end = current;
+        }
+
+        if( end != nullptr )
+        {
+          // finding where it begins, the leftmost begin being the last one
+          // met reading backward
+          state = backward.initial_state;
+          const char *begin = backward.final_states[ state ] ? end : nullptr;
+
+          for( auto current = end; current != start; )
+          {
+            --current;
+            state =
+              backward.target
+                ( state, static_cast< unsigned char >( *current ) );
+
+            if( state == backward.no_state ||
+                backward.types[ state ] == detail::state_types::dead )
+              break;
+
+            if( backward.final_states[ state ] )
+              begin = current;
+          }
+
+          return search_result
+            { true, std::size_t( begin - first ), std::size_t( end - first ) };
+        }
+
+        return search_result { false, input.size(), input.size() };
+      }
+    }
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_SEARCH_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the search algorithm of spark, looking for parts of a
+ * buffer recognized by a grammar
+ */
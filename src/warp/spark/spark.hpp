@@ -4,6 +4,32 @@
 #include "regular_grammar.hpp"
 #include "regular_grammar_traits.hpp"
 #include "regular_grammar_type_system.hpp"
+#include "detail/automaton.hpp"
+#include "detail/automaton_state.hpp"
+#include "detail/automaton_t_function.hpp"
+#include "detail/automaton_g_command.hpp"
+#include "detail/automaton_minimization.hpp"
+#include "detail/compact_automaton_table.hpp"
+#include "detail/epsilon_elimination.hpp"
+#include "transcription.hpp"
+#include "stream_matcher.hpp"
+#include "capture_spans.hpp"
+#include "lazy_matcher.hpp"
+#include "bit_parallel_matcher.hpp"
+#include "search.hpp"
+#include "union_matcher.hpp"
+#include "keyword_matcher.hpp"
+#include "parallel_matcher.hpp"
+#include "file_matcher.hpp"
+#include "stride_matcher.hpp"
+#include "interleaved_matcher.hpp"
+#include "match.hpp"
+#include "tokenizer.hpp"
+#include "grammar_artifacts.hpp"
+#include "grammar_definition.hpp"
+#include "detail/runtime_compiled_grammar.hpp"
+#include "grammar_arena.hpp"
+#include "runtime_grammar.hpp"
 
 /**
  * \brief This namespace contains all stuff that is related to formal language
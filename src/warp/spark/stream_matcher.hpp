@@ -0,0 +1,243 @@
+#ifndef _WARP_SPARK_STREAM_MATCHER_HPP_
+#define _WARP_SPARK_STREAM_MATCHER_HPP_
+
+#include "capture_spans.hpp"
+#include "group_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/transcription_engine.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief The whole state of a stream matcher. It is a plain old data type,
+   * thus, it can be copied, stored or sent along with the stream it belongs
+   * to, and used later to resume the matching. It holds no capture : group
+   * spans still pending at a chunk boundary, begun but not finished yet,
+   * belong to the capture spans or the transducer fed along with the
+   * matcher. Capture spans hold their pending parses by value, in arrays
+   * sized by the grammar, thus, to resume a capture, copy them along with
+   * the stream state.
+   */
+  struct stream_state
+  {
+    /**
+     * \brief The current state of the automaton
+     */
+    std::size_t state;
+
+    /**
+     * \brief The number of letters already fed, that is, the offset of the
+     * next letter in the stream
+     */
+    std::size_t offset;
+
+    /**
+     * \brief Indicates if the stream has already been rejected
+     */
+    bool is_rejected;
+  };
+
+  /**
+   * \brief Resumable matcher, recognizing a stream split into chunks at
+   * arbitrary boundaries. Chunks are read in place, a letter at a time, and
+   * are never copied nor read twice ; the matcher only keeps a stream state.
+   * Transducers given to feed and finish receive group commands as with
+   * transcribe, but positions are offsets in the whole stream rather than
+   * iterators. Capture spans given instead receive the leftmost greedy parse
+   * of the stream, as with capture. Pending captures are kept by the spans
+   * or the transducer, never by the matcher, see stream_state.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   */
+  template< class GRAMMAR >
+    class stream_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      /**
+       * \brief The compact table of the grammar
+       */
+      static constexpr const auto &table_ =
+        detail::compiled_grammar< GRAMMAR >::table;
+
+      /**
+       * \brief A transducer ignoring all commands
+       */
+      struct ignoring_transducer {};
+
+    public :
+      /**
+       * \brief Builds a matcher at the beginning of a stream
+       */
+      constexpr stream_matcher() : state_ { table_.initial_state, 0, false }
+      {}
+
+      /**
+       * \brief Builds a matcher resuming a stream
+       *
+       * \param state a state previously obtained from a matcher of the same
+       * grammar
+       */
+      constexpr explicit stream_matcher( const stream_state &state ) :
+        state_ { state } {}
+
+      /**
+       * \brief Feeds the next chunk of the stream
+       *
+       * \tparam TRANSDUCER the transducer type
+       *
+       * \param chunk the next letters of the stream
+       * \param transducer the transducer receiving group commands
+       *
+       * \return false if the stream is rejected, true if it may still be
+       * recognized
+       */
+      template< class TRANSDUCER >
+        constexpr bool feed( std::string_view chunk, TRANSDUCER &transducer )
+        {
+          if( state_.is_rejected )
+            return false;
+
+          for( const auto letter : chunk )
+          {
+            const std::size_t klass =
+              table_.classes[ static_cast< unsigned char >( letter ) ];
+            const auto action = table_.class_action( state_.state, klass );
+
+            state_.state = table_.class_target( state_.state, klass );
+
+            if( state_.state == table_.no_state )
+            {
+              state_.is_rejected = true;
+
+              return false;
+            }
+
+            if( action != table_.no_action )
+              detail::apply_transducer_action
+                ( table_, action, transducer, state_.offset );
+
+            ++state_.offset;
+          }
+
+          return true;
+        }
+
+      /**
+       * \brief Feeds the next chunk of the stream, ignoring group commands
+       *
+       * \param chunk the next letters of the stream
+       *
+       * \return false if the stream is rejected, true if it may still be
+       * recognized
+       */
+      constexpr bool feed( std::string_view chunk )
+      {
+        ignoring_transducer transducer;
+
+        return feed( chunk, transducer );
+      }
+
+      /**
+       * \brief Feeds the next chunk of the stream, advancing pending parses
+       * of capture spans
+       *
+       * \param chunk the next letters of the stream
+       * \param spans the capture spans of the stream, reset by the caller at
+       * the beginning of the stream
+       *
+       * \return false if the stream is rejected, true if it may still be
+       * recognized
+       */
+      constexpr bool feed
+      ( std::string_view chunk, capture_spans< GRAMMAR > &spans )
+      {
+        for( std::size_t i = 0; i < chunk.size(); ++i )
+        {
+          if( ! feed( chunk.substr( i, 1 ) ) )
+            return false;
+
+          spans.step( chunk[ i ], state_.offset - 1 );
+        }
+
+        return ! state_.is_rejected;
+      }
+
+      /**
+       * \brief Ends the stream
+       *
+       * \tparam TRANSDUCER the transducer type
+       *
+       * \param transducer the transducer receiving final group commands
+       *
+       * \return true if the whole stream is recognized, false otherwise
+       */
+      template< class TRANSDUCER >
+        constexpr bool finish( TRANSDUCER &transducer ) const
+        {
+          if( state_.is_rejected || ! table_.final_states[ state_.state ] )
+            return false;
+
+          detail::apply_transducer_action
+            ( table_, table_.final_actions[ state_.state ],
+              transducer, state_.offset );
+
+          return true;
+        }
+
+      /**
+       * \brief Ends the stream, recording spans of its leftmost greedy parse
+       *
+       * \param spans the capture spans of the stream
+       *
+       * \return true if the whole stream is recognized, false otherwise
+       */
+      constexpr bool finish( capture_spans< GRAMMAR > &spans ) const
+      { return spans.finish() && finish(); }
+
+      /**
+       * \brief Ends the stream, ignoring group commands
+       *
+       * \return true if the whole stream is recognized, false otherwise
+       */
+      constexpr bool finish() const
+      {
+        ignoring_transducer transducer;
+
+        return finish( transducer );
+      }
+
+      /**
+       * \brief Restarts the matcher at the beginning of a new stream
+       */
+      constexpr void reset()
+      { state_ = stream_state { table_.initial_state, 0, false }; }
+
+      /**
+       * \brief Gives the state of the matcher, to resume the stream later
+       *
+       * \return the current stream state
+       */
+      constexpr const stream_state &state() const { return state_; }
+
+    private :
+      /**
+       * \brief The state of the stream
+       */
+      stream_state state_;
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_STREAM_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the resumable stream matcher of spark, working on chunked
+ * inputs
+ */
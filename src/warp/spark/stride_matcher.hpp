@@ -0,0 +1,129 @@
+#ifndef _WARP_SPARK_STRIDE_MATCHER_HPP_
+#define _WARP_SPARK_STRIDE_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/stride_table.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::spark
+{
+  /**
+   * \brief Recognizer reading two letters per table lookup, halving the
+   * number of dependent lookups of a run. The stride table grows with the
+   * square of the number of letter classes, thus, it is only built if it
+   * fits in a size budget ; otherwise, the matcher silently reads a letter
+   * per lookup using the compact table. Group commands are not reported, use
+   * transcribe for that matter.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam TABLE_BUDGET the maximum size, in bytes, of the stride table
+   */
+  template< class GRAMMAR, std::size_t TABLE_BUDGET = 64 * 1024 >
+    struct stride_matcher
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+    private :
+      /**
+       * \brief The compiled grammar
+       */
+      using grammar_ = detail::recognition_grammar< GRAMMAR >;
+
+      /**
+       * \brief The compact table type
+       */
+      using table_type_ = typename grammar_::table_type;
+
+    public :
+      /**
+       * \brief The size, in bytes, of the stride table of the grammar
+       */
+      static constexpr std::size_t table_size =
+        detail::stride_table_size< table_type_ >();
+
+      /**
+       * \brief Indicates if the stride table fits in the budget and is used
+       */
+      static constexpr bool is_multi_stride = table_size <= TABLE_BUDGET;
+
+      /**
+       * \brief The type of the stride table, an empty one if it does not fit
+       * in the budget
+       */
+      using stride_type =
+        std::conditional_t
+        <
+          is_multi_stride,
+          detail::stride_table
+            < table_type_::state_count, table_type_::class_count >,
+          detail::stride_table< 0, 1 >
+        >;
+
+      /**
+       * \brief The stride table
+       */
+      static constexpr stride_type stride =
+        [] {
+          if constexpr( is_multi_stride )
+            return detail::build_stride_table< stride_type >
+                     ( grammar_::table );
+          else
+            return stride_type {};
+        }();
+
+      /**
+       * \brief Recognizes a string
+       *
+       * \param input the string to recognize
+       *
+       * \return true if the whole input is recognized by the grammar, false
+       * otherwise
+       */
+      static constexpr bool recognize( std::string_view input )
+      {
+        constexpr const auto &table = grammar_::table;
+
+        std::size_t state = table.initial_state;
+        std::size_t o = 0;
+
+        if constexpr( is_multi_stride )
+          for( ; o + 1 < input.size(); o += 2 )
+          {
+            state =
+              stride.target
+                ( state,
+                  static_cast< unsigned char >( input[ o ] ),
+                  static_cast< unsigned char >( input[ o + 1 ] ) );
+
+            if( state == stride_type::no_state )
+              return false;
+          }
+
+        for( ; o < input.size(); ++o )
+        {
+          state =
+            table.target( state, static_cast< unsigned char >( input[ o ] ) );
+
+          if( state == table.no_state )
+            return false;
+        }
+
+        return table.final_states[ state ];
+      }
+    };
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_STRIDE_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the multi-stride recognizer of spark, reading two letters
+ * per table lookup
+ */
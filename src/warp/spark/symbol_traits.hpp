@@ -101,7 +101,7 @@ namespace warp::spark
        * signature. Ensuring the validity of NAME and LETTER_SEQUENCE
        */
       static constexpr bool is_symbol =
-        name_traits< NAME >::is_valid &&
+        name_traits< NAME >::is_name &&
         symbol_letter_sequence_traits< LETTER_SEQUENCE >::
           is_valid_exclusive_letter_sequence;
 
@@ -143,9 +143,10 @@ namespace warp::spark
       static constexpr bool is_symbol = name_traits< NAME >::is_name;
 
       /**
-       * \brief This symbol is an any one
+       * \brief This symbol is an any one, if the symbol is valid
        */
-      static constexpr auto symbol_type = symbol_types::exclusive;
+      static constexpr auto symbol_type =
+        is_symbol ? symbol_types::any : static_cast< symbol_types >( -1 );
 
       /**
        * \brief The name of this symbol type
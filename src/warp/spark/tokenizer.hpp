@@ -0,0 +1,210 @@
+#ifndef _WARP_SPARK_TOKENIZER_HPP_
+#define _WARP_SPARK_TOKENIZER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/automaton_state_enumeration.hpp"
+#include "detail/token_grammar.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace warp::spark
+{
+  /**
+   * \brief A token found by a tokenizer
+   */
+  struct token
+  {
+    /**
+     * \brief The kind of the token, that is, the index of the alternative of
+     * the grammar recognizing it
+     */
+    std::size_t kind;
+
+    /**
+     * \brief The offset of the first letter of the token
+     */
+    std::size_t begin;
+
+    /**
+     * \brief The offset after the last letter of the token
+     */
+    std::size_t end;
+  };
+
+  /**
+   * \brief Splits inputs into tokens, using a grammar whose top level
+   * alternations list token kinds. Each token is the longest part of the
+   * input recognized by a kind (maximal munch), the first kind in group order
+   * winning when several kinds recognize the same part. Kinds are united at
+   * compile time into a single deterministic automaton resolving priorities
+   * in its final states, thus, each token is found in a single run. A run
+   * only reads letters beyond its token while they may still lead to a
+   * longer one, at most lookback of them plus the letter ending the run.
+   * When the lookback is unbounded, runs remember pairs of state and offset
+   * leading to no token, a bit per state and letter of the input, so that
+   * the input is still split in linear time. Empty tokens are never
+   * produced.
+   *
+   * \tparam GRAMMAR the root group of the grammar, an alternation of token
+   * kinds
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   */
+  template< class GRAMMAR, std::size_t STATE_BUDGET >
+    struct basic_tokenizer
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+    private :
+      /**
+       * \brief Token kinds compiled at compile time
+       */
+      using grammar_ = detail::token_grammar< GRAMMAR, STATE_BUDGET >;
+
+    public :
+      /**
+       * \brief The number of token kinds
+       */
+      static constexpr std::size_t kind_count = grammar_::kind_count;
+
+      /**
+       * \brief The number of states of the automaton
+       */
+      static constexpr std::size_t state_count =
+        grammar_::table_type::state_count;
+
+      /**
+       * \brief The maximum number of letters read beyond the end of a token,
+       * besides the letter ending the run, unbounded_lookback if some kinds
+       * allow arbitrarily long detours
+       */
+      static constexpr std::size_t lookback = grammar_::lookback;
+
+    private :
+      /**
+       * \brief The memory of failing runs, needed with an unbounded lookback
+       * only
+       */
+      using failures_type =
+        std::conditional_t
+        <
+          lookback == detail::unbounded_lookback,
+          detail::token_failure_table,
+          detail::no_token_failures
+        >;
+
+    public :
+      /**
+       * \brief Reports tokens of an input, in order, until the input ends or
+       * no token can be recognized
+       *
+       * \tparam FUNCTION a callable type taking a token
+       *
+       * \param input the input to split
+       * \param function the function called for each token
+       *
+       * \return the offset where tokenization stopped, the size of the input
+       * if it has been entirely split
+       *
+       * \throw std::bad_alloc if the lookback is unbounded and the memory of
+       * failing runs cannot be allocated
+       */
+      template< class FUNCTION >
+        static constexpr std::size_t for_each_token
+        ( std::string_view input, FUNCTION &&function )
+        {
+          constexpr const auto &table = grammar_::table;
+
+          const auto size = input.size();
+
+          failures_type failures { state_count, size };
+
+          for( std::size_t begin = 0; begin != size; )
+          {
+            auto state = table.initial_state;
+            auto result = token { grammar_::no_kind, begin, begin };
+
+            for( auto o = begin; o != size; )
+            {
+              state =
+                table.target
+                  ( state, static_cast< unsigned char >( input[ o++ ] ) );
+
+              if( state == table.no_state ||
+                  table.types[ state ] == detail::state_types::dead ||
+                  failures.is_failing( state, o ) )
+                break;
+
+              failures.visit( state, o );
+
+              if( grammar_::kinds[ state ] != grammar_::no_kind )
+              {
+                failures.accept();
+                result.kind = grammar_::kinds[ state ];
+                result.end = o;
+
+                // the token swallows the rest of the input anyway
+                if( table.types[ state ] ==
+                      detail::state_types::always_final )
+                {
+                  result.end = size;
+
+                  break;
+                }
+              }
+            }
+
+            failures.fail();
+
+            if( result.kind == grammar_::no_kind )
+              return begin;
+
+            function( result );
+            begin = result.end;
+          }
+
+          return size;
+        }
+
+      /**
+       * \brief Splits an input into tokens
+       *
+       * \param input the input to split
+       *
+       * \return tokens of the input, stopping at the first part not
+       * recognized by any kind
+       */
+      static std::vector< token > tokenize( std::string_view input )
+      {
+        std::vector< token > result;
+
+        for_each_token
+          ( input, [ & ]( const token &t ) { result.push_back( t ); } );
+
+        return result;
+      }
+    };
+
+  /**
+   * \brief Splits inputs into tokens, within the default state budget
+   *
+   * \tparam GRAMMAR the root group of the grammar, an alternation of token
+   * kinds
+   */
+  template< class GRAMMAR >
+    using tokenizer = basic_tokenizer< GRAMMAR, 128 >;
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_TOKENIZER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the tokenizer of spark, splitting inputs into longest
+ * tokens whose kinds are listed by a grammar
+ */
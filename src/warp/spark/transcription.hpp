@@ -0,0 +1,193 @@
+#ifndef _WARP_SPARK_TRANSCRIPTION_HPP_
+#define _WARP_SPARK_TRANSCRIPTION_HPP_
+
+#include "group_traits.hpp"
+#include "../sequences/sequence_traits.hpp"
+#include "detail/compiled_grammar.hpp"
+#include "detail/transcription_engine.hpp"
+
+#include <array>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace warp::spark
+{
+  /**
+   * \brief Transcribes an input using a grammar. The grammar is compiled once
+   * into a compact automaton table at compile time, then the input is read a
+   * letter at a time, each transition notifying the transducer with group
+   * commands. The transducer may expose any of the following callbacks, each
+   * receiving the index of the group and an iterator :
+   * - resetting( group, it ), it designating where the group begins
+   * - capturing( group, it ), it designating the captured letter
+   * - finishing( group, it ), it designating the end of the group
+   * Groups are indexed in the pre-order of the group tree, the root having the
+   * index 0. Use detail::group_index_of to get the index of a named group.
+   * A transition stands for all parses of the input read so far, thus, its
+   * commands are those of every parse, including parses failing later on.
+   * Reported commands are a superset of the commands of the accepted parse
+   * and may describe overlapping groups ; use capture to get the spans of
+   * the leftmost greedy parse only.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam ITERATOR a forward iterator type on letters
+   * \tparam TRANSDUCER the transducer type
+   *
+   * \param first the beginning of the input
+   * \param last the end of the input
+   * \param transducer the transducer receiving group commands
+   *
+   * \return true if the whole input is recognized by the grammar, false
+   * otherwise
+   */
+  template< class GRAMMAR, class ITERATOR, class TRANSDUCER >
+    bool transcribe
+    ( const GRAMMAR &, ITERATOR first, ITERATOR last, TRANSDUCER &transducer )
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      static_assert( std::is_base_of
+                       <
+                         std::forward_iterator_tag,
+                         typename std::iterator_traits< ITERATOR >::
+                           iterator_category
+                       >::value,
+                     "Invalid type used. Only forward iterator types are "
+                     "allowed." );
+
+      return detail::run_transcription
+        ( detail::compiled_grammar< GRAMMAR >::table,
+          first, last, transducer );
+    }
+
+  /**
+   * \brief Transcribes a string using a grammar
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam TRANSDUCER the transducer type
+   *
+   * \param grammar the grammar
+   * \param input the string to transcribe
+   * \param transducer the transducer receiving group commands
+   *
+   * \return true if the whole input is recognized by the grammar, false
+   * otherwise
+   */
+  template< class GRAMMAR, class TRANSDUCER >
+    bool transcribe
+    (
+      const GRAMMAR &grammar, std::string_view input,
+      TRANSDUCER &transducer
+    )
+    { return transcribe( grammar, input.begin(), input.end(), transducer ); }
+
+  /**
+   * \brief A transducer ignoring all group commands, used when only the
+   * recognition of an input matters
+   */
+  struct recognizing_transducer {};
+
+  /**
+   * \brief Compile-time transcription of an input using a grammar. This non
+   * specialized version is used with anything that is not an integral
+   * sequence and is not defined.
+   */
+  template
+    <
+      class GRAMMAR, class INPUT,
+      class TRANSDUCER = recognizing_transducer
+    >
+    struct compile_time_transcription;
+
+  /**
+   * \brief Compile-time transcription of an integral sequence. Letters of the
+   * sequence are stored in a constexpr array, then the compact table of the
+   * grammar is run on this array as a constexpr loop, a letter at a time.
+   * Thus, the cost of the compilation grows linearly with the size of the
+   * input, without any type recursion. The transducer must be a literal type
+   * whose callbacks are constexpr. Callbacks receive pointers inside the
+   * letter array.
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam S an integral sequence template
+   * \tparam T the type of letters
+   * \tparam VS letters of the input
+   * \tparam TRANSDUCER a default constructible literal transducer type
+   */
+  template
+    <
+      class GRAMMAR,
+      template< class U, U... > class S, class T, T... VS,
+      class TRANSDUCER
+    >
+    struct compile_time_transcription< GRAMMAR, S< T, VS... >, TRANSDUCER >
+    {
+      static_assert( group_traits< GRAMMAR >::is_group,
+                     "Invalid type used. Only group types are allowed." );
+
+      static_assert( meta_sequence_traits
+                       < S< T, VS... > >::is_integral_sequence,
+                     "Invalid type used. Only integral sequence types are "
+                     "allowed." );
+
+      /**
+       * \brief Letters of the input
+       */
+      static constexpr std::array< T, sizeof...( VS ) > letters { { VS... } };
+
+    private :
+      /**
+       * \brief The outcome of the transcription, computed once
+       */
+      static constexpr auto outcome_ =
+        detail::run_transcription_outcome< TRANSDUCER >
+          ( detail::compiled_grammar< GRAMMAR >::table,
+            letters.data(), letters.data() + letters.size() );
+
+    public :
+      /**
+       * \brief Indicates if the input is recognized by the grammar
+       */
+      static constexpr bool is_recognized = outcome_.is_recognized;
+
+      /**
+       * \brief The transducer, after it received all group commands
+       */
+      static constexpr TRANSDUCER transducer = outcome_.transducer;
+
+      /**
+       * \brief The result as a type, a boolean constant indicating if the
+       * input is recognized
+       */
+      using type = std::integral_constant< bool, is_recognized >;
+    };
+
+  /**
+   * \brief Convenient alias to get the result type of a compile-time
+   * transcription
+   *
+   * \tparam GRAMMAR the root group of the grammar
+   * \tparam INPUT an integral sequence
+   * \tparam TRANSDUCER a default constructible literal transducer type
+   */
+  template
+    <
+      class GRAMMAR, class INPUT,
+      class TRANSDUCER = recognizing_transducer
+    >
+    using compile_time_transcription_t =
+      typename compile_time_transcription
+        < GRAMMAR, INPUT, TRANSDUCER >::type;
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_TRANSCRIPTION_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains run-time and compile-time transcription algorithms of
+ * spark
+ */
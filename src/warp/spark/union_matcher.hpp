@@ -0,0 +1,158 @@
+#ifndef _WARP_SPARK_UNION_MATCHER_HPP_
+#define _WARP_SPARK_UNION_MATCHER_HPP_
+
+#include "group_traits.hpp"
+#include "detail/bit_set.hpp"
+#include "detail/union_grammar.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace warp::spark
+{
+  /**
+   * \brief Grammars matched by an union matcher in an input, and where
+   *
+   * \tparam GRAMMAR_COUNT the number of united grammars
+   */
+  template< std::size_t GRAMMAR_COUNT >
+    struct union_match
+    {
+      /**
+       * \brief The set of grammars having matched a part of the input, a bit
+       * per grammar, in the order grammars are united
+       */
+      detail::bit_set< GRAMMAR_COUNT > matched;
+
+      /**
+       * \brief For each matched grammar, the offset after the last letter of
+       * its first match, that is, the earliest match end
+       */
+      std::array< std::size_t, GRAMMAR_COUNT > ends;
+    };
+
+  /**
+   * \brief Looks for several grammars at once in an input. Grammars are
+   * united at compile time into a single deterministic automaton, thus, an
+   * input is read exactly once and the cost per letter does not depend on
+   * the number of grammars : only reaching a state where some grammar matches
+   * costs a little more, the first time a grammar matches. The united
+   * automaton may be much bigger than automata of each grammar, hence the
+   * state budget.
+   *
+   * \tparam STATE_BUDGET the maximum number of deterministic states the
+   * subset construction is allowed to build
+   * \tparam GRAMMARS root groups of united grammars
+   */
+  template< std::size_t STATE_BUDGET, class... GRAMMARS >
+    struct basic_union_matcher
+    {
+      static_assert( sizeof...( GRAMMARS ) > 0,
+                     "Invalid type used. At least one grammar is needed." );
+
+      static_assert( ( group_traits< GRAMMARS >::is_group && ... ),
+                     "Invalid type used. Only group types are allowed." );
+
+    private :
+      /**
+       * \brief The union compiled at compile time
+       */
+      using union_ = detail::union_grammar< STATE_BUDGET, GRAMMARS... >;
+
+    public :
+      /**
+       * \brief The number of united grammars
+       */
+      static constexpr std::size_t grammar_count = union_::grammar_count;
+
+      /**
+       * \brief The type of a match result
+       */
+      using result_type = union_match< grammar_count >;
+
+      /**
+       * \brief The number of states of the united automaton
+       */
+      static constexpr std::size_t state_count =
+        union_::table_type::state_count;
+
+      /**
+       * \brief Finds grammars matching a part of an input
+       *
+       * \param input the input to read
+       *
+       * \return matched grammars and where their first match ends
+       */
+      static constexpr result_type match( std::string_view input )
+      {
+        constexpr const auto &table = union_::table;
+
+        result_type result {};
+        std::size_t remaining = grammar_count;
+        std::size_t state = table.initial_state;
+
+        report( state, 0, result, remaining );
+
+        for( std::size_t o = 0; o < input.size() && remaining != 0; ++o )
+        {
+          state =
+            table.target( state, static_cast< unsigned char >( input[ o ] ) );
+
+          if( table.final_states[ state ] )
+            report( state, o + 1, result, remaining );
+        }
+
+        return result;
+      }
+
+    private :
+      /**
+       * \brief Records grammars matching in a state, if not already matched
+       *
+       * \param state the current state
+       * \param offset the current offset in the input
+       * \param result the result to update
+       * \param remaining the number of grammars not matched yet
+       */
+      static constexpr void report
+      (
+        std::size_t state, std::size_t offset,
+        result_type &result, std::size_t &remaining
+      )
+      {
+        const auto &accepted =
+          union_::accepted[ union_::table.final_actions[ state ] ];
+
+        if( result.matched.includes( accepted ) )
+          return;
+
+        for( std::size_t g = 0; g < grammar_count; ++g )
+          if( accepted.contains( g ) && ! result.matched.contains( g ) )
+          {
+            result.matched.insert( g );
+            result.ends[ g ] = offset;
+            --remaining;
+          }
+      }
+    };
+
+  /**
+   * \brief Looks for several grammars at once in an input, within the default
+   * state budget
+   *
+   * \tparam GRAMMARS root groups of united grammars
+   */
+  template< class... GRAMMARS >
+    using union_matcher = basic_union_matcher< 128, GRAMMARS... >;
+} // namespace warp::spark
+
+#endif // _WARP_SPARK_UNION_MATCHER_HPP_
+
+// doxygen
+/**
+ * \file
+ *
+ * \brief Contains the union matcher of spark, finding matches of several
+ * grammars in a single pass
+ */